@@ -44,4 +44,5 @@ file(REMOVE_RECURSE ${SHADERS_OUTPUT_DIR})
 file(MAKE_DIRECTORY ${SHADERS_OUTPUT_DIR})
 
 compile_shaders(*.vert)
-compile_shaders(*.frag)
\ No newline at end of file
+compile_shaders(*.frag)
+compile_shaders(*.comp)
\ No newline at end of file
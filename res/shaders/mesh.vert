@@ -1,5 +1,7 @@
 #version 450
 
+// Mesh vertex shader for meshes without vertex colors (MeshVertexFormat::Packed)
+
 // DescriptorSet 0: Per-frame
 // DescriptorSet 1: Per-mesh
 
@@ -9,17 +11,17 @@ layout(set = 0, binding = 0) uniform UniformBufferData {
     mat4 projection;
 } uniformBufferData;
 
-// Per-mesh model matrix
-layout(push_constant) uniform PushConstantData {
-    mat4 model;
-} pushConstantData;
-
-// Vertex attributes
+// Vertex attributes (packed, see PackedMeshVertex)
+// The position is normalized to the mesh's AABB, the model matrix includes its dequantization
 layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 color;
 layout(location = 2) in vec2 textureCoordinate;
 layout(location = 3) in uint textureIndex;
 
+// Instance attributes (per-instance model matrix, occupies locations 4-7)
+layout(location = 4) in mat4 model;
+// First texture table entry of the mesh (0 without bindless textures, see mesh_bindless.frag)
+layout(location = 8) in uint textureTableOffset;
+
 // Vertex data to forward to fragment shader
 layout(location = 0) out VertexData {
     vec3 color;
@@ -28,10 +30,10 @@ layout(location = 0) out VertexData {
 } vertexData;
 
 void main() {
-    gl_Position = uniformBufferData.projection * uniformBufferData.view * pushConstantData.model * vec4(position, 1.0);
+    gl_Position = uniformBufferData.projection * uniformBufferData.view * model * vec4(position, 1.0);
 
     // Forward data to fragment shader
-    vertexData.color = color;
+    vertexData.color = vec3(1.0);
     vertexData.textureCoordinate = textureCoordinate;
-    vertexData.textureIndex = textureIndex;
-}
\ No newline at end of file
+    vertexData.textureIndex = textureTableOffset + textureIndex;
+}
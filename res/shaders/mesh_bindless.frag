@@ -0,0 +1,31 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Mesh fragment shader for bindless textures (see MeshManager)
+
+// DescriptorSet 0: Per-frame
+// DescriptorSet 1: Shared by all meshes
+
+// Every texture used by a mesh, partially bound
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+// Maps the texture table offset of a mesh plus the texture index of a vertex to the texture array
+layout(std430, set = 1, binding = 1) readonly buffer TextureTable {
+    uint textureIndices[];
+};
+
+// Vertex data forwarded from vertex shader
+layout(location = 0) in VertexData {
+    vec3 color;
+    vec2 textureCoordinate;
+    uint textureIndex; // Texture table offset plus texture index
+} vertexData;
+
+// Final fragment color
+layout(location = 0) out vec4 fragmentColor;
+
+void main() {
+    // The texture index varies within a draw, which may use several textures of the mesh
+    uint textureIndex = textureIndices[vertexData.textureIndex];
+    fragmentColor = texture(textures[nonuniformEXT(textureIndex)], vertexData.textureCoordinate) * vec4(vertexData.color, 1.0);
+}
@@ -0,0 +1,40 @@
+#version 450
+
+// Mesh vertex shader for meshes with vertex colors (MeshVertexFormat::PackedColor)
+
+// DescriptorSet 0: Per-frame
+// DescriptorSet 1: Per-mesh
+
+// Per-frame view and projection matrices
+layout(set = 0, binding = 0) uniform UniformBufferData {
+    mat4 view;
+    mat4 projection;
+} uniformBufferData;
+
+// Vertex attributes (packed, see PackedMeshVertex)
+// The position is normalized to the mesh's AABB, the model matrix includes its dequantization
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec2 textureCoordinate;
+layout(location = 3) in uint textureIndex;
+
+// Instance attributes (per-instance model matrix, occupies locations 4-7)
+layout(location = 4) in mat4 model;
+// First texture table entry of the mesh (0 without bindless textures, see mesh_bindless.frag)
+layout(location = 8) in uint textureTableOffset;
+
+// Vertex data to forward to fragment shader
+layout(location = 0) out VertexData {
+    vec3 color;
+    vec2 textureCoordinate;
+    uint textureIndex;
+} vertexData;
+
+void main() {
+    gl_Position = uniformBufferData.projection * uniformBufferData.view * model * vec4(position, 1.0);
+
+    // Forward data to fragment shader
+    vertexData.color = color;
+    vertexData.textureCoordinate = textureCoordinate;
+    vertexData.textureIndex = textureTableOffset + textureIndex;
+}
@@ -3,6 +3,8 @@
 #include "system/Error.h"
 #include "window/KeyEvent.h"
 
+#include <iomanip>
+
 namespace Blink {
     App::App(const AppConfig& config) : config(config) {
         try {
@@ -42,13 +44,15 @@ namespace Blink {
         renderer->waitUntilIdle();
     }
 
-    void App::gameLoop() const {
+    void App::gameLoop() {
         constexpr double oneSecond = 1.0;
         double lastTime = window->getTime();
         double statisticsUpdateLag = 0.0;
         uint32_t ups = 0;
         uint32_t fps = 0;
         while (running) {
+            // Waits for the GPU before the input is sampled when frames are paced for low latency
+            renderer->waitForNextFrame();
             double time = window->update();
             double timestep = std::min(time - lastTime, oneSecond);
             lastTime = time;
@@ -56,16 +60,52 @@ namespace Blink {
                 scene->update(timestep);
                 ups++;
             }
-            if (renderer->beginFrame()) {
+            if (renderer->beginFrame(time)) {
                 scene->render();
                 renderer->endFrame();
                 fps++;
             }
+            // Switch scenes between frames, once the files of the requested scene have been preloaded
+            // Preloads are updated every frame since scripts can preload files without requesting a scene
+            bool preloaded = isScenePreloaded();
+            if (!pendingScenePath.empty() && preloaded) {
+                std::string scenePath = pendingScenePath;
+                pendingScenePath.clear();
+                setScene(scenePath);
+            }
 #ifdef BL_DEBUG
             statisticsUpdateLag += timestep;
             if (statisticsUpdateLag >= oneSecond) {
                 std::stringstream ss;
+                const RendererStatistics& rendererStatistics = renderer->getStatistics();
+                const SceneStatistics& sceneStatistics = scene->getStatistics();
                 ss << "FPS: " << fps << ", UPS: " << ups;
+                ss << ", Draws: " << rendererStatistics.drawCalls << ", Skipped binds: " << rendererStatistics.skippedBinds;
+                ss << ", Visible: " << sceneStatistics.visibleMeshes << ", Culled: " << sceneStatistics.culledMeshes;
+                ss << ", LOD triangles:";
+                for (uint32_t lodTriangles : rendererStatistics.lodTriangles) {
+                    ss << " " << lodTriangles;
+                }
+                ss << ", Recording (ms):";
+                for (double recordingTime : rendererStatistics.recordingTimes) {
+                    ss << " " << std::fixed << std::setprecision(2) << recordingTime;
+                }
+                // Latency to present needs present wait, latency to the frame fence is measured on every device
+                if (rendererStatistics.inputToPresentLatency > 0.0) {
+                    ss << ", Input to present (ms): " << std::fixed << std::setprecision(2) << rendererStatistics.inputToPresentLatency;
+                } else {
+                    ss << ", Input to frame fence (ms): " << std::fixed << std::setprecision(2) << rendererStatistics.inputToFrameFenceLatency;
+                }
+                const FramePacing& framePacing = renderer->getFramePacing();
+                ss << " (frames in flight: " << framePacing.framesInFlight;
+                ss << ", " << VulkanSwapChain::getPresentModeName(renderer->getPresentMode());
+                ss << ", additional images: " << framePacing.additionalImageCount << ")";
+                if (!rendererStatistics.gpuPassTimes.empty()) {
+                    ss << ", GPU (ms):";
+                    for (const GpuPassTime& gpuPassTime : rendererStatistics.gpuPassTimes) {
+                        ss << " " << gpuPassTime.name << " " << std::fixed << std::setprecision(2) << gpuPassTime.milliseconds;
+                    }
+                }
                 std::string title = ss.str();
                 window->setTitle(title.c_str());
                 ups = 0;
@@ -95,7 +135,7 @@ namespace Blink {
             if (key >= f1Key) {
                 int32_t sceneIndex = key - f1Key;
                 if (sceneIndex > -1 && sceneIndex < config.scenes.size()) {
-                    setScene(config.scenes[sceneIndex]);
+                    requestScene(config.scenes[sceneIndex]);
                     return;
                 }
             }
@@ -104,6 +144,36 @@ namespace Blink {
         scene->onEvent(event);
     }
 
+    //
+    // Switching scenes keeps rendering the current scene while the files of the requested scene are loaded on the
+    // worker threads, and only switches once its meshes, textures and skybox are resident, instead of blocking until
+    // the whole scene has been loaded.
+    //
+    // The files used by a scene are only known after its Lua script has run. The scene itself is still created on the
+    // main thread when switching, since its scripts are bound on the Lua state shared with the current scene, but its
+    // script is first run in a separate Lua state that only records the files it uses (see
+    // LuaEngine::readSceneAssets). Scenes that have been loaded before are preloaded from the files they used then.
+    // Scripts can also preload files themselves (see AssetLuaBinding), e.g. for the scene they expect to be switched
+    // to next.
+    //
+    void App::requestScene(const std::string& scenePath) {
+        BL_LOG_INFO("Requesting scene [{}]", scenePath);
+        pendingScenePath = scenePath;
+        auto iterator = sceneAssets.find(scenePath);
+        if (iterator == sceneAssets.end()) {
+            SceneAssets assets{};
+            if (!luaEngine->readSceneAssets(scenePath, &assets)) {
+                return;
+            }
+            iterator = sceneAssets.emplace(scenePath, assets).first;
+        }
+        scene->preload(iterator->second);
+    }
+
+    bool App::isScenePreloaded() const {
+        return meshManager->updatePreloads() && skyboxManager->isPreloaded();
+    }
+
     void App::setScene(const std::string& scenePath) {
         BL_LOG_INFO("Setting scene [{}]", scenePath);
 
@@ -120,13 +190,20 @@ namespace Blink {
         sceneConfig.renderer = renderer;
         sceneConfig.luaEngine = luaEngine;
         sceneConfig.sceneCamera = sceneCamera;
+        sceneConfig.lodBias = config.lodBias;
 
         BL_EXECUTE_THROW(scene = new Scene(sceneConfig));
+        sceneAssets[scenePath] = scene->getAssets();
+
+        vulkanDevice->getMemoryAllocator()->logStatistics();
     }
 
     void App::initialize() {
         BL_EXECUTE_THROW(fileSystem = new FileSystem());
 
+        ThreadPoolConfig threadPoolConfig{};
+        BL_EXECUTE_THROW(threadPool = new ThreadPool(threadPoolConfig));
+
         WindowConfig windowConfig{};
         windowConfig.title = config.name;
         windowConfig.width = config.windowWidth;
@@ -163,19 +240,45 @@ namespace Blink {
         deviceConfig.physicalDevice = vulkanPhysicalDevice;
         BL_EXECUTE_THROW(vulkanDevice = new VulkanDevice(deviceConfig));
 
+        VulkanUploadContextConfig uploadContextConfig{};
+        uploadContextConfig.device = vulkanDevice;
+        BL_EXECUTE_THROW(vulkanUploadContext = new VulkanUploadContext(uploadContextConfig));
+
+        VulkanPipelineCacheConfig pipelineCacheConfig{};
+        pipelineCacheConfig.fileSystem = fileSystem;
+        pipelineCacheConfig.device = vulkanDevice;
+        BL_EXECUTE_THROW(vulkanPipelineCache = new VulkanPipelineCache(pipelineCacheConfig));
+
         ShaderManagerConfig shaderManagerConfig{};
         shaderManagerConfig.fileSystem = fileSystem;
         shaderManagerConfig.device = vulkanDevice;
         BL_EXECUTE_THROW(shaderManager = new ShaderManager(shaderManagerConfig));
 
+        TextureCompressionConfig textureCompressionConfig{};
+        textureCompressionConfig.fileSystem = fileSystem;
+        textureCompressionConfig.physicalDevice = vulkanPhysicalDevice;
+        BL_EXECUTE_THROW(textureCompression = new TextureCompression(textureCompressionConfig));
+
+        TextureLoaderConfig textureLoaderConfig{};
+        textureLoaderConfig.fileSystem = fileSystem;
+        textureLoaderConfig.textureCompression = textureCompression;
+        BL_EXECUTE_THROW(textureLoader = new TextureLoader(textureLoaderConfig));
+
         MeshManagerConfig meshManagerConfig{};
         meshManagerConfig.fileSystem = fileSystem;
         meshManagerConfig.device = vulkanDevice;
+        meshManagerConfig.uploadContext = vulkanUploadContext;
+        meshManagerConfig.threadPool = threadPool;
+        meshManagerConfig.textureLoader = textureLoader;
+        meshManagerConfig.bindlessTexturesEnabled = config.bindlessTexturesEnabled;
         BL_EXECUTE_THROW(meshManager = new MeshManager(meshManagerConfig));
 
         SkyboxManagerConfig skyboxManagerConfig{};
         skyboxManagerConfig.fileSystem = fileSystem;
+        skyboxManagerConfig.threadPool = threadPool;
         skyboxManagerConfig.device = vulkanDevice;
+        skyboxManagerConfig.uploadContext = vulkanUploadContext;
+        skyboxManagerConfig.textureLoader = textureLoader;
         BL_EXECUTE_THROW(skyboxManager = new SkyboxManager(skyboxManagerConfig));
 
         RendererConfig rendererConfig{};
@@ -183,9 +286,13 @@ namespace Blink {
         rendererConfig.window = window;
         rendererConfig.vulkanApp = vulkanApp;
         rendererConfig.device = vulkanDevice;
+        rendererConfig.uploadContext = vulkanUploadContext;
+        rendererConfig.pipelineCache = vulkanPipelineCache;
         rendererConfig.meshManager = meshManager;
         rendererConfig.shaderManager = shaderManager;
         rendererConfig.skyboxManager = skyboxManager;
+        rendererConfig.threadPool = threadPool;
+        rendererConfig.framePacing = config.framePacing;
         BL_EXECUTE_THROW(renderer = new Renderer(rendererConfig));
 
         SceneCameraConfig cameraConfig{};
@@ -196,6 +303,7 @@ namespace Blink {
 
         LuaEngineConfig luaEngineConfig{};
         luaEngineConfig.keyboard = keyboard;
+        luaEngineConfig.renderer = renderer;
         luaEngineConfig.sceneCamera = sceneCamera;
         luaEngineConfig.window = window;
         BL_EXECUTE_THROW(luaEngine = new LuaEngine(luaEngineConfig));
@@ -211,13 +319,18 @@ namespace Blink {
         delete renderer;
         delete skyboxManager;
         delete meshManager;
+        delete textureLoader;
+        delete textureCompression;
         delete shaderManager;
+        delete vulkanPipelineCache;
+        delete vulkanUploadContext;
         delete vulkanDevice;
         delete vulkanPhysicalDevice;
         delete vulkanApp;
         delete mouse;
         delete keyboard;
         delete window;
+        delete threadPool;
         delete fileSystem;
     }
 }
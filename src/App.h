@@ -1,6 +1,7 @@
 #pragma once
 
 #include "system/FileSystem.h"
+#include "system/ThreadPool.h"
 #include "window/Window.h"
 #include "window/Keyboard.h"
 #include "window/Mouse.h"
@@ -8,9 +9,13 @@
 #include "graphics/Renderer.h"
 #include "graphics/ShaderManager.h"
 #include "graphics/SkyboxManager.h"
+#include "graphics/TextureCompression.h"
+#include "graphics/TextureLoader.h"
 #include "graphics/VulkanApp.h"
 #include "graphics/VulkanPhysicalDevice.h"
 #include "graphics/VulkanDevice.h"
+#include "graphics/VulkanUploadContext.h"
+#include "graphics/VulkanPipelineCache.h"
 #include "lua/LuaEngine.h"
 #include "scene/SceneCamera.h"
 #include "scene/Scene.h"
@@ -24,6 +29,9 @@ namespace Blink {
         int32_t windowHeight = 600;
         bool windowMaximized = false;
         bool windowResizable = false;
+        float lodBias = 1.0f;
+        bool bindlessTexturesEnabled = true;
+        FramePacing framePacing{}; // Can be changed at runtime with F10, see Renderer::onEvent
     };
 
     class App {
@@ -33,12 +41,17 @@ namespace Blink {
         bool running = false;
         bool paused = false;
         FileSystem* fileSystem = nullptr;
+        ThreadPool* threadPool = nullptr;
         Window* window = nullptr;
         Keyboard* keyboard = nullptr;
         Mouse* mouse = nullptr;
         VulkanApp* vulkanApp = nullptr;
         VulkanPhysicalDevice* vulkanPhysicalDevice = nullptr;
         VulkanDevice* vulkanDevice = nullptr;
+        VulkanUploadContext* vulkanUploadContext = nullptr;
+        VulkanPipelineCache* vulkanPipelineCache = nullptr;
+        TextureCompression* textureCompression = nullptr;
+        TextureLoader* textureLoader = nullptr;
         MeshManager* meshManager = nullptr;
         ShaderManager* shaderManager = nullptr;
         SkyboxManager* skyboxManager = nullptr;
@@ -46,6 +59,8 @@ namespace Blink {
         LuaEngine* luaEngine = nullptr;
         SceneCamera* sceneCamera = nullptr;
         Scene* scene = nullptr;
+        std::string pendingScenePath; // Scene to switch to once its files have been preloaded
+        std::map<std::string, SceneAssets> sceneAssets; // Files used by the scenes that have been loaded before
 
     public:
         explicit App(const AppConfig& config);
@@ -55,10 +70,14 @@ namespace Blink {
         void run();
 
     private:
-        void gameLoop() const;
+        void gameLoop();
 
         void onEvent(Event& event);
 
+        void requestScene(const std::string& scenePath);
+
+        bool isScenePreloaded() const;
+
         void setScene(const std::string& scenePath);
 
         void initialize();
@@ -0,0 +1,44 @@
+#include "pch.h"
+#include "Frustum.h"
+
+namespace Blink {
+    Frustum::Frustum(const glm::mat4& viewProjection) {
+        // GLM matrices are column major, m[column][row]
+        auto row = [&viewProjection](int32_t i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+        planes[0] = row(3) + row(0); // Left
+        planes[1] = row(3) - row(0); // Right
+        planes[2] = row(3) + row(1); // Bottom
+        planes[3] = row(3) - row(1); // Top
+        planes[4] = row(2); // Near, clip space depth is [0, 1] (GLM_FORCE_DEPTH_ZERO_TO_ONE)
+        planes[5] = row(3) - row(2); // Far
+        for (glm::vec4& plane : planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    const std::array<glm::vec4, 6>& Frustum::getPlanes() const {
+        return planes;
+    }
+
+    bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Frustum::intersectsBox(const glm::vec3& center, const glm::vec3& extents) const {
+        for (const glm::vec4& plane : planes) {
+            // Projected radius of the box onto the plane normal
+            float radius = glm::dot(extents, glm::abs(glm::vec3(plane)));
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+
+namespace Blink {
+
+    //
+    // View frustum extracted from a view-projection matrix (Gribb/Hartmann).
+    //
+    // Every plane is stored as (normal, distance) with the normal pointing into the frustum, so a point is inside
+    // the frustum when its signed distance to all planes is positive.
+    //
+    class Frustum {
+    private:
+        std::array<glm::vec4, 6> planes;
+
+    public:
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        const std::array<glm::vec4, 6>& getPlanes() const;
+
+        bool intersectsSphere(const glm::vec3& center, float radius) const;
+
+        bool intersectsBox(const glm::vec3& center, const glm::vec3& extents) const;
+    };
+}
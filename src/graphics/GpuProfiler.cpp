@@ -0,0 +1,145 @@
+#include "pch.h"
+#include "GpuProfiler.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace Blink {
+    GpuProfiler::GpuProfiler(const GpuProfilerConfig& config) : config(config) {
+        BL_ASSERT_THROW(config.frameCount > 0);
+        BL_ASSERT_THROW(!config.passNames.empty());
+        for (const std::string& passName : config.passNames) {
+            passTimes.push_back({passName, 0.0});
+        }
+        passTimeSums.resize(config.passNames.size(), 0.0);
+        passTimeCounts.resize(config.passNames.size(), 0);
+        lastLogTime = std::chrono::steady_clock::now();
+
+        VulkanPhysicalDevice* physicalDevice = config.device->getPhysicalDevice();
+        uint32_t graphicsFamily = physicalDevice->getQueueFamilyIndices().graphicsFamily.value();
+        uint32_t timestampValidBits = physicalDevice->getQueueFamilyProperties()[graphicsFamily].timestampValidBits;
+        if (timestampValidBits == 0) {
+            BL_LOG_WARN("GPU profiling is not supported by the graphics queue (timestampValidBits)");
+            return;
+        }
+        supported = true;
+        timestampPeriod = physicalDevice->getProperties().limits.timestampPeriod;
+        timestampMask = timestampValidBits >= 64 ? UINT64_MAX : (1ull << timestampValidBits) - 1;
+        createQueryPools();
+    }
+
+    GpuProfiler::~GpuProfiler() {
+        destroyQueryPools();
+    }
+
+    bool GpuProfiler::isSupported() const {
+        return supported;
+    }
+
+    void GpuProfiler::beginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+        BL_ASSERT(frameIndex < config.frameCount);
+        currentFrame = frameIndex;
+        if (!supported) {
+            return;
+        }
+        if (queryPoolsRecorded[currentFrame]) {
+            readResults(currentFrame);
+        }
+        constexpr uint32_t firstQuery = 0;
+        vkCmdResetQueryPool(commandBuffer, queryPools[currentFrame], firstQuery, (uint32_t) config.passNames.size() * QUERIES_PER_PASS);
+        queryPoolsRecorded[currentFrame] = true;
+
+        std::chrono::duration<double> timeSinceLog = std::chrono::steady_clock::now() - lastLogTime;
+        if (timeSinceLog.count() >= LOG_INTERVAL) {
+            logAveragePassTimes();
+        }
+    }
+
+    void GpuProfiler::beginPass(VkCommandBuffer commandBuffer, uint32_t pass) const {
+        BL_ASSERT(pass < config.passNames.size());
+        if (supported) {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPools[currentFrame], pass * QUERIES_PER_PASS);
+        }
+    }
+
+    void GpuProfiler::endPass(VkCommandBuffer commandBuffer, uint32_t pass) const {
+        BL_ASSERT(pass < config.passNames.size());
+        if (supported) {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPools[currentFrame], pass * QUERIES_PER_PASS + 1);
+        }
+    }
+
+    const std::vector<GpuPassTime>& GpuProfiler::getPassTimes() const {
+        return passTimes;
+    }
+
+    //
+    // Every query result is followed by its availability, which is zero for the queries of passes that were not
+    // recorded during the frame. The results are not waited for, but they are always available once the fence of the
+    // frame has been signaled.
+    //
+    void GpuProfiler::readResults(uint32_t frameIndex) {
+        const uint32_t queryCount = (uint32_t) config.passNames.size() * QUERIES_PER_PASS;
+        std::vector<uint64_t> results(queryCount * 2);
+        constexpr uint32_t firstQuery = 0;
+        constexpr VkDeviceSize stride = sizeof(uint64_t) * 2;
+        constexpr VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+        VkResult result = config.device->getQueryPoolResults(
+            queryPools[frameIndex],
+            firstQuery,
+            queryCount,
+            results.size() * sizeof(uint64_t),
+            results.data(),
+            stride,
+            flags
+        );
+        if (result != VK_SUCCESS && result != VK_NOT_READY) {
+            BL_LOG_WARN("Could not read GPU timestamps [{}]", (int32_t) result);
+            return;
+        }
+        for (uint32_t pass = 0; pass < passTimes.size(); pass++) {
+            const uint64_t* begin = &results[pass * QUERIES_PER_PASS * 2];
+            const uint64_t* end = begin + 2;
+            bool available = begin[1] != 0 && end[1] != 0;
+            if (!available) {
+                passTimes[pass].milliseconds = 0.0;
+                continue;
+            }
+            uint64_t ticks = (end[0] - begin[0]) & timestampMask;
+            passTimes[pass].milliseconds = (double) ticks * timestampPeriod / 1000000.0;
+            passTimeSums[pass] += passTimes[pass].milliseconds;
+            passTimeCounts[pass]++;
+        }
+    }
+
+    void GpuProfiler::logAveragePassTimes() {
+        std::stringstream ss;
+        for (uint32_t pass = 0; pass < passTimes.size(); pass++) {
+            double averageMilliseconds = passTimeCounts[pass] > 0 ? passTimeSums[pass] / passTimeCounts[pass] : 0.0;
+            ss << (pass > 0 ? ", " : "") << passTimes[pass].name << ": " << std::fixed << std::setprecision(3) << averageMilliseconds;
+            passTimeSums[pass] = 0.0;
+            passTimeCounts[pass] = 0;
+        }
+        BL_LOG_DEBUG("Average GPU pass times (ms) [{}]", ss.str());
+        lastLogTime = std::chrono::steady_clock::now();
+    }
+
+    void GpuProfiler::createQueryPools() {
+        VkQueryPoolCreateInfo queryPoolCreateInfo{};
+        queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolCreateInfo.queryCount = (uint32_t) config.passNames.size() * QUERIES_PER_PASS;
+
+        queryPools.resize(config.frameCount, nullptr);
+        queryPoolsRecorded.resize(config.frameCount, false);
+        for (VkQueryPool& queryPool : queryPools) {
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->createQueryPool(&queryPoolCreateInfo, &queryPool));
+        }
+    }
+
+    void GpuProfiler::destroyQueryPools() const {
+        for (VkQueryPool queryPool : queryPools) {
+            config.device->destroyQueryPool(queryPool);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "graphics/VulkanDevice.h"
+
+#include <vulkan/vulkan.h>
+#include <chrono>
+
+namespace Blink {
+    struct GpuPassTime {
+        std::string name;
+        double milliseconds = 0.0; // Zero if the pass was not recorded
+    };
+
+    struct GpuProfilerConfig {
+        VulkanDevice* device = nullptr;
+        uint32_t frameCount = 0;
+        std::vector<std::string> passNames; // Passes are identified by the index of their name
+    };
+
+    //
+    // Measures the GPU time of passes with timestamp queries.
+    //
+    // Every frame in flight has its own query pool with a begin and an end timestamp per pass. The results of a frame
+    // are read when its frame index is used again, after the fence of the frame has been waited on, so reading them
+    // never stalls. The pass times are therefore those of the frame that finished last with the same frame index.
+    //
+    // Timestamps can be written into any command buffer of the frame, including the secondary command buffers of a
+    // render pass, as long as they are executed after the primary command buffer that was passed to beginFrame.
+    //
+    // Devices without timestamp support on the graphics queue get a profiler that records nothing.
+    //
+    class GpuProfiler {
+    private:
+        static constexpr uint32_t QUERIES_PER_PASS = 2;
+        static constexpr double LOG_INTERVAL = 10.0; // Seconds between logging the average pass times
+
+    private:
+        GpuProfilerConfig config;
+        bool supported = false;
+        double timestampPeriod = 0.0; // Nanoseconds per timestamp tick
+        uint64_t timestampMask = 0; // Valid bits of a timestamp
+        std::vector<VkQueryPool> queryPools; // One per frame in flight
+        std::vector<bool> queryPoolsRecorded; // Whether the queries of the frame have been reset and written
+        std::vector<GpuPassTime> passTimes;
+        std::vector<double> passTimeSums; // Since the average pass times were last logged
+        std::vector<uint32_t> passTimeCounts;
+        std::chrono::steady_clock::time_point lastLogTime;
+        uint32_t currentFrame = 0;
+
+    public:
+        explicit GpuProfiler(const GpuProfilerConfig& config);
+
+        ~GpuProfiler();
+
+        bool isSupported() const;
+
+        // Must only be called after the fence of the frame has been waited on, and outside any render pass since the
+        // queries of the frame are reset in the command buffer
+        void beginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+        void beginPass(VkCommandBuffer commandBuffer, uint32_t pass) const;
+
+        void endPass(VkCommandBuffer commandBuffer, uint32_t pass) const;
+
+        // Pass times of the last frame whose results have been read
+        const std::vector<GpuPassTime>& getPassTimes() const;
+
+    private:
+        void readResults(uint32_t frameIndex);
+
+        void logAveragePassTimes();
+
+        void createQueryPools();
+
+        void destroyQueryPools() const;
+    };
+}
@@ -1,39 +1,112 @@
 #include "Mesh.h"
 
+#include <glm/gtc/packing.hpp>
+
 namespace Blink {
-    VkVertexInputBindingDescription MeshVertex::getBindingDescription() {
+    VkVertexInputBindingDescription MeshVertex::getBindingDescription(MeshVertexFormat format) {
         VkVertexInputBindingDescription bindingDescription{};
         bindingDescription.binding = 0;
-        bindingDescription.stride = sizeof(MeshVertex);
+        bindingDescription.stride = PackedMeshVertex::getSize(format);
         bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
         return bindingDescription;
     }
 
-    std::vector<VkVertexInputAttributeDescription> MeshVertex::getAttributeDescriptions() {
-        return {
+    std::vector<VkVertexInputAttributeDescription> MeshVertex::getAttributeDescriptions(MeshVertexFormat format) {
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions = {
             {
                 .binding = 0,
                 .location = 0,
-                .format = VK_FORMAT_R32G32B32_SFLOAT,
-                .offset = offsetof(MeshVertex, position),
-            },
-            {
-                .binding = 0,
-                .location = 1,
-                .format = VK_FORMAT_R32G32B32_SFLOAT,
-                .offset = offsetof(MeshVertex, color),
+                .format = VK_FORMAT_R16G16B16A16_UNORM,
+                .offset = offsetof(PackedMeshVertex, position),
             },
             {
                 .binding = 0,
                 .location = 2,
-                .format = VK_FORMAT_R32G32_SFLOAT,
-                .offset = offsetof(MeshVertex, textureCoordinate),
+                .format = VK_FORMAT_R16G16_SFLOAT,
+                .offset = offsetof(PackedMeshVertex, textureCoordinate),
             },
             {
                 .binding = 0,
                 .location = 3,
+                .format = VK_FORMAT_R8_UINT,
+                .offset = offsetof(PackedMeshVertex, textureIndex),
+            }
+        };
+        if (format == MeshVertexFormat::PackedColor) {
+            attributeDescriptions.push_back({
+                .binding = 0,
+                .location = 1,
+                .format = VK_FORMAT_R8G8B8A8_UNORM,
+                .offset = offsetof(PackedMeshVertex, color),
+            });
+        }
+        return attributeDescriptions;
+    }
+
+    uint32_t PackedMeshVertex::getSize(MeshVertexFormat format) {
+        return format == MeshVertexFormat::PackedColor ? sizeof(PackedMeshVertex) : offsetof(PackedMeshVertex, color);
+    }
+
+    PackedMeshVertex PackedMeshVertex::pack(const MeshVertex& vertex, const glm::vec3& positionMin, const glm::vec3& positionScale) {
+        PackedMeshVertex packedVertex{};
+        glm::vec3 normalizedPosition = glm::clamp((vertex.position - positionMin) / positionScale, 0.0f, 1.0f);
+        glm::u16vec4 position = glm::packUnorm<uint16_t>(glm::vec4(normalizedPosition, 0.0f));
+        for (uint32_t i = 0; i < 4; i++) {
+            packedVertex.position[i] = position[i];
+        }
+        packedVertex.textureCoordinate[0] = glm::packHalf1x16(vertex.textureCoordinate.x);
+        packedVertex.textureCoordinate[1] = glm::packHalf1x16(vertex.textureCoordinate.y);
+        packedVertex.textureIndex = (uint8_t) vertex.textureIndex;
+        glm::u8vec4 color = glm::packUnorm<uint8_t>(glm::vec4(vertex.color, 1.0f));
+        for (uint32_t i = 0; i < 4; i++) {
+            packedVertex.color[i] = color[i];
+        }
+        return packedVertex;
+    }
+
+    VkVertexInputBindingDescription MeshInstanceData::getBindingDescription() {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 1;
+        bindingDescription.stride = sizeof(MeshInstanceData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        return bindingDescription;
+    }
+
+    //
+    // A vertex attribute can be at most the size of a vec4, so the model matrix is passed as four consecutive
+    // vec4 attributes (one per column) and is reassembled into a mat4 by the vertex shader.
+    //
+    std::vector<VkVertexInputAttributeDescription> MeshInstanceData::getAttributeDescriptions() {
+        return {
+            {
+                .binding = 1,
+                .location = 4,
+                .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+                .offset = offsetof(MeshInstanceData, model) + 0 * sizeof(glm::vec4),
+            },
+            {
+                .binding = 1,
+                .location = 5,
+                .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+                .offset = offsetof(MeshInstanceData, model) + 1 * sizeof(glm::vec4),
+            },
+            {
+                .binding = 1,
+                .location = 6,
+                .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+                .offset = offsetof(MeshInstanceData, model) + 2 * sizeof(glm::vec4),
+            },
+            {
+                .binding = 1,
+                .location = 7,
+                .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+                .offset = offsetof(MeshInstanceData, model) + 3 * sizeof(glm::vec4),
+            },
+            {
+                .binding = 1,
+                .location = 8,
                 .format = VK_FORMAT_R32_UINT,
-                .offset = offsetof(MeshVertex, textureIndex),
+                .offset = offsetof(MeshInstanceData, textureTableOffset),
             }
         };
     }
@@ -12,18 +12,45 @@
 #include <vector>
 
 namespace Blink {
+    // Layout of the vertices in a mesh's vertex buffer
+    enum class MeshVertexFormat {
+        Packed, // 16 bytes, white vertex color
+        PackedColor // 20 bytes, for models with vertex colors
+    };
+
+    // Vertex as imported from the model file, packed into a PackedMeshVertex before it is uploaded
     struct MeshVertex {
         glm::vec3 position = {0.0f, 0.0f, 0.0f};
         glm::vec3 color = {1.0f, 1.0f, 1.0f};
         glm::vec2 textureCoordinate = {0.0f, 0.0f};
         uint32_t textureIndex = 0;
 
-        static VkVertexInputBindingDescription getBindingDescription();
+        // Describe the packed vertex layout of the format
+        static VkVertexInputBindingDescription getBindingDescription(MeshVertexFormat format);
 
-        static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+        static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(MeshVertexFormat format);
 
         bool operator==(const MeshVertex& other) const;
     };
+
+    //
+    // Quantized vertex read by the mesh vertex shaders.
+    //
+    // Positions are 16-bit normalized integers relative to the mesh's AABB (see Mesh::dequantization), texture
+    // coordinates are half floats and the texture index is a single byte. The color is only part of the vertex in the
+    // PackedColor format, the Packed format ends before it.
+    //
+    struct PackedMeshVertex {
+        uint16_t position[4] = {}; // R16G16B16A16_UNORM, W is unused
+        uint16_t textureCoordinate[2] = {}; // R16G16_SFLOAT
+        uint8_t textureIndex = 0; // R8_UINT
+        uint8_t padding[3] = {};
+        uint8_t color[4] = {}; // R8G8B8A8_UNORM, PackedColor only
+
+        static uint32_t getSize(MeshVertexFormat format);
+
+        static PackedMeshVertex pack(const MeshVertex& vertex, const glm::vec3& positionMin, const glm::vec3& positionScale);
+    };
 }
 
 template<>
@@ -32,19 +59,55 @@ struct std::hash<Blink::MeshVertex> {
 };
 
 namespace Blink {
+    // Object space bounding volumes of a mesh's vertices
+    struct MeshBounds {
+        glm::vec3 min = {0.0f, 0.0f, 0.0f};
+        glm::vec3 max = {0.0f, 0.0f, 0.0f};
+        glm::vec3 center = {0.0f, 0.0f, 0.0f}; // Bounding sphere center
+        float radius = 0.0f; // Bounding sphere radius
+    };
+}
+
+namespace Blink {
+    // Range of the mesh's index buffer drawn for a level of detail
+    struct MeshLod {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+}
+
+namespace Blink {
+    // GPU resources shared by every entity using the same model and textures.
+    // Per-entity data (e.g. the model matrix) is kept by the entity and passed to the renderer as instance data.
     struct Mesh {
-        glm::mat4 model = glm::mat4(1.0f);
-        std::vector<MeshVertex> vertices;
-        std::vector<uint32_t> indices;
+        static constexpr uint32_t MAX_LODS = 4;
+
+        std::vector<MeshLod> lods; // Ranges of the index buffer, which holds all levels starting with the full detail mesh
+        MeshVertexFormat vertexFormat = MeshVertexFormat::Packed;
+        glm::mat4 dequantization = glm::mat4(1.0f); // Maps packed positions from [0, 1] back to the model's AABB
+        MeshBounds bounds{};
         std::shared_ptr<VulkanVertexBuffer> vertexBuffer = nullptr;
         std::shared_ptr<VulkanIndexBuffer> indexBuffer = nullptr;
         std::vector<std::shared_ptr<VulkanImage>> textures;
-        VkDescriptorSet descriptorSet = nullptr;
+        VkDescriptorSet descriptorSet = nullptr; // Shared by every mesh with bindless textures
+        uint32_t textureTableOffset = 0; // First entry of the mesh in the bindless texture table, 0 without bindless textures
     };
 }
 
 namespace Blink {
-    struct MeshPushConstantData {
-        alignas(16) glm::mat4 model;
+    // Per-instance data read from its own vertex buffer binding (VK_VERTEX_INPUT_RATE_INSTANCE)
+    // to be able to draw all instances of the same mesh with a single draw call.
+    //
+    // The texture table offset is added to the texture index of every vertex, which turns it into an index into the
+    // texture table when the textures are bindless (see MeshManager).
+    //
+    struct MeshInstanceData {
+        glm::mat4 model = glm::mat4(1.0f);
+        uint32_t textureTableOffset = 0;
+        uint32_t padding[3] = {};
+
+        static VkVertexInputBindingDescription getBindingDescription();
+
+        static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
     };
 }
\ No newline at end of file
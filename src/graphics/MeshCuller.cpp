@@ -0,0 +1,423 @@
+#include "pch.h"
+#include "MeshCuller.h"
+
+#include <numeric>
+#include <tuple>
+
+namespace Blink {
+    MeshCuller::MeshCuller(const MeshCullerConfig& config) : config(config) {
+        BL_ASSERT_THROW(config.frameCount > 0);
+        BL_ASSERT_THROW(config.maxObjects > 0);
+        createBuffers();
+        createDescriptorObjects();
+        createPipeline();
+    }
+
+    MeshCuller::~MeshCuller() {
+        destroyPipeline();
+        destroyDescriptorObjects();
+        destroyBuffers();
+    }
+
+    void MeshCuller::reloadShaders() {
+        destroyPipeline();
+        createPipeline();
+    }
+
+    void MeshCuller::beginFrame(uint32_t frameIndex) {
+        BL_ASSERT(frameIndex < config.frameCount);
+        currentFrame = frameIndex;
+    }
+
+    uint32_t MeshCuller::addObject(Mesh* mesh, const glm::mat4& model) {
+        if (objects.size() == config.maxObjects) {
+            if (droppedObjectCount == 0) {
+                BL_LOG_WARN("Object count exceeds the maximum [{}], excess objects will not be rendered", config.maxObjects);
+            }
+            droppedObjectCount++;
+            return INVALID_OBJECT;
+        }
+        auto [iterator, inserted] = batchIndices.try_emplace(mesh, (uint32_t) batches.size());
+        if (inserted) {
+            MeshCullerBatch batch{};
+            batch.mesh = mesh;
+            batches.push_back(batch);
+        }
+        uint32_t batchIndex = iterator->second;
+        batches[batchIndex].objectCount++;
+        // The instance ranges of the batches depend on their object counts
+        batchesChanged = true;
+
+        MeshCullerObject object{};
+        object.batchIndex = batchIndex;
+        object.model = model;
+        objects.push_back(object);
+
+        auto objectId = (uint32_t) objects.size() - 1;
+        markDirty(objectId);
+        return objectId;
+    }
+
+    void MeshCuller::updateObject(uint32_t objectId, const glm::mat4& model) {
+        BL_ASSERT(objectId < objects.size());
+        objects[objectId].model = model;
+        markDirty(objectId);
+    }
+
+    void MeshCuller::setObjectEnabled(uint32_t objectId, bool enabled) {
+        BL_ASSERT(objectId < objects.size());
+        if (objects[objectId].enabled == enabled) {
+            return;
+        }
+        objects[objectId].enabled = enabled;
+        markDirty(objectId);
+    }
+
+    void MeshCuller::clear() {
+        batchIndices.clear();
+        batches.clear();
+        drawGroups.clear();
+        drawCommandCount = 0;
+        batchesChanged = false;
+        objects.clear();
+        dirtyObjectIndices.clear();
+        droppedObjectCount = 0;
+    }
+
+    void MeshCuller::cull(VkCommandBuffer commandBuffer, const Frustum& frustum, const MeshCullerLodSelection& lodSelection) {
+        if (batchesChanged) {
+            layOutDrawCommands();
+        }
+        recordObjectUploads(commandBuffer);
+        if (objects.empty()) {
+            return;
+        }
+        writeBatches();
+
+        MeshCullerPushConstants pushConstants{};
+        pushConstants.frustumPlanes = frustum.getPlanes();
+        pushConstants.camera = glm::vec4(lodSelection.cameraPosition, lodSelection.scale);
+        pushConstants.objectCount = (uint32_t) objects.size();
+        pushConstants.lodScreenSize = lodSelection.screenSize;
+
+        pipeline->bind(commandBuffer);
+
+        constexpr uint32_t firstSet = 0;
+        constexpr uint32_t descriptorSetCount = 1;
+        constexpr uint32_t dynamicOffsetCount = 0;
+        constexpr uint32_t* dynamicOffsets = nullptr;
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            pipeline->getLayout(),
+            firstSet,
+            descriptorSetCount,
+            &frames[currentFrame].descriptorSet,
+            dynamicOffsetCount,
+            dynamicOffsets
+        );
+
+        constexpr uint32_t pushConstantsOffset = 0;
+        vkCmdPushConstants(commandBuffer, pipeline->getLayout(), VK_SHADER_STAGE_COMPUTE_BIT, pushConstantsOffset, sizeof(MeshCullerPushConstants), &pushConstants);
+
+        uint32_t workgroupCount = ((uint32_t) objects.size() + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+        vkCmdDispatch(commandBuffer, workgroupCount, 1, 1);
+
+        // The draw commands and instances written by the compute shader are read by the indirect draws and vertex input
+        VkMemoryBarrier memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+        constexpr VkPipelineStageFlags srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        constexpr VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        constexpr VkDependencyFlags dependencyFlags = 0;
+        constexpr uint32_t memoryBarrierCount = 1;
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, dependencyFlags, memoryBarrierCount, &memoryBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    const std::vector<MeshCullerDrawGroup>& MeshCuller::getDrawGroups() const {
+        return drawGroups;
+    }
+
+    VkBuffer MeshCuller::getDrawCommandBuffer() const {
+        return *frames[currentFrame].drawCommandBuffer;
+    }
+
+    VkBuffer MeshCuller::getInstanceBuffer() const {
+        return *frames[currentFrame].instanceBuffer;
+    }
+
+    void MeshCuller::markDirty(uint32_t objectId) {
+        if (!objects[objectId].dirty) {
+            objects[objectId].dirty = true;
+            dirtyObjectIndices.push_back(objectId);
+        }
+    }
+
+    //
+    // Order the batches by the state their meshes are drawn with (the pipeline follows from the vertex format) and give
+    // every batch a range of draw commands, one per level of detail, and a range of the instance buffer per level large
+    // enough for all of its objects to be visible at that level.
+    //
+    // Batches whose meshes share all of their state form a draw group, which can be drawn with a single multi-draw. This
+    // is the case for meshes that share their geometry and, with bindless textures, their descriptor set.
+    //
+    void MeshCuller::layOutDrawCommands() {
+        auto getStateKey = [](const Mesh* mesh) {
+            return std::make_tuple(mesh->vertexFormat, mesh->descriptorSet, (VkBuffer) *mesh->vertexBuffer, (VkBuffer) *mesh->indexBuffer);
+        };
+        std::vector<uint32_t> batchOrder(batches.size());
+        std::iota(batchOrder.begin(), batchOrder.end(), 0);
+        std::sort(batchOrder.begin(), batchOrder.end(), [&](uint32_t a, uint32_t b) {
+            return getStateKey(batches[a].mesh) < getStateKey(batches[b].mesh);
+        });
+
+        drawGroups.clear();
+        drawCommandCount = 0;
+        uint32_t firstInstance = 0;
+        for (uint32_t batchIndex : batchOrder) {
+            MeshCullerBatch& batch = batches[batchIndex];
+            auto lodCount = (uint32_t) batch.mesh->lods.size();
+            batch.firstDrawCommand = drawCommandCount;
+            batch.firstInstance = firstInstance;
+
+            if (drawGroups.empty() || getStateKey(drawGroups.back().mesh) != getStateKey(batch.mesh)) {
+                MeshCullerDrawGroup drawGroup{};
+                drawGroup.mesh = batch.mesh;
+                drawGroup.firstDrawCommand = drawCommandCount;
+                drawGroups.push_back(drawGroup);
+            }
+            drawGroups.back().drawCommandCount += lodCount;
+
+            drawCommandCount += lodCount;
+            firstInstance += batch.objectCount * lodCount;
+        }
+        batchesChanged = false;
+    }
+
+    //
+    // The batches and draw commands are rewritten every frame, since the instance counts of the draw commands are
+    // incremented by the compute shader. This is done per mesh, not per object.
+    //
+    void MeshCuller::writeBatches() const {
+        const MeshCullerFrame& frame = frames[currentFrame];
+        auto batchData = (MeshCullerBatchData*) frame.batchBuffer->getMappedData();
+        auto drawCommands = (VkDrawIndexedIndirectCommand*) frame.drawCommandBuffer->getMappedData();
+        for (uint32_t i = 0; i < batches.size(); i++) {
+            const MeshCullerBatch& batch = batches[i];
+            const Mesh* mesh = batch.mesh;
+            batchData[i].boundingSphere = glm::vec4(mesh->bounds.center, mesh->bounds.radius);
+            batchData[i].positionOffset = mesh->dequantization[3];
+            batchData[i].positionScale = glm::vec4(mesh->dequantization[0][0], mesh->dequantization[1][1], mesh->dequantization[2][2], 0.0f);
+            batchData[i].textureTableOffset = mesh->textureTableOffset;
+            batchData[i].firstDrawCommand = batch.firstDrawCommand;
+            batchData[i].lodCount = (uint32_t) mesh->lods.size();
+
+            for (uint32_t lod = 0; lod < mesh->lods.size(); lod++) {
+                VkDrawIndexedIndirectCommand& drawCommand = drawCommands[batch.firstDrawCommand + lod];
+                drawCommand.indexCount = mesh->lods[lod].indexCount;
+                drawCommand.instanceCount = 0;
+                drawCommand.firstIndex = mesh->lods[lod].firstIndex;
+                drawCommand.vertexOffset = 0;
+                drawCommand.firstInstance = batch.firstInstance + lod * batch.objectCount;
+            }
+        }
+    }
+
+    //
+    // Copy the objects that changed since the last upload from the staging buffer of the frame into the object buffer.
+    //
+    // Every object is only uploaded once per frame, so the staging buffer has room for all of them. The copy has to
+    // wait for the culling of earlier frames that may still be reading the object buffer.
+    //
+    void MeshCuller::recordObjectUploads(VkCommandBuffer commandBuffer) {
+        if (dirtyObjectIndices.empty()) {
+            return;
+        }
+        auto objectUpdates = (MeshCullerObjectData*) frames[currentFrame].objectUpdateBuffer->getMappedData();
+        std::vector<VkBufferCopy> copyRegions(dirtyObjectIndices.size());
+        for (uint32_t i = 0; i < dirtyObjectIndices.size(); i++) {
+            uint32_t objectId = dirtyObjectIndices[i];
+            MeshCullerObject& object = objects[objectId];
+            objectUpdates[i].model = object.model;
+            objectUpdates[i].batchIndex = object.enabled ? object.batchIndex : DISABLED_BATCH;
+            object.dirty = false;
+
+            copyRegions[i].srcOffset = i * sizeof(MeshCullerObjectData);
+            copyRegions[i].dstOffset = objectId * sizeof(MeshCullerObjectData);
+            copyRegions[i].size = sizeof(MeshCullerObjectData);
+        }
+        dirtyObjectIndices.clear();
+
+        constexpr VkDependencyFlags dependencyFlags = 0;
+        constexpr uint32_t noMemoryBarriers = 0;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, dependencyFlags, noMemoryBarriers, nullptr, 0, nullptr, 0, nullptr);
+
+        vkCmdCopyBuffer(commandBuffer, *frames[currentFrame].objectUpdateBuffer, *objectBuffer, (uint32_t) copyRegions.size(), copyRegions.data());
+
+        VkMemoryBarrier memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        constexpr uint32_t memoryBarrierCount = 1;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dependencyFlags, memoryBarrierCount, &memoryBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    void MeshCuller::createBuffers() {
+        // Written by copies from the object update buffers, see recordObjectUploads
+        VulkanBufferConfig objectBufferConfig{};
+        objectBufferConfig.device = config.device;
+        objectBufferConfig.size = sizeof(MeshCullerObjectData) * config.maxObjects;
+        objectBufferConfig.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        objectBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        objectBuffer = new VulkanBuffer(objectBufferConfig);
+
+        frames.resize(config.frameCount);
+        for (MeshCullerFrame& frame : frames) {
+            // Objects that changed, written by the CPU every frame
+            VulkanBufferConfig objectUpdateBufferConfig{};
+            objectUpdateBufferConfig.device = config.device;
+            objectUpdateBufferConfig.size = sizeof(MeshCullerObjectData) * config.maxObjects;
+            objectUpdateBufferConfig.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            objectUpdateBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            frame.objectUpdateBuffer = new VulkanBuffer(objectUpdateBufferConfig);
+
+            // At most one batch per object
+            VulkanBufferConfig batchBufferConfig{};
+            batchBufferConfig.device = config.device;
+            batchBufferConfig.size = sizeof(MeshCullerBatchData) * config.maxObjects;
+            batchBufferConfig.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+            batchBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            frame.batchBuffer = new VulkanBuffer(batchBufferConfig);
+
+            // Initialized by the CPU, instance counts written by the compute shader, one per level of detail of every batch
+            VulkanBufferConfig drawCommandBufferConfig{};
+            drawCommandBufferConfig.device = config.device;
+            drawCommandBufferConfig.size = sizeof(VkDrawIndexedIndirectCommand) * config.maxObjects * Mesh::MAX_LODS;
+            drawCommandBufferConfig.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+            drawCommandBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            frame.drawCommandBuffer = new VulkanBuffer(drawCommandBufferConfig);
+
+            // Only ever accessed by the GPU, every level of detail of a batch has room for all of its objects
+            VulkanBufferConfig instanceBufferConfig{};
+            instanceBufferConfig.device = config.device;
+            instanceBufferConfig.size = sizeof(MeshInstanceData) * config.maxObjects * Mesh::MAX_LODS;
+            instanceBufferConfig.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+            instanceBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            frame.instanceBuffer = new VulkanBuffer(instanceBufferConfig);
+
+            BL_ASSERT_THROW(frame.objectUpdateBuffer->getMappedData() != nullptr);
+            BL_ASSERT_THROW(frame.batchBuffer->getMappedData() != nullptr);
+            BL_ASSERT_THROW(frame.drawCommandBuffer->getMappedData() != nullptr);
+        }
+    }
+
+    void MeshCuller::destroyBuffers() const {
+        for (const MeshCullerFrame& frame : frames) {
+            delete frame.instanceBuffer;
+            delete frame.drawCommandBuffer;
+            delete frame.batchBuffer;
+            delete frame.objectUpdateBuffer;
+        }
+        delete objectBuffer;
+    }
+
+    void MeshCuller::createDescriptorObjects() {
+        constexpr uint32_t bindingCount = 4; // Objects, batches, draw commands and instances
+
+        // Descriptor pool
+        VkDescriptorPoolSize descriptorPoolSize{};
+        descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorPoolSize.descriptorCount = bindingCount * config.frameCount;
+
+        VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
+        descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptorPoolCreateInfo.poolSizeCount = 1;
+        descriptorPoolCreateInfo.pPoolSizes = &descriptorPoolSize;
+        descriptorPoolCreateInfo.maxSets = config.frameCount;
+
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorPool(&descriptorPoolCreateInfo, &descriptorPool));
+
+        // Descriptor set layout
+        std::array<VkDescriptorSetLayoutBinding, bindingCount> layoutBindings{};
+        for (uint32_t i = 0; i < bindingCount; i++) {
+            layoutBindings[i].binding = i;
+            layoutBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            layoutBindings[i].descriptorCount = 1;
+            layoutBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{};
+        descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptorSetLayoutCreateInfo.bindingCount = bindingCount;
+        descriptorSetLayoutCreateInfo.pBindings = layoutBindings.data();
+
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorSetLayout(&descriptorSetLayoutCreateInfo, &descriptorSetLayout));
+
+        // Descriptor sets
+        for (MeshCullerFrame& frame : frames) {
+            VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
+            descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            descriptorSetAllocateInfo.descriptorPool = descriptorPool;
+            descriptorSetAllocateInfo.descriptorSetCount = 1;
+            descriptorSetAllocateInfo.pSetLayouts = &descriptorSetLayout;
+
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->allocateDescriptorSets(&descriptorSetAllocateInfo, &frame.descriptorSet));
+
+            std::array<VulkanBuffer*, bindingCount> buffers = {
+                objectBuffer,
+                frame.batchBuffer,
+                frame.drawCommandBuffer,
+                frame.instanceBuffer
+            };
+            std::array<VkDescriptorBufferInfo, bindingCount> descriptorBufferInfos{};
+            std::array<VkWriteDescriptorSet, bindingCount> descriptorWrites{};
+            for (uint32_t i = 0; i < bindingCount; i++) {
+                descriptorBufferInfos[i].buffer = *buffers[i];
+                descriptorBufferInfos[i].offset = 0;
+                descriptorBufferInfos[i].range = VK_WHOLE_SIZE;
+
+                descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                descriptorWrites[i].dstSet = frame.descriptorSet;
+                descriptorWrites[i].dstBinding = i;
+                descriptorWrites[i].dstArrayElement = 0;
+                descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                descriptorWrites[i].descriptorCount = 1;
+                descriptorWrites[i].pBufferInfo = &descriptorBufferInfos[i];
+            }
+            config.device->updateDescriptorSets(bindingCount, descriptorWrites.data());
+        }
+    }
+
+    void MeshCuller::destroyDescriptorObjects() const {
+        config.device->destroyDescriptorPool(descriptorPool);
+        config.device->destroyDescriptorSetLayout(descriptorSetLayout);
+    }
+
+    void MeshCuller::createPipeline() {
+        std::vector<VkDescriptorSetLayout> descriptorSetLayouts = {
+            descriptorSetLayout
+        };
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(MeshCullerPushConstants);
+        std::vector<VkPushConstantRange> pushConstantRanges = {
+            pushConstantRange
+        };
+
+        VulkanComputePipelineConfig computePipelineConfig{};
+        computePipelineConfig.device = config.device;
+        computePipelineConfig.pipelineCache = config.pipelineCache;
+        computePipelineConfig.computeShader = config.shaderManager->getShader("shaders/cull.comp.spv");
+        computePipelineConfig.descriptorSetLayouts = &descriptorSetLayouts;
+        computePipelineConfig.pushConstantRanges = &pushConstantRanges;
+        pipeline = new VulkanComputePipeline(computePipelineConfig);
+    }
+
+    void MeshCuller::destroyPipeline() const {
+        delete pipeline;
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "graphics/Frustum.h"
+#include "graphics/Mesh.h"
+#include "graphics/ShaderManager.h"
+#include "graphics/VulkanBuffer.h"
+#include "graphics/VulkanComputePipeline.h"
+#include "graphics/VulkanDevice.h"
+#include "graphics/VulkanPipelineCache.h"
+
+#include <vulkan/vulkan.h>
+#include <limits>
+
+namespace Blink {
+    // Layouts must match the storage buffers of cull.comp (std430)
+    struct MeshCullerObjectData {
+        glm::mat4 model = glm::mat4(1.0f);
+        uint32_t batchIndex = 0; // MeshCuller::DISABLED_BATCH for objects that are disabled or removed
+        uint32_t padding[3] = {};
+    };
+
+    struct MeshCullerBatchData {
+        glm::vec4 boundingSphere = {0.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec4 positionOffset = {0.0f, 0.0f, 0.0f, 0.0f}; // Dequantization of packed vertex positions
+        glm::vec4 positionScale = {1.0f, 1.0f, 1.0f, 0.0f};
+        uint32_t textureTableOffset = 0;
+        uint32_t firstDrawCommand = 0; // Followed by the draw commands of the other levels of detail
+        uint32_t lodCount = 0;
+        uint32_t padding = 0;
+    };
+
+    struct MeshCullerPushConstants {
+        std::array<glm::vec4, 6> frustumPlanes{};
+        glm::vec4 camera = {0.0f, 0.0f, 0.0f, 0.0f}; // World space position (xyz) and LOD scale (w)
+        uint32_t objectCount = 0;
+        float lodScreenSize = 0.0f;
+    };
+
+    // Selects the level of detail of an object from the projected radius of its bounding sphere (see Scene::selectLod)
+    struct MeshCullerLodSelection {
+        glm::vec3 cameraPosition = {0.0f, 0.0f, 0.0f};
+        float scale = 1.0f; // Turns a radius at a distance into a fraction of the viewport's half height
+        float screenSize = 0.5f; // Projected radius below which the first simplified level is used
+    };
+
+    // Objects drawn with the same mesh, at any level of detail
+    struct MeshCullerBatch {
+        Mesh* mesh = nullptr;
+        uint32_t objectCount = 0;
+        uint32_t firstInstance = 0; // Every level of detail has room for all objects of the batch
+        uint32_t firstDrawCommand = 0;
+    };
+
+    // Consecutive draw commands of meshes that are drawn with the same pipeline, descriptor set and geometry
+    struct MeshCullerDrawGroup {
+        Mesh* mesh = nullptr; // First mesh of the group, which has the state of all of them
+        uint32_t firstDrawCommand = 0;
+        uint32_t drawCommandCount = 0;
+    };
+
+    struct MeshCullerObject {
+        uint32_t batchIndex = 0;
+        glm::mat4 model = glm::mat4(1.0f);
+        bool enabled = true;
+        bool dirty = false; // Waiting to be uploaded
+    };
+
+    // Buffers written and read by a single frame in flight
+    struct MeshCullerFrame {
+        VulkanBuffer* objectUpdateBuffer = nullptr; // Staging buffer of the objects that changed since the last frame
+        VulkanBuffer* batchBuffer = nullptr;
+        VulkanBuffer* drawCommandBuffer = nullptr;
+        VulkanBuffer* instanceBuffer = nullptr;
+        VkDescriptorSet descriptorSet = nullptr;
+    };
+
+    struct MeshCullerConfig {
+        VulkanDevice* device = nullptr;
+        VulkanPipelineCache* pipelineCache = nullptr;
+        ShaderManager* shaderManager = nullptr;
+        uint32_t frameCount = 0;
+        uint32_t maxObjects = 0;
+    };
+
+    //
+    // Frustum culls mesh objects and selects their level of detail on the GPU, producing the indirect draw commands of
+    // every mesh and level of detail.
+    //
+    // Objects are persistent: they are added once and only updated when their transform changes. The transforms of all
+    // objects live in a device local storage buffer, and the objects that changed are copied into it before culling.
+    //
+    // Every mesh gets a batch with its bounding sphere and one draw command per level of detail. A compute shader tests
+    // every object against the frustum, selects its level of detail and appends the model matrix of every visible object
+    // to the instance buffer, counting the instances of each level in its VkDrawIndexedIndirectCommand. The CPU never has
+    // to know which objects are visible, or even look at the objects that didn't change.
+    //
+    // The draw commands are ordered by the state their meshes are drawn with, so that the draws of meshes sharing the
+    // same pipeline, descriptor set and geometry can be issued with a single multi-draw (see getDrawGroups).
+    //
+    class MeshCuller {
+    public:
+        static constexpr uint32_t INVALID_OBJECT = std::numeric_limits<uint32_t>::max();
+
+    private:
+        static constexpr uint32_t WORKGROUP_SIZE = 64; // Must match local_size_x of cull.comp
+        static constexpr uint32_t DISABLED_BATCH = std::numeric_limits<uint32_t>::max(); // Must match cull.comp
+
+    private:
+        MeshCullerConfig config;
+        std::vector<MeshCullerFrame> frames;
+        VulkanBuffer* objectBuffer = nullptr; // Shared by all frames, only written by the copies recorded in cull
+        VkDescriptorPool descriptorPool = nullptr;
+        VkDescriptorSetLayout descriptorSetLayout = nullptr;
+        VulkanComputePipeline* pipeline = nullptr;
+        std::unordered_map<const Mesh*, uint32_t> batchIndices;
+        std::vector<MeshCullerBatch> batches;
+        std::vector<MeshCullerDrawGroup> drawGroups;
+        uint32_t drawCommandCount = 0;
+        bool batchesChanged = false; // Whether the draw commands have to be laid out again
+        std::vector<MeshCullerObject> objects; // Indexed by object id
+        std::vector<uint32_t> dirtyObjectIndices;
+        uint32_t droppedObjectCount = 0; // Objects that could not be added because the maximum was reached
+        uint32_t currentFrame = 0;
+
+    public:
+        explicit MeshCuller(const MeshCullerConfig& config);
+
+        ~MeshCuller();
+
+        void reloadShaders();
+
+        // Must only be called after the fence of the frame has been waited on
+        void beginFrame(uint32_t frameIndex);
+
+        // Returns INVALID_OBJECT if the maximum number of objects has been reached
+        uint32_t addObject(Mesh* mesh, const glm::mat4& model);
+
+        void updateObject(uint32_t objectId, const glm::mat4& model);
+
+        // Disabled objects are kept but never drawn
+        void setObjectEnabled(uint32_t objectId, bool enabled);
+
+        // Removes all objects, must only be called when the GPU is idle
+        void clear();
+
+        // Records the object uploads and the culling dispatch, must be recorded outside the render pass that draws the batches
+        void cull(VkCommandBuffer commandBuffer, const Frustum& frustum, const MeshCullerLodSelection& lodSelection);
+
+        const std::vector<MeshCullerDrawGroup>& getDrawGroups() const;
+
+        VkBuffer getDrawCommandBuffer() const;
+
+        VkBuffer getInstanceBuffer() const;
+
+    private:
+        void markDirty(uint32_t objectId);
+
+        void layOutDrawCommands();
+
+        void writeBatches() const;
+
+        void recordObjectUploads(VkCommandBuffer commandBuffer);
+
+        void createBuffers();
+
+        void destroyBuffers() const;
+
+        void createDescriptorObjects();
+
+        void destroyDescriptorObjects() const;
+
+        void createPipeline();
+
+        void destroyPipeline() const;
+    };
+}
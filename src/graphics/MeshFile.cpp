@@ -0,0 +1,81 @@
+#include "pch.h"
+#include "MeshFile.h"
+
+namespace Blink {
+    std::vector<char> MeshFile::write(const MeshGeometry& geometry, uint64_t sourceHash) {
+        MeshFileHeader header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.sourceHash = sourceHash;
+        header.vertexFormat = (uint32_t) geometry.vertexFormat;
+        header.vertexCount = geometry.vertexCount;
+        header.indexType = (uint32_t) geometry.indexType;
+        header.indexCount = geometry.indexCount;
+        header.lodCount = (uint32_t) geometry.lods.size();
+        header.textureCount = (uint32_t) geometry.textureNames.size();
+        header.dequantization = geometry.dequantization;
+        header.bounds = geometry.bounds;
+
+        // Every section starts aligned so that it can be read in place
+        header.lodsOffset = alignUp(sizeof(MeshFileHeader));
+        header.texturesOffset = alignUp(header.lodsOffset + sizeof(MeshLod) * header.lodCount);
+        header.vertexDataOffset = alignUp(header.texturesOffset + sizeof(MeshFileTexture) * header.textureCount);
+        header.vertexDataSize = geometry.vertexDataSize;
+        header.indexDataOffset = alignUp(header.vertexDataOffset + header.vertexDataSize);
+        header.indexDataSize = geometry.indexDataSize;
+
+        std::vector<char> bytes(header.indexDataOffset + header.indexDataSize, 0);
+        memcpy(bytes.data(), &header, sizeof(MeshFileHeader));
+        memcpy(bytes.data() + header.lodsOffset, geometry.lods.data(), sizeof(MeshLod) * header.lodCount);
+        for (uint32_t i = 0; i < header.textureCount; i++) {
+            MeshFileTexture texture{};
+            strncpy(texture.name, geometry.textureNames[i].c_str(), sizeof(texture.name) - 1);
+            memcpy(bytes.data() + header.texturesOffset + sizeof(MeshFileTexture) * i, &texture, sizeof(MeshFileTexture));
+        }
+        memcpy(bytes.data() + header.vertexDataOffset, geometry.vertexData, header.vertexDataSize);
+        memcpy(bytes.data() + header.indexDataOffset, geometry.indexData, header.indexDataSize);
+        return bytes;
+    }
+
+    bool MeshFile::read(const char* data, uint64_t size, uint64_t sourceHash, MeshGeometry* geometry) {
+        if (size < sizeof(MeshFileHeader)) {
+            return false;
+        }
+        MeshFileHeader header{};
+        memcpy(&header, data, sizeof(MeshFileHeader));
+        if (header.magic != MAGIC || header.version != VERSION || header.sourceHash != sourceHash) {
+            return false;
+        }
+        if (header.lodsOffset + sizeof(MeshLod) * header.lodCount > size
+            || header.texturesOffset + sizeof(MeshFileTexture) * header.textureCount > size
+            || header.vertexDataOffset + header.vertexDataSize > size
+            || header.indexDataOffset + header.indexDataSize > size) {
+            return false;
+        }
+
+        geometry->vertexFormat = (MeshVertexFormat) header.vertexFormat;
+        geometry->dequantization = header.dequantization;
+        geometry->bounds = header.bounds;
+        geometry->lods.resize(header.lodCount);
+        memcpy(geometry->lods.data(), data + header.lodsOffset, sizeof(MeshLod) * header.lodCount);
+        geometry->textureNames.clear();
+        for (uint32_t i = 0; i < header.textureCount; i++) {
+            MeshFileTexture texture{};
+            memcpy(&texture, data + header.texturesOffset + sizeof(MeshFileTexture) * i, sizeof(MeshFileTexture));
+            texture.name[sizeof(texture.name) - 1] = '\0';
+            geometry->textureNames.emplace_back(texture.name);
+        }
+        geometry->indexType = (VkIndexType) header.indexType;
+        geometry->vertexCount = header.vertexCount;
+        geometry->indexCount = header.indexCount;
+        geometry->vertexData = data + header.vertexDataOffset;
+        geometry->vertexDataSize = header.vertexDataSize;
+        geometry->indexData = data + header.indexDataOffset;
+        geometry->indexDataSize = header.indexDataSize;
+        return true;
+    }
+
+    uint64_t MeshFile::alignUp(uint64_t value) {
+        return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "graphics/Mesh.h"
+#include "system/MappedFile.h"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+
+namespace Blink {
+    // Fixed size header at the start of a cooked mesh file, followed by the sections it points to
+    struct MeshFileHeader {
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint64_t sourceHash = 0; // Hash of the OBJ and MTL files the mesh was cooked from
+        uint32_t vertexFormat = 0;
+        uint32_t vertexCount = 0;
+        uint32_t indexType = 0;
+        uint32_t indexCount = 0;
+        uint32_t lodCount = 0;
+        uint32_t textureCount = 0;
+        uint64_t lodsOffset = 0;
+        uint64_t texturesOffset = 0;
+        uint64_t vertexDataOffset = 0;
+        uint64_t vertexDataSize = 0;
+        uint64_t indexDataOffset = 0;
+        uint64_t indexDataSize = 0;
+        glm::mat4 dequantization = glm::mat4(1.0f);
+        MeshBounds bounds{};
+    };
+
+    struct MeshFileTexture {
+        char name[256]{}; // Diffuse texture file name of the material, empty if the material has none
+    };
+
+    //
+    // Final geometry of a model, ready to be copied into its vertex and index buffers.
+    //
+    // The vertex and index data point into either the memory mapped cooked mesh file or the bytes the mesh was just
+    // cooked into, which are kept alive by the geometry.
+    //
+    struct MeshGeometry {
+        MeshVertexFormat vertexFormat = MeshVertexFormat::Packed;
+        glm::mat4 dequantization = glm::mat4(1.0f);
+        MeshBounds bounds{};
+        std::vector<MeshLod> lods;
+        std::vector<std::string> textureNames; // By material index
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        const void* vertexData = nullptr;
+        uint64_t vertexDataSize = 0;
+        const void* indexData = nullptr;
+        uint64_t indexDataSize = 0;
+        std::shared_ptr<MappedFile> mappedFile = nullptr;
+        std::vector<char> bytes;
+    };
+
+    //
+    // Cooked mesh file (.blmesh) with the packed vertices, indices, levels of detail, bounds and texture names of a
+    // model, written the first time the model is imported.
+    //
+    // The file stores the hash of the source files it was cooked from, a file whose hash (or format version) doesn't
+    // match is ignored and the model is imported again.
+    //
+    class MeshFile {
+    public:
+        static constexpr uint32_t MAGIC = 0x534D4C42; // "BLMS"
+        static constexpr uint32_t VERSION = 2;
+        static constexpr uint64_t ALIGNMENT = 16;
+
+    public:
+        static std::vector<char> write(const MeshGeometry& geometry, uint64_t sourceHash);
+
+        // Points the geometry into the bytes, returns false if they are not a valid cooked mesh of the source
+        static bool read(const char* data, uint64_t size, uint64_t sourceHash, MeshGeometry* geometry);
+
+    private:
+        static uint64_t alignUp(uint64_t value);
+    };
+}
@@ -2,133 +2,636 @@
 #include "MeshManager.h"
 #include "graphics/VulkanImage.h"
 
+#include <chrono>
+#include <string_view>
+
 namespace Blink {
     MeshManager::MeshManager(const MeshManagerConfig& config) : config(config) {
-        createCommandPool();
-        createDescriptorPool();
+        bindless = config.bindlessTexturesEnabled && isBindlessSupported();
+        BL_LOG_INFO("Bindless textures [{}]", bindless ? "enabled" : "disabled");
+        createDescriptorAllocator();
         createDescriptorSetLayout();
+        createDescriptorUpdateTemplate();
         createTextureSampler();
+        if (bindless) {
+            createBindlessDescriptorSet();
+        }
         createPlaceholderTexture();
     }
 
     MeshManager::~MeshManager() {
+        // The preload tasks use the file system through this manager
+        for (const auto& [modelPath, geometryPreload] : geometryPreloads) {
+            geometryPreload->task.wait();
+        }
+        for (const auto& [path, imagePreload] : imagePreloads) {
+            imagePreload->task.wait();
+        }
+        if (bindless) {
+            destroyBindlessDescriptorSet();
+        }
         destroyTextureSampler();
+        destroyDescriptorUpdateTemplate();
         destroyDescriptorSetLayout();
-        destroyDescriptorPool();
-        destroyCommandPool();
+        destroyDescriptorAllocator();
     }
 
     VkDescriptorSetLayout MeshManager::getDescriptorSetLayout() const {
         return descriptorSetLayout;
     }
 
+    bool MeshManager::isBindless() const {
+        return bindless;
+    }
+
+    //
+    // Meshes are shared by all entities using the same model and textures, so the vertex and index buffers, textures
+    // and descriptor set of each unique mesh are only created and uploaded to the GPU once.
+    //
     std::shared_ptr<Mesh> MeshManager::getMesh(const MeshInfo& meshInfo) {
-        auto mesh = std::make_shared<Mesh>();
+        std::string meshKey = getMeshKey(meshInfo);
+        const auto iterator = meshCache.find(meshKey);
+        if (iterator != meshCache.end()) {
+            return iterator->second;
+        }
+        std::shared_ptr<MeshGeometry> geometry = getGeometry(meshInfo.modelPath);
+        std::vector<std::shared_ptr<VulkanImage>> textures;
+        for (const std::string& texturePath : getTexturePaths(meshInfo, *geometry)) {
+            textures.push_back(texturePath.empty() ? placeholderTexture : getTexture(texturePath));
+        }
+        std::shared_ptr<Mesh> mesh = createMesh(geometry, textures);
+        meshCache[meshKey] = mesh;
+        return mesh;
+    }
 
-        std::shared_ptr<ObjFile> objFile = getObjFile(meshInfo.modelPath);
+    //
+    // Load all meshes that are not cached yet in phases:
+    // 1. Collect the models that are not loaded yet
+    // 2. Map or cook the models on the worker threads
+    // 3. Collect the textures that are not loaded yet
+    // 4. Decode the textures on the worker threads
+    // 5. Create the textures and meshes, which records their uploads, and submit all uploads at once
+    //
+    // Only the phases that touch Vulkan or the caches run on the calling thread.
+    //
+    void MeshManager::loadMeshes(const std::vector<MeshInfo>& meshInfos) {
+        auto startTime = std::chrono::steady_clock::now();
 
-        if (const auto iterator = vertexAndIndexCache.find(meshInfo.modelPath); iterator != vertexAndIndexCache.end()) {
-            auto& [vertices, indices] = iterator->second;
-            mesh->vertices = vertices;
-            mesh->indices = indices;
-        } else {
-            processVerticesAndIndices(mesh, objFile);
-            vertexAndIndexCache[meshInfo.modelPath] = { mesh->vertices, mesh->indices };
+        std::map<std::string, MeshInfo> newMeshInfos;
+        std::set<std::string> newModelPaths;
+        for (const MeshInfo& meshInfo : meshInfos) {
+            std::string meshKey = getMeshKey(meshInfo);
+            if (meshCache.find(meshKey) != meshCache.end()) {
+                continue;
+            }
+            newMeshInfos.emplace(meshKey, meshInfo);
+            if (geometryCache.find(meshInfo.modelPath) == geometryCache.end()) {
+                newModelPaths.insert(meshInfo.modelPath);
+            }
+        }
+        if (newMeshInfos.empty()) {
+            return;
         }
 
-        VulkanVertexBufferConfig vertexBufferConfig{};
-        vertexBufferConfig.device = config.device;
-        vertexBufferConfig.commandPool = commandPool;
-        vertexBufferConfig.size = sizeof(mesh->vertices[0]) * mesh->vertices.size();
+        std::vector<std::string> modelPaths(newModelPaths.begin(), newModelPaths.end());
+        std::vector<std::shared_ptr<MeshGeometry>> geometries(modelPaths.size());
+        std::vector<std::future<void>> geometryTasks;
+        for (uint32_t i = 0; i < modelPaths.size(); i++) {
+            geometries[i] = takePreloadedGeometry(modelPaths[i]);
+            if (geometries[i] != nullptr) {
+                continue;
+            }
+            geometryTasks.push_back(config.threadPool->submit([this, &modelPaths, &geometries, i]() {
+                geometries[i] = loadGeometry(modelPaths[i]);
+            }));
+        }
+        // Rethrows errors from the worker threads
+        for (std::future<void>& geometryTask : geometryTasks) {
+            geometryTask.get();
+        }
+        for (uint32_t i = 0; i < modelPaths.size(); i++) {
+            geometryCache[modelPaths[i]] = geometries[i];
+        }
 
-        auto vertexBuffer = std::make_shared<VulkanVertexBuffer>(vertexBufferConfig);
-        vertexBuffer->setData((void*) mesh->vertices.data());
-        mesh->vertexBuffer = vertexBuffer;
+        // Keeps the textures used by the new meshes alive until the meshes have been created
+        std::map<std::string, std::shared_ptr<VulkanImage>> textures;
+        std::vector<std::string> texturePaths;
+        for (const auto& [meshKey, meshInfo] : newMeshInfos) {
+            for (const std::string& texturePath : getTexturePaths(meshInfo, *geometryCache[meshInfo.modelPath])) {
+                if (texturePath.empty()) {
+                    continue;
+                }
+                if (textures.find(texturePath) != textures.end()) {
+                    textureCacheStatistics.hits++;
+                    continue;
+                }
+                const auto iterator = textureCache.find(texturePath);
+                if (iterator != textureCache.end() && !iterator->second.expired()) {
+                    textures[texturePath] = iterator->second.lock();
+                    textureCacheStatistics.hits++;
+                    continue;
+                }
+                textures[texturePath] = nullptr;
+                texturePaths.push_back(texturePath);
+                textureCacheStatistics.misses++;
+            }
+        }
 
-        VulkanIndexBufferConfig indexBufferConfig{};
-        indexBufferConfig.device = config.device;
-        indexBufferConfig.commandPool = commandPool;
-        indexBufferConfig.size = sizeof(mesh->indices[0]) * mesh->indices.size();
+        std::vector<std::shared_ptr<ImageFile>> imageFiles(texturePaths.size());
+        std::vector<std::future<void>> imageTasks;
+        for (uint32_t i = 0; i < texturePaths.size(); i++) {
+            imageFiles[i] = takePreloadedImage(texturePaths[i]);
+            if (imageFiles[i] != nullptr) {
+                continue;
+            }
+            imageTasks.push_back(config.threadPool->submit([this, &texturePaths, &imageFiles, i]() {
+                imageFiles[i] = config.textureLoader->readTexture(texturePaths[i]);
+            }));
+        }
+        for (std::future<void>& imageTask : imageTasks) {
+            imageTask.get();
+        }
 
-        auto indexBuffer = std::make_shared<VulkanIndexBuffer>(indexBufferConfig);
-        indexBuffer->setData((void*) mesh->indices.data());
-        mesh->indexBuffer = indexBuffer;
+        for (uint32_t i = 0; i < texturePaths.size(); i++) {
+            std::shared_ptr<VulkanImage> texture = createTexture(imageFiles[i]);
+            textureCache[texturePaths[i]] = texture;
+            textures[texturePaths[i]] = texture;
+            imageFiles[i] = nullptr;
+        }
 
-        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
-        descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        descriptorSetAllocateInfo.descriptorPool = descriptorPool;
-        descriptorSetAllocateInfo.descriptorSetCount = 1;
-        descriptorSetAllocateInfo.pSetLayouts = &descriptorSetLayout;
+        for (const auto& [meshKey, meshInfo] : newMeshInfos) {
+            std::shared_ptr<MeshGeometry> geometry = geometryCache[meshInfo.modelPath];
+            std::vector<std::shared_ptr<VulkanImage>> meshTextures;
+            for (const std::string& texturePath : getTexturePaths(meshInfo, *geometry)) {
+                meshTextures.push_back(texturePath.empty() ? placeholderTexture : textures[texturePath]);
+            }
+            meshCache[meshKey] = createMesh(geometry, meshTextures);
+        }
+        config.uploadContext->flush();
 
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->allocateDescriptorSets(&descriptorSetAllocateInfo, &mesh->descriptorSet));
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+        BL_LOG_INFO(
+            "Loaded meshes [meshes: {}, models: {}, textures: {}, threads: {}] in [{:.2f} ms]",
+            newMeshInfos.size(),
+            modelPaths.size(),
+            texturePaths.size(),
+            config.threadPool->getThreadCount(),
+            duration.count()
+        );
+    }
 
-        for (uint32_t i = 0; i < MAX_TEXTURES_PER_MESH; ++i) {
-            std::string textureFilepath;
-            if (meshInfo.textureAtlasPath.size() > 0) {
-                textureFilepath = meshInfo.textureAtlasPath;
-            } else if (i < objFile->materials.size()) {
-                tinyobj::material_t& material = objFile->materials[i];
-                if (material.diffuse_texname.size() > 0) {
-                    textureFilepath = meshInfo.texturesDirectoryPath + "/" + material.diffuse_texname;
+    const TextureCacheStatistics& MeshManager::getTextureCacheStatistics() const {
+        return textureCacheStatistics;
+    }
+
+    void MeshManager::releaseUnusedTextures() {
+        retainedTextures.clear();
+        for (auto iterator = textureCache.begin(); iterator != textureCache.end();) {
+            if (iterator->second.expired()) {
+                iterator = textureCache.erase(iterator);
+            } else {
+                ++iterator;
+            }
+        }
+        // Elements of the texture array whose texture has been destroyed are reused for new textures
+        for (auto iterator = bindlessTextureIndices.begin(); iterator != bindlessTextureIndices.end();) {
+            if (bindlessTextures[iterator->second].expired()) {
+                freeBindlessTextureIndices.push_back(iterator->second);
+                iterator = bindlessTextureIndices.erase(iterator);
+            } else {
+                ++iterator;
+            }
+        }
+        BL_LOG_INFO("Texture cache [textures: {}, hits: {}, misses: {}]", textureCache.size(), textureCacheStatistics.hits, textureCacheStatistics.misses);
+    }
+
+    void MeshManager::clear() {
+        //
+        // The texture cache only holds weak references, which means that a texture is destroyed as soon as the last
+        // mesh using it is destroyed.
+        //
+        // Keep the textures of the scene being unloaded alive until the next scene has loaded its meshes
+        // (see releaseUnusedTextures) so that textures used by both scenes don't have to be uploaded again.
+        //
+        for (const auto& [path, texture] : textureCache) {
+            if (std::shared_ptr<VulkanImage> retainedTexture = texture.lock()) {
+                retainedTextures.push_back(retainedTexture);
+            }
+        }
+
+        meshCache.clear();
+        if (bindless) {
+            // The texture array keeps the retained textures, only the texture table ranges of the meshes are released
+            textureTableSize = 0;
+        } else {
+            // Frees the descriptor sets of the cached meshes, the pools are kept for the meshes of the next scene
+            descriptorAllocator->reset();
+        }
+    }
+
+    //
+    // Preloading loads the files of meshes ahead of time (e.g. for the next scene) without blocking the caller, which
+    // keeps rendering while the files are parsed and decoded on the worker threads. loadMeshes picks up the preloaded
+    // models and textures instead of loading them again, and only has to create the GPU resources.
+    //
+    // The texture paths of a mesh depend on the materials of its model, so its textures are only preloaded once its
+    // model has been preloaded.
+    //
+    void MeshManager::preloadMeshes(const std::vector<MeshInfo>& meshInfos) {
+        for (const MeshInfo& meshInfo : meshInfos) {
+            if (meshCache.find(getMeshKey(meshInfo)) != meshCache.end()) {
+                continue;
+            }
+            const std::string& modelPath = meshInfo.modelPath;
+            if (geometryCache.find(modelPath) == geometryCache.end() && geometryPreloads.find(modelPath) == geometryPreloads.end()) {
+                auto geometryPreload = std::make_shared<GeometryPreload>();
+                geometryPreload->task = config.threadPool->submit([this, geometryPreload, modelPath]() {
+                    geometryPreload->geometry = loadGeometry(modelPath);
+                });
+                geometryPreloads[modelPath] = geometryPreload;
+            }
+            preloadingMeshInfos.push_back(meshInfo);
+        }
+        updatePreloads();
+    }
+
+    bool MeshManager::updatePreloads() {
+        auto isReady = [](const std::future<void>& task) {
+            return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        };
+
+        for (auto iterator = preloadingMeshInfos.begin(); iterator != preloadingMeshInfos.end();) {
+            std::shared_ptr<MeshGeometry> geometry = nullptr;
+            if (const auto cachedGeometry = geometryCache.find(iterator->modelPath); cachedGeometry != geometryCache.end()) {
+                geometry = cachedGeometry->second;
+            } else if (const auto geometryPreload = geometryPreloads.find(iterator->modelPath); geometryPreload != geometryPreloads.end()) {
+                if (!isReady(geometryPreload->second->task)) {
+                    ++iterator;
+                    continue;
                 }
+                geometry = geometryPreload->second->geometry;
             }
 
-            std::shared_ptr<VulkanImage> texture = nullptr;
-            if (textureFilepath.size() == 0) {
-                texture = placeholderTexture;
-            } else {
-                std::shared_ptr<ImageFile> imageFile = getImageFile(textureFilepath);
-                texture = createTexture(imageFile);
+            // A failed preload is left for loadMeshes to rethrow
+            if (geometry != nullptr) {
+                for (const std::string& texturePath : getTexturePaths(*iterator, *geometry)) {
+                    if (texturePath.empty() || imagePreloads.find(texturePath) != imagePreloads.end()) {
+                        continue;
+                    }
+                    if (const auto texture = textureCache.find(texturePath); texture != textureCache.end() && !texture->second.expired()) {
+                        continue;
+                    }
+                    auto imagePreload = std::make_shared<ImagePreload>();
+                    imagePreload->task = config.threadPool->submit([this, imagePreload, texturePath]() {
+                        imagePreload->imageFile = config.textureLoader->readTexture(texturePath);
+                    });
+                    imagePreloads[texturePath] = imagePreload;
+                }
             }
-            mesh->textures.push_back(texture);
+            iterator = preloadingMeshInfos.erase(iterator);
+        }
+
+        if (!preloadingMeshInfos.empty()) {
+            return false;
+        }
+        for (const auto& [path, imagePreload] : imagePreloads) {
+            if (!isReady(imagePreload->task)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Waits for the preload if it is still running, returns nullptr if the model was not preloaded
+    std::shared_ptr<MeshGeometry> MeshManager::takePreloadedGeometry(const std::string& modelPath) {
+        const auto iterator = geometryPreloads.find(modelPath);
+        if (iterator == geometryPreloads.end()) {
+            return nullptr;
+        }
+        std::shared_ptr<GeometryPreload> geometryPreload = iterator->second;
+        geometryPreloads.erase(iterator);
+        // Rethrows errors from the worker thread
+        geometryPreload->task.get();
+        return geometryPreload->geometry;
+    }
 
-            VkDescriptorImageInfo descriptorImageInfo{};
-            descriptorImageInfo.imageLayout = texture->getImageLayout();
-            descriptorImageInfo.imageView = texture->getImageView();
-            descriptorImageInfo.sampler = textureSampler;
+    // Waits for the preload if it is still running, returns nullptr if the image was not preloaded
+    std::shared_ptr<ImageFile> MeshManager::takePreloadedImage(const std::string& path) {
+        const auto iterator = imagePreloads.find(path);
+        if (iterator == imagePreloads.end()) {
+            return nullptr;
+        }
+        std::shared_ptr<ImagePreload> imagePreload = iterator->second;
+        imagePreloads.erase(iterator);
+        imagePreload->task.get();
+        return imagePreload->imageFile;
+    }
 
-            VkWriteDescriptorSet descriptorWrite{};
-            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrite.dstSet = mesh->descriptorSet;
-            descriptorWrite.dstBinding = 0;
-            descriptorWrite.dstArrayElement = i;
-            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptorWrite.descriptorCount = 1;
-            descriptorWrite.pImageInfo = &descriptorImageInfo;
+    std::shared_ptr<Mesh> MeshManager::createMesh(const std::shared_ptr<MeshGeometry>& geometry, const std::vector<std::shared_ptr<VulkanImage>>& textures) {
+        auto mesh = std::make_shared<Mesh>();
+        mesh->lods = geometry->lods;
+        mesh->vertexFormat = geometry->vertexFormat;
+        mesh->dequantization = geometry->dequantization;
+        mesh->bounds = geometry->bounds;
+
+        createVertexBuffer(mesh, *geometry);
+        createIndexBuffer(mesh, *geometry);
 
-            config.device->updateDescriptorSets(1, &descriptorWrite);
+        mesh->textures = textures;
+        if (bindless) {
+            createTextureTableEntries(mesh);
+        } else {
+            createDescriptorSet(mesh);
         }
         return mesh;
     }
 
-    void MeshManager::clear() {
-        destroyDescriptorPool();
-        createDescriptorPool();
+    void MeshManager::createDescriptorSet(const std::shared_ptr<Mesh>& mesh) {
+        mesh->descriptorSet = descriptorAllocator->allocate(descriptorSetLayout);
+
+        std::vector<VkDescriptorImageInfo> descriptorImageInfos(MAX_TEXTURES_PER_MESH);
+        for (uint32_t i = 0; i < MAX_TEXTURES_PER_MESH; ++i) {
+            const std::shared_ptr<VulkanImage>& texture = mesh->textures[i];
+            // Textures are sampled once their uploads (and generated mip levels) have been submitted, which happens
+            // before the first frame that uses the descriptor set, so the tracked layout may still be a transfer layout
+            descriptorImageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            descriptorImageInfos[i].imageView = texture->getImageView();
+            descriptorImageInfos[i].sampler = textureSampler;
+        }
+
+        if (descriptorUpdateTemplate != nullptr) {
+            config.device->updateDescriptorSetWithTemplate(mesh->descriptorSet, descriptorUpdateTemplate, descriptorImageInfos.data());
+            return;
+        }
+
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = mesh->descriptorSet;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWrite.descriptorCount = MAX_TEXTURES_PER_MESH;
+        descriptorWrite.pImageInfo = descriptorImageInfos.data();
+
+        config.device->updateDescriptorSets(1, &descriptorWrite);
     }
 
-    std::shared_ptr<ObjFile> MeshManager::getObjFile(const std::string& path) {
-        const auto iterator = objCache.find(path);
-        if (iterator != objCache.end()) {
-            return iterator->second;
+    //
+    // The texture table range of a mesh is written once and never moved, ranges are only released all at once when
+    // the meshes are cleared. The GPU may still be reading the ranges of other meshes while a range is written.
+    //
+    // The textures of the mesh that are not in the texture array yet are written to it with a single update.
+    //
+    void MeshManager::createTextureTableEntries(const std::shared_ptr<Mesh>& mesh) {
+        if (textureTableSize + mesh->textures.size() > MAX_TEXTURE_TABLE_ENTRIES) {
+            BL_THROW("Could not fit textures of mesh into texture table");
+        }
+        auto textureTable = (uint32_t*) textureTableBuffer->getMappedData();
+        mesh->textureTableOffset = textureTableSize;
+
+        std::vector<VkDescriptorImageInfo> descriptorImageInfos;
+        std::vector<uint32_t> arrayElements;
+        descriptorImageInfos.reserve(mesh->textures.size());
+        for (const std::shared_ptr<VulkanImage>& texture : mesh->textures) {
+            uint32_t textureIndex;
+            if (assignBindlessTextureIndex(texture, &textureIndex)) {
+                VkDescriptorImageInfo descriptorImageInfo{};
+                descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; // See createDescriptorSet
+                descriptorImageInfo.imageView = texture->getImageView();
+                descriptorImageInfo.sampler = textureSampler;
+                descriptorImageInfos.push_back(descriptorImageInfo);
+                arrayElements.push_back(textureIndex);
+            }
+            textureTable[textureTableSize++] = textureIndex;
+        }
+        mesh->descriptorSet = bindlessDescriptorSet;
+
+        std::vector<VkWriteDescriptorSet> descriptorWrites(descriptorImageInfos.size());
+        for (uint32_t i = 0; i < descriptorWrites.size(); i++) {
+            descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrites[i].dstSet = bindlessDescriptorSet;
+            descriptorWrites[i].dstBinding = 0;
+            descriptorWrites[i].dstArrayElement = arrayElements[i];
+            descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            descriptorWrites[i].descriptorCount = 1;
+            descriptorWrites[i].pImageInfo = &descriptorImageInfos[i];
+        }
+        if (!descriptorWrites.empty()) {
+            config.device->updateDescriptorSets((uint32_t) descriptorWrites.size(), descriptorWrites.data());
+        }
+    }
+
+    //
+    // Every texture is written to the texture array once and keeps its element for as long as it is alive. Elements of
+    // destroyed textures are updated while the descriptor set is bound, which is allowed because no draw in flight can
+    // use them anymore.
+    //
+    // Returns true if the texture got a new element, which has to be written.
+    //
+    bool MeshManager::assignBindlessTextureIndex(const std::shared_ptr<VulkanImage>& texture, uint32_t* textureIndex) {
+        if (const auto iterator = bindlessTextureIndices.find(texture.get()); iterator != bindlessTextureIndices.end()) {
+            *textureIndex = iterator->second;
+            if (bindlessTextures[*textureIndex].lock() == texture) {
+                return false;
+            }
+            // A destroyed texture that has not been released yet and happened to live at the same address
+        } else if (!freeBindlessTextureIndices.empty()) {
+            *textureIndex = freeBindlessTextureIndices.back();
+            freeBindlessTextureIndices.pop_back();
+        } else if (bindlessTextures.size() < MAX_BINDLESS_TEXTURES) {
+            *textureIndex = (uint32_t) bindlessTextures.size();
+            bindlessTextures.emplace_back();
+        } else {
+            BL_THROW("Could not fit texture into texture array");
+        }
+        bindlessTextures[*textureIndex] = texture;
+        bindlessTextureIndices[texture.get()] = *textureIndex;
+        return true;
+    }
+
+    bool MeshManager::isBindlessSupported() const {
+        VulkanPhysicalDevice* physicalDevice = config.device->getPhysicalDevice();
+        if (!physicalDevice->hasExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+            return false;
+        }
+        const VkPhysicalDeviceDescriptorIndexingFeatures& features = physicalDevice->getDescriptorIndexingFeatures();
+        const VkPhysicalDeviceDescriptorIndexingProperties& properties = physicalDevice->getDescriptorIndexingProperties();
+        return features.runtimeDescriptorArray
+               && features.shaderSampledImageArrayNonUniformIndexing
+               && features.descriptorBindingPartiallyBound
+               && features.descriptorBindingSampledImageUpdateAfterBind
+               && features.descriptorBindingUpdateUnusedWhilePending
+               && properties.maxDescriptorSetUpdateAfterBindSamplers >= MAX_BINDLESS_TEXTURES
+               && properties.maxDescriptorSetUpdateAfterBindSampledImages >= MAX_BINDLESS_TEXTURES
+               && properties.maxPerStageDescriptorUpdateAfterBindSamplers >= MAX_BINDLESS_TEXTURES
+               && properties.maxPerStageDescriptorUpdateAfterBindSampledImages >= MAX_BINDLESS_TEXTURES
+               && properties.maxPerStageUpdateAfterBindResources > MAX_BINDLESS_TEXTURES;
+    }
+
+    std::string MeshManager::getMeshKey(const MeshInfo& meshInfo) const {
+        return meshInfo.modelPath + "|" + meshInfo.textureAtlasPath + "|" + meshInfo.texturesDirectoryPath;
+    }
+
+    //
+    // Texture file of every texture slot of the mesh, empty for the slots that use the placeholder texture.
+    //
+    // Meshes with bindless textures only have a slot per material of their model, instead of a fixed number of slots.
+    //
+    std::vector<std::string> MeshManager::getTexturePaths(const MeshInfo& meshInfo, const MeshGeometry& geometry) const {
+        uint32_t textureSlotCount = bindless ? std::max((uint32_t) geometry.textureNames.size(), 1u) : MAX_TEXTURES_PER_MESH;
+        std::vector<std::string> texturePaths(textureSlotCount);
+        for (uint32_t i = 0; i < textureSlotCount; ++i) {
+            if (meshInfo.textureAtlasPath.size() > 0) {
+                texturePaths[i] = meshInfo.textureAtlasPath;
+            } else if (i < geometry.textureNames.size()) {
+                const std::string& textureName = geometry.textureNames[i];
+                if (textureName.size() > 0) {
+                    texturePaths[i] = meshInfo.texturesDirectoryPath + "/" + textureName;
+                }
+            }
         }
-        std::shared_ptr<ObjFile> objFile = config.fileSystem->readObj(path);
-        objCache[path] = objFile;
-        return objFile;
+        return texturePaths;
     }
 
-    std::shared_ptr<ImageFile> MeshManager::getImageFile(const std::string& path) {
-        const auto iterator = imageCache.find(path);
-        if (iterator != imageCache.end()) {
+    //
+    // Get the cooked geometry of a model, cooking it first if its cooked mesh file is missing or out of date.
+    //
+    // The cooked mesh file is memory mapped, which means that its vertex and index data is copied straight from the
+    // file into staging memory without being parsed.
+    //
+    std::shared_ptr<MeshGeometry> MeshManager::getGeometry(const std::string& modelPath) {
+        if (const auto iterator = geometryCache.find(modelPath); iterator != geometryCache.end()) {
             return iterator->second;
         }
-        std::shared_ptr<ImageFile> imageFile = config.fileSystem->readImage(path);
-        imageCache[path] = imageFile;
-        return imageFile;
+        std::shared_ptr<MeshGeometry> geometry = loadGeometry(modelPath);
+        geometryCache[modelPath] = geometry;
+        return geometry;
+    }
+
+    // Does not touch any of the caches, which makes it safe to call from the worker threads
+    std::shared_ptr<MeshGeometry> MeshManager::loadGeometry(const std::string& modelPath) const {
+        uint64_t sourceHash = hashSourceFiles(modelPath);
+        std::string meshFilePath = getMeshFilePath(modelPath);
+
+        if (config.fileSystem->exists(meshFilePath)) {
+            auto geometry = std::make_shared<MeshGeometry>();
+            geometry->mappedFile = config.fileSystem->mapFile(meshFilePath);
+            if (MeshFile::read(geometry->mappedFile->getData(), geometry->mappedFile->getSize(), sourceHash, geometry.get())) {
+                BL_LOG_DEBUG("Loaded cooked mesh [{}]", meshFilePath);
+                return geometry;
+            }
+            BL_LOG_INFO("Discarding outdated cooked mesh [{}]", meshFilePath);
+        }
+
+        return cookGeometry(modelPath, sourceHash);
+    }
+
+    // Import the model from its OBJ file and write the result to its cooked mesh file
+    std::shared_ptr<MeshGeometry> MeshManager::cookGeometry(const std::string& modelPath, uint64_t sourceHash) const {
+        std::shared_ptr<ObjFile> objFile = config.fileSystem->readObj(modelPath);
+
+        ImportedMesh importedMesh{};
+        processVerticesAndIndices(objFile, &importedMesh);
+        generateLods(&importedMesh);
+        optimizeMesh(&importedMesh);
+
+        MeshGeometry importedGeometry{};
+        importedGeometry.bounds = calculateBounds(importedMesh.vertices);
+        importedGeometry.lods = importedMesh.lods;
+        for (uint32_t i = 0; i < objFile->materials.size() && i < MAX_MATERIALS; i++) {
+            importedGeometry.textureNames.push_back(objFile->materials[i].diffuse_texname);
+        }
+        std::vector<char> vertexData = packVertices(importedMesh.vertices, &importedGeometry);
+        std::vector<char> indexData = packIndices(importedMesh.indices, (uint32_t) importedMesh.vertices.size(), &importedGeometry);
+        importedGeometry.vertexCount = (uint32_t) importedMesh.vertices.size();
+        importedGeometry.indexCount = (uint32_t) importedMesh.indices.size();
+        importedGeometry.vertexData = vertexData.data();
+        importedGeometry.vertexDataSize = vertexData.size();
+        importedGeometry.indexData = indexData.data();
+        importedGeometry.indexDataSize = indexData.size();
+
+        auto geometry = std::make_shared<MeshGeometry>();
+        geometry->bytes = MeshFile::write(importedGeometry, sourceHash);
+
+        // The geometry points into the written bytes, which are only saved if they can be read back
+        std::string meshFilePath = getMeshFilePath(modelPath);
+        if (!MeshFile::read(geometry->bytes.data(), geometry->bytes.size(), sourceHash, geometry.get())) {
+            BL_LOG_ERROR("Could not read back cooked mesh [{}], data [{} bytes]", meshFilePath, geometry->bytes.size());
+            BL_THROW("Could not cook mesh");
+        }
+        try {
+            config.fileSystem->writeBytes(meshFilePath, geometry->bytes);
+            BL_LOG_INFO("Cooked mesh [{}], data [{} bytes]", meshFilePath, geometry->bytes.size());
+        } catch (const Error& e) {
+            BL_LOG_WARN("Could not save cooked mesh [{}]: {}", meshFilePath, e.what());
+        }
+        return geometry;
+    }
+
+    // Hash of the OBJ file and the MTL files it references, which are everything a cooked mesh is cooked from
+    uint64_t MeshManager::hashSourceFiles(const std::string& modelPath) const {
+        std::shared_ptr<MappedFile> objFile = config.fileSystem->mapFile(modelPath);
+        uint64_t hash = hashFnv1a(objFile->getData(), objFile->getSize());
+
+        // MTL files are located relative to the OBJ file
+        std::string directoryPath = modelPath.substr(0, modelPath.find_last_of('/') + 1);
+        std::string_view text(objFile->getData(), objFile->getSize());
+        constexpr std::string_view keyword = "mtllib";
+        for (size_t position = text.find(keyword); position != std::string_view::npos; position = text.find(keyword, position + keyword.size())) {
+            if (position > 0 && text[position - 1] != '\n') {
+                continue;
+            }
+            size_t lineEnd = std::min(text.find('\n', position), text.size());
+            size_t nameStart = text.find_first_not_of(" \t", position + keyword.size());
+            if (nameStart == std::string_view::npos || nameStart >= lineEnd) {
+                continue;
+            }
+            // Trailing whitespace, including the carriage return of CRLF line endings, is not part of the name
+            size_t nameEnd = text.find_last_not_of(" \t\r", lineEnd - 1) + 1;
+            if (nameEnd <= nameStart) {
+                continue;
+            }
+            std::string mtlFilePath = directoryPath + std::string(text.substr(nameStart, nameEnd - nameStart));
+            if (config.fileSystem->exists(mtlFilePath)) {
+                std::shared_ptr<MappedFile> mtlFile = config.fileSystem->mapFile(mtlFilePath);
+                hash = hashFnv1a(mtlFile->getData(), mtlFile->getSize(), hash);
+            }
+        }
+        return hash;
+    }
+
+    // The cooked mesh file is written next to the OBJ file
+    std::string MeshManager::getMeshFilePath(const std::string& modelPath) {
+        return modelPath.substr(0, modelPath.find_last_of('.')) + ".blmesh";
     }
 
-    void MeshManager::processVerticesAndIndices(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<ObjFile>& objFile) const {
+    std::shared_ptr<VulkanImage> MeshManager::getTexture(const std::string& path) {
+        const auto iterator = textureCache.find(path);
+        if (iterator != textureCache.end()) {
+            if (std::shared_ptr<VulkanImage> texture = iterator->second.lock()) {
+                textureCacheStatistics.hits++;
+                return texture;
+            }
+        }
+        textureCacheStatistics.misses++;
+        std::shared_ptr<ImageFile> imageFile = config.textureLoader->readTexture(path);
+        std::shared_ptr<VulkanImage> texture = createTexture(imageFile);
+        textureCache[path] = texture;
+        return texture;
+    }
+
+    void MeshManager::processVerticesAndIndices(const std::shared_ptr<ObjFile>& objFile, ImportedMesh* importedMesh) {
+        auto startTime = std::chrono::steady_clock::now();
+
+        // Every face corner is at most one unique vertex
+        uint32_t cornerCount = 0;
+        for (const tinyobj::shape_t& shape : objFile->shapes) {
+            cornerCount += (uint32_t) shape.mesh.indices.size();
+        }
+        importedMesh->indices.reserve(cornerCount);
+
         // Ensure that duplicate vertices are not added to the mesh for optimization purposes
-        std::unordered_map<MeshVertex, uint32_t> indicesByUniqueVertices{};
+        MeshVertexDeduplicator vertexDeduplicator(&importedMesh->vertices, cornerCount);
 
         // Shapes of the model
         for (uint32_t s = 0; s < objFile->shapes.size(); s++) {
@@ -158,6 +661,14 @@ namespace Blink {
                         objFile->attrib.texcoords[2 * index.texcoord_index + 0],
                         1.0f - objFile->attrib.texcoords[2 * index.texcoord_index + 1]
                     };
+                    // tinyobjloader defaults vertex colors to white when the file has none
+                    if (3 * index.vertex_index + 2 < objFile->attrib.colors.size()) {
+                        vertex.color = {
+                            objFile->attrib.colors[3 * index.vertex_index + 0],
+                            objFile->attrib.colors[3 * index.vertex_index + 1],
+                            objFile->attrib.colors[3 * index.vertex_index + 2]
+                        };
+                    }
 
                     //
                     // When loading a mesh from a file, there is a lot of duplicated vertex data because many vertices
@@ -166,83 +677,263 @@ namespace Blink {
                     // As a performance improvement, we want to only use the unique vertices and use the index buffer
                     // to reuse them whenever they come up.
                     //
-                    // To achieve this, we keep track of the unique vertices and respective indices in a map
-                    // as [vertex: index]
+                    // To achieve this, we keep track of the unique vertices and their indices in a hash table
                     //
                     // For every vertex in the file, we check if we've already seen a vertex with the exact same
-                    // position and texture coordinates before. If we haven't, we add the vertex and index to the map
+                    // position, color and texture coordinates before. If we haven't, it is added as a new vertex
                     //
                     // This approach makes the vertices vector of each mesh significantly shorter while still keeping
                     // enough vertices and indices to correctly draw the mesh
                     //
-                    if (indicesByUniqueVertices.count(vertex) == 0) {
-                        indicesByUniqueVertices[vertex] = (uint32_t) mesh->vertices.size();
-                        mesh->vertices.push_back(vertex);
-                    }
-                    mesh->indices.push_back(indicesByUniqueVertices[vertex]);
+                    importedMesh->indices.push_back(vertexDeduplicator.getIndex(vertex));
                 }
                 indexOffset += vertexCountPerFace;
             }
         }
+
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+        BL_LOG_DEBUG("Processed vertices [corners: {}, unique vertices: {}] in [{:.2f} ms]", cornerCount, importedMesh->vertices.size(), duration.count());
+    }
+
+    MeshBounds MeshManager::calculateBounds(const std::vector<MeshVertex>& vertices) {
+        MeshBounds bounds{};
+        if (vertices.empty()) {
+            return bounds;
+        }
+        bounds.min = vertices[0].position;
+        bounds.max = vertices[0].position;
+        for (const MeshVertex& vertex : vertices) {
+            bounds.min = glm::min(bounds.min, vertex.position);
+            bounds.max = glm::max(bounds.max, vertex.position);
+        }
+        // Sphere around the center of the AABB, which is not the tightest fit but cheap and good enough for culling
+        bounds.center = (bounds.min + bounds.max) * 0.5f;
+        for (const MeshVertex& vertex : vertices) {
+            bounds.radius = std::max(bounds.radius, glm::length(vertex.position - bounds.center));
+        }
+        return bounds;
+    }
+
+    //
+    // Pack the vertices into the format they are uploaded in.
+    //
+    // Positions are quantized relative to the mesh's AABB, the dequantization matrix that maps them back is applied
+    // to the model matrix of every instance. Vertex colors are only stored if the model has any.
+    //
+    std::vector<char> MeshManager::packVertices(const std::vector<MeshVertex>& vertices, MeshGeometry* geometry) {
+        bool hasVertexColors = std::any_of(vertices.begin(), vertices.end(), [](const MeshVertex& vertex) {
+            return vertex.color != glm::vec3(1.0f, 1.0f, 1.0f);
+        });
+        geometry->vertexFormat = hasVertexColors ? MeshVertexFormat::PackedColor : MeshVertexFormat::Packed;
+
+        // Flat meshes have no extent along at least one axis
+        glm::vec3 positionMin = geometry->bounds.min;
+        glm::vec3 positionScale = glm::max(geometry->bounds.max - geometry->bounds.min, glm::vec3(std::numeric_limits<float>::epsilon()));
+        geometry->dequantization = glm::scale(glm::translate(glm::mat4(1.0f), positionMin), positionScale);
+
+        uint32_t vertexSize = PackedMeshVertex::getSize(geometry->vertexFormat);
+        std::vector<char> packedVertices(vertexSize * vertices.size());
+        for (uint32_t i = 0; i < vertices.size(); i++) {
+            PackedMeshVertex packedVertex = PackedMeshVertex::pack(vertices[i], positionMin, positionScale);
+            memcpy(&packedVertices[i * vertexSize], &packedVertex, vertexSize);
+        }
+        return packedVertices;
+    }
+
+    // Meshes with at most 65536 vertices are indexed with 16-bit indices
+    std::vector<char> MeshManager::packIndices(const std::vector<uint32_t>& indices, uint32_t vertexCount, MeshGeometry* geometry) {
+        std::vector<char> packedIndices;
+        if (vertexCount <= std::numeric_limits<uint16_t>::max() + 1) {
+            geometry->indexType = VK_INDEX_TYPE_UINT16;
+            std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+            packedIndices.resize(sizeof(uint16_t) * shortIndices.size());
+            memcpy(packedIndices.data(), shortIndices.data(), packedIndices.size());
+        } else {
+            geometry->indexType = VK_INDEX_TYPE_UINT32;
+            packedIndices.resize(sizeof(uint32_t) * indices.size());
+            memcpy(packedIndices.data(), indices.data(), packedIndices.size());
+        }
+        return packedIndices;
+    }
+
+    void MeshManager::createVertexBuffer(const std::shared_ptr<Mesh>& mesh, const MeshGeometry& geometry) const {
+        VulkanVertexBufferConfig vertexBufferConfig{};
+        vertexBufferConfig.device = config.device;
+        vertexBufferConfig.uploadContext = config.uploadContext;
+        vertexBufferConfig.size = geometry.vertexDataSize;
+
+        auto vertexBuffer = std::make_shared<VulkanVertexBuffer>(vertexBufferConfig);
+        vertexBuffer->setData(geometry.vertexData);
+        mesh->vertexBuffer = vertexBuffer;
+    }
+
+    void MeshManager::createIndexBuffer(const std::shared_ptr<Mesh>& mesh, const MeshGeometry& geometry) const {
+        VulkanIndexBufferConfig indexBufferConfig{};
+        indexBufferConfig.device = config.device;
+        indexBufferConfig.uploadContext = config.uploadContext;
+        indexBufferConfig.size = geometry.indexDataSize;
+        indexBufferConfig.indexType = geometry.indexType;
+
+        auto indexBuffer = std::make_shared<VulkanIndexBuffer>(indexBufferConfig);
+        indexBuffer->setData(geometry.indexData);
+        mesh->indexBuffer = indexBuffer;
+    }
+
+    //
+    // Append simplified versions of the mesh's indices, each with about half the triangles of the previous level.
+    //
+    // Every level shares the vertex buffer of the full detail mesh and gets its own range of the index buffer, which
+    // means that selecting a level of detail only changes the indices a draw reads.
+    //
+    void MeshManager::generateLods(ImportedMesh* importedMesh) {
+        MeshLod baseLod{};
+        baseLod.firstIndex = 0;
+        baseLod.indexCount = (uint32_t) importedMesh->indices.size();
+        importedMesh->lods.push_back(baseLod);
+
+        std::vector<uint32_t> lodIndices = importedMesh->indices;
+        while (importedMesh->lods.size() < Mesh::MAX_LODS) {
+            auto targetIndexCount = (uint32_t) ((float) lodIndices.size() * LOD_REDUCTION) / 3 * 3;
+            // Levels are only selected for small screen sizes, so the error is bounded by the target count rather than a threshold
+            constexpr float maxError = std::numeric_limits<float>::max();
+            std::vector<uint32_t> simplifiedIndices = MeshSimplifier::simplify(importedMesh->vertices, lodIndices, targetIndexCount, maxError);
+            if (simplifiedIndices.empty() || (float) simplifiedIndices.size() > (float) lodIndices.size() * LOD_MIN_REDUCTION) {
+                break;
+            }
+            MeshLod lod{};
+            lod.firstIndex = (uint32_t) importedMesh->indices.size();
+            lod.indexCount = (uint32_t) simplifiedIndices.size();
+            importedMesh->lods.push_back(lod);
+            importedMesh->indices.insert(importedMesh->indices.end(), simplifiedIndices.begin(), simplifiedIndices.end());
+            lodIndices = std::move(simplifiedIndices);
+        }
+
+        std::stringstream ss;
+        for (const MeshLod& lod : importedMesh->lods) {
+            ss << (ss.tellp() > 0 ? ", " : "") << lod.indexCount / 3;
+        }
+        BL_LOG_DEBUG("Generated levels of detail [triangles: {}]", ss.str());
+    }
+
+    //
+    // Reorder the triangles of every level of detail for the post-transform vertex cache and overdraw, then reorder
+    // the vertices by their first use in the index buffer.
+    //
+    // Runs once per model file, the optimized geometry is what ends up in the cooked mesh file.
+    //
+    void MeshManager::optimizeMesh(ImportedMesh* importedMesh) {
+        // The levels of detail are drawn separately, so their cache statistics are not combined
+        auto analyzeLods = [importedMesh]() {
+            std::vector<VertexCacheStatistics> lodStatistics;
+            for (const MeshLod& lod : importedMesh->lods) {
+                auto firstIndex = importedMesh->indices.begin() + lod.firstIndex;
+                std::vector<uint32_t> lodIndices(firstIndex, firstIndex + lod.indexCount);
+                lodStatistics.push_back(MeshOptimizer::analyzeVertexCache(lodIndices, (uint32_t) importedMesh->vertices.size()));
+            }
+            return lodStatistics;
+        };
+
+        auto vertexCount = (uint32_t) importedMesh->vertices.size();
+        std::vector<VertexCacheStatistics> statisticsBefore = analyzeLods();
+
+        for (const MeshLod& lod : importedMesh->lods) {
+            auto firstIndex = importedMesh->indices.begin() + lod.firstIndex;
+            std::vector<uint32_t> lodIndices(firstIndex, firstIndex + lod.indexCount);
+            lodIndices = MeshOptimizer::optimizeVertexCache(lodIndices, vertexCount);
+            lodIndices = MeshOptimizer::optimizeOverdraw(importedMesh->vertices, lodIndices);
+            std::copy(lodIndices.begin(), lodIndices.end(), firstIndex);
+        }
+        MeshOptimizer::optimizeVertexFetch(&importedMesh->vertices, &importedMesh->indices);
+
+        std::vector<VertexCacheStatistics> statisticsAfter = analyzeLods();
+        for (uint32_t i = 0; i < importedMesh->lods.size(); i++) {
+            BL_LOG_DEBUG(
+                "Optimized mesh LOD [{}] [ACMR: {:.3f} -> {:.3f}, ATVR: {:.3f} -> {:.3f}]",
+                i,
+                statisticsBefore[i].acmr,
+                statisticsAfter[i].acmr,
+                statisticsBefore[i].atvr,
+                statisticsAfter[i].atvr
+            );
+        }
     }
 
     std::shared_ptr<VulkanImage> MeshManager::createTexture(const std::shared_ptr<ImageFile>& imageFile) const {
         VulkanImageConfig textureConfig = {};
         textureConfig.device = config.device;
-        textureConfig.commandPool = commandPool;
         textureConfig.width = imageFile->width;
         textureConfig.height = imageFile->height;
-        textureConfig.format = VK_FORMAT_R8G8B8A8_SRGB;
-        textureConfig.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        textureConfig.format = imageFile->format;
+        textureConfig.mipLevels = config.uploadContext->getMipLevelCount(imageFile);
+        textureConfig.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
         textureConfig.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
         textureConfig.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
         auto texture = std::make_shared<VulkanImage>(textureConfig);
-        texture->setLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        texture->setData(imageFile);
-        texture->setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        config.uploadContext->uploadImage(texture.get(), imageFile);
         return texture;
     }
 
-    void MeshManager::createCommandPool() {
-        VulkanCommandPoolConfig commandPoolConfig{};
-        commandPoolConfig.device = config.device;
-        commandPool = new VulkanCommandPool(commandPoolConfig);
-    }
-
-    void MeshManager::destroyCommandPool() const {
-        delete commandPool;
-    }
-
-    void MeshManager::createDescriptorPool() {
-        VkDescriptorPoolSize descriptorPoolSize{};
-        descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorPoolSize.descriptorCount = MAX_TEXTURES;
-
-        VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
-        descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        descriptorPoolCreateInfo.poolSizeCount = 1;
-        descriptorPoolCreateInfo.pPoolSizes = &descriptorPoolSize;
-        descriptorPoolCreateInfo.maxSets = MAX_MESHES;
-
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorPool(&descriptorPoolCreateInfo, &descriptorPool));
+    void MeshManager::createDescriptorAllocator() {
+        VulkanDescriptorAllocatorConfig descriptorAllocatorConfig{};
+        descriptorAllocatorConfig.device = config.device;
+        if (bindless) {
+            descriptorAllocatorConfig.descriptorsPerSet = {
+                {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_BINDLESS_TEXTURES},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1}
+            };
+            descriptorAllocatorConfig.setsPerPool = 1;
+            descriptorAllocatorConfig.poolFlags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        } else {
+            descriptorAllocatorConfig.descriptorsPerSet = {
+                {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_TEXTURES_PER_MESH}
+            };
+            descriptorAllocatorConfig.setsPerPool = MESHES_PER_DESCRIPTOR_POOL;
+        }
+        descriptorAllocator = new VulkanDescriptorAllocator(descriptorAllocatorConfig);
     }
 
-    void MeshManager::destroyDescriptorPool() const {
-        config.device->destroyDescriptorPool(descriptorPool);
+    void MeshManager::destroyDescriptorAllocator() const {
+        delete descriptorAllocator;
     }
 
     void MeshManager::createDescriptorSetLayout() {
         VkDescriptorSetLayoutBinding textureSamplerLayoutBinding{};
         textureSamplerLayoutBinding.binding = 0;
         textureSamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        textureSamplerLayoutBinding.descriptorCount = MAX_TEXTURES_PER_MESH;
+        textureSamplerLayoutBinding.descriptorCount = bindless ? MAX_BINDLESS_TEXTURES : MAX_TEXTURES_PER_MESH;
         textureSamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
 
+        VkDescriptorSetLayoutBinding textureTableLayoutBinding{};
+        textureTableLayoutBinding.binding = 1;
+        textureTableLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        textureTableLayoutBinding.descriptorCount = 1;
+        textureTableLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings = { textureSamplerLayoutBinding };
+        if (bindless) {
+            layoutBindings.push_back(textureTableLayoutBinding);
+        }
+
+        // Elements of the texture array that are not used by any mesh are never written
+        std::vector<VkDescriptorBindingFlags> bindingFlags = {
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+            0
+        };
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo{};
+        bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsCreateInfo.bindingCount = (uint32_t) bindingFlags.size();
+        bindingFlagsCreateInfo.pBindingFlags = bindingFlags.data();
+
         VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{};
         descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        descriptorSetLayoutCreateInfo.bindingCount = 1;
-        descriptorSetLayoutCreateInfo.pBindings = &textureSamplerLayoutBinding;
+        descriptorSetLayoutCreateInfo.bindingCount = (uint32_t) layoutBindings.size();
+        descriptorSetLayoutCreateInfo.pBindings = layoutBindings.data();
+        if (bindless) {
+            descriptorSetLayoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+            descriptorSetLayoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        }
 
         BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorSetLayout(&descriptorSetLayoutCreateInfo, &descriptorSetLayout));
     }
@@ -251,6 +942,68 @@ namespace Blink {
         config.device->destroyDescriptorSetLayout(descriptorSetLayout);
     }
 
+    // Writes the texture slots of a mesh from an array of MAX_TEXTURES_PER_MESH descriptor image infos
+    void MeshManager::createDescriptorUpdateTemplate() {
+        if (bindless || !config.device->hasDescriptorUpdateTemplates()) {
+            return;
+        }
+        VkDescriptorUpdateTemplateEntry templateEntry{};
+        templateEntry.dstBinding = 0;
+        templateEntry.dstArrayElement = 0;
+        templateEntry.descriptorCount = MAX_TEXTURES_PER_MESH;
+        templateEntry.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        templateEntry.offset = 0;
+        templateEntry.stride = sizeof(VkDescriptorImageInfo);
+
+        VkDescriptorUpdateTemplateCreateInfo templateCreateInfo{};
+        templateCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        templateCreateInfo.descriptorUpdateEntryCount = 1;
+        templateCreateInfo.pDescriptorUpdateEntries = &templateEntry;
+        templateCreateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        templateCreateInfo.descriptorSetLayout = descriptorSetLayout;
+
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorUpdateTemplate(&templateCreateInfo, &descriptorUpdateTemplate));
+    }
+
+    void MeshManager::destroyDescriptorUpdateTemplate() const {
+        if (descriptorUpdateTemplate != nullptr) {
+            config.device->destroyDescriptorUpdateTemplate(descriptorUpdateTemplate);
+        }
+    }
+
+    // The single descriptor set of every mesh with bindless textures, which is never reset
+    void MeshManager::createBindlessDescriptorSet() {
+        VulkanBufferConfig textureTableBufferConfig{};
+        textureTableBufferConfig.device = config.device;
+        textureTableBufferConfig.size = sizeof(uint32_t) * MAX_TEXTURE_TABLE_ENTRIES;
+        textureTableBufferConfig.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        textureTableBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        textureTableBuffer = new VulkanBuffer(textureTableBufferConfig);
+        BL_ASSERT_THROW(textureTableBuffer->getMappedData() != nullptr);
+
+        bindlessDescriptorSet = descriptorAllocator->allocate(descriptorSetLayout);
+
+        VkDescriptorBufferInfo descriptorBufferInfo{};
+        descriptorBufferInfo.buffer = *textureTableBuffer;
+        descriptorBufferInfo.offset = 0;
+        descriptorBufferInfo.range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = bindlessDescriptorSet;
+        descriptorWrite.dstBinding = 1;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &descriptorBufferInfo;
+
+        config.device->updateDescriptorSets(1, &descriptorWrite);
+    }
+
+    void MeshManager::destroyBindlessDescriptorSet() const {
+        delete textureTableBuffer;
+    }
+
     void MeshManager::createTextureSampler() {
         VulkanPhysicalDevice* physicalDevice = config.device->getPhysicalDevice();
         const VkPhysicalDeviceProperties& physicalDeviceProperties = physicalDevice->getProperties();
@@ -271,7 +1024,7 @@ namespace Blink {
         textureSamplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
         textureSamplerCreateInfo.mipLodBias = 0.0f;
         textureSamplerCreateInfo.minLod = 0.0f;
-        textureSamplerCreateInfo.maxLod = 0.0f;
+        textureSamplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE;
 
         BL_ASSERT_THROW_VK_SUCCESS(config.device->createSampler(&textureSamplerCreateInfo, &textureSampler));
     }
@@ -3,11 +3,19 @@
 #include "system/FileSystem.h"
 #include "system/ObjFile.h"
 #include "graphics/Mesh.h"
-#include "graphics/VulkanCommandPool.h"
+#include "graphics/MeshFile.h"
+#include "graphics/MeshOptimizer.h"
+#include "graphics/MeshSimplifier.h"
+#include "graphics/MeshVertexDeduplicator.h"
+#include "graphics/TextureLoader.h"
+#include "graphics/VulkanBuffer.h"
+#include "graphics/VulkanDescriptorAllocator.h"
 #include "graphics/VulkanDevice.h"
+#include "graphics/VulkanUploadContext.h"
 #include "graphics/VulkanVertexBuffer.h"
 #include "graphics/VulkanIndexBuffer.h"
 #include "graphics/VulkanImage.h"
+#include "system/ThreadPool.h"
 
 #include <vector>
 
@@ -18,27 +26,80 @@ namespace Blink {
         std::string texturesDirectoryPath; // Multiple texture files. Mutually exclusive with textureAtlasPath.
     };
 
+    struct TextureCacheStatistics {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+    };
+
+    // Geometry of a model while it is being imported from its OBJ file
+    struct ImportedMesh {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices; // Indices of all levels of detail, starting with the full detail mesh
+        std::vector<MeshLod> lods;
+    };
+
+    // Model being loaded on a worker thread ahead of the meshes that use it
+    struct GeometryPreload {
+        std::shared_ptr<MeshGeometry> geometry = nullptr;
+        std::future<void> task;
+    };
+
+    // Texture being decoded on a worker thread ahead of the meshes that use it
+    struct ImagePreload {
+        std::shared_ptr<ImageFile> imageFile = nullptr;
+        std::future<void> task;
+    };
+
     struct MeshManagerConfig {
         FileSystem* fileSystem = nullptr;
         VulkanDevice* device = nullptr;
+        VulkanUploadContext* uploadContext = nullptr;
+        ThreadPool* threadPool = nullptr;
+        TextureLoader* textureLoader = nullptr;
+        bool bindlessTexturesEnabled = true; // Only used if the device supports descriptor indexing
     };
 
+    //
+    // Meshes either have a descriptor set of their own with a fixed number of texture slots, or share a single
+    // descriptor set with bindless textures:
+    //
+    // - Binding 0 is a partially bound array of every texture used by a mesh, which is updated after being bound.
+    // - Binding 1 is the texture table, which maps the texture index of each vertex to the texture array. The texture
+    //   indices of a mesh's vertices are per material of its model, so every mesh gets a range of the table starting at
+    //   its texture table offset.
+    //
     class MeshManager {
     private:
-        static constexpr uint32_t MAX_MESHES = 1000;
+        static constexpr uint32_t MESHES_PER_DESCRIPTOR_POOL = 256;
         static constexpr uint32_t MAX_TEXTURES_PER_MESH = 16; // Must match fragment shader --> `uniform sampler2D textureSamplers[16];`
-        static constexpr uint32_t MAX_TEXTURES = MAX_MESHES * MAX_TEXTURES_PER_MESH;
+        static constexpr uint32_t MAX_MATERIALS = 256; // Texture index of PackedMeshVertex is a single byte
+        static constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096; // Must not exceed the size of the texture table
+        static constexpr uint32_t MAX_TEXTURE_TABLE_ENTRIES = 65536;
+        static constexpr float LOD_REDUCTION = 0.5f; // Target index count of each level relative to the previous level
+        static constexpr float LOD_MIN_REDUCTION = 0.8f; // Stop adding levels once simplification stops paying off
 
     private:
         MeshManagerConfig config;
-        std::map<std::string, std::pair<std::vector<MeshVertex>, std::vector<uint32_t>>> vertexAndIndexCache;
-        std::map<std::string, std::shared_ptr<ObjFile>> objCache;
-        std::map<std::string, std::shared_ptr<ImageFile>> imageCache;
-        VulkanCommandPool* commandPool = nullptr;
-        VkDescriptorPool descriptorPool = nullptr;
+        std::map<std::string, std::shared_ptr<Mesh>> meshCache;
+        std::map<std::string, std::shared_ptr<MeshGeometry>> geometryCache;
+        std::map<std::string, std::weak_ptr<VulkanImage>> textureCache;
+        std::vector<std::shared_ptr<VulkanImage>> retainedTextures;
+        TextureCacheStatistics textureCacheStatistics{};
+        std::map<std::string, std::shared_ptr<GeometryPreload>> geometryPreloads;
+        std::map<std::string, std::shared_ptr<ImagePreload>> imagePreloads;
+        std::vector<MeshInfo> preloadingMeshInfos; // Meshes whose textures are preloaded once their model is loaded
+        VulkanDescriptorAllocator* descriptorAllocator = nullptr;
         VkDescriptorSetLayout descriptorSetLayout = nullptr;
+        VkDescriptorUpdateTemplate descriptorUpdateTemplate = nullptr; // Writes all texture slots of a mesh at once
         VkSampler textureSampler = nullptr;
         std::shared_ptr<VulkanImage> placeholderTexture = nullptr;
+        bool bindless = false;
+        VkDescriptorSet bindlessDescriptorSet = nullptr;
+        VulkanBuffer* textureTableBuffer = nullptr;
+        uint32_t textureTableSize = 0;
+        std::vector<std::weak_ptr<VulkanImage>> bindlessTextures; // By element of the texture array
+        std::map<const VulkanImage*, uint32_t> bindlessTextureIndices;
+        std::vector<uint32_t> freeBindlessTextureIndices;
 
     public:
         explicit MeshManager(const MeshManagerConfig& config);
@@ -47,31 +108,91 @@ namespace Blink {
 
         VkDescriptorSetLayout getDescriptorSetLayout() const;
 
+        // True if meshes sample their textures through the texture table (see mesh_bindless.frag)
+        bool isBindless() const;
+
         std::shared_ptr<Mesh> getMesh(const MeshInfo& meshInfo);
 
+        // Loads the meshes that are not cached yet, parsing and decoding their files in parallel
+        void loadMeshes(const std::vector<MeshInfo>& meshInfos);
+
+        // Starts loading the files of the meshes in the background without blocking, see updatePreloads
+        void preloadMeshes(const std::vector<MeshInfo>& meshInfos);
+
+        // Starts preloading textures of meshes whose models have been loaded, returns true once all preloads are done
+        bool updatePreloads();
+
+        const TextureCacheStatistics& getTextureCacheStatistics() const;
+
+        void releaseUnusedTextures();
+
         void clear();
 
     private:
-        std::shared_ptr<ObjFile> getObjFile(const std::string& path);
+        std::shared_ptr<Mesh> createMesh(const std::shared_ptr<MeshGeometry>& geometry, const std::vector<std::shared_ptr<VulkanImage>>& textures);
 
-        std::shared_ptr<ImageFile> getImageFile(const std::string& path);
+        void createDescriptorSet(const std::shared_ptr<Mesh>& mesh);
 
-        void processVerticesAndIndices(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<ObjFile>& objFile) const;
+        void createTextureTableEntries(const std::shared_ptr<Mesh>& mesh);
 
-        std::shared_ptr<VulkanImage> createTexture(const std::shared_ptr<ImageFile>& imageFile) const;
+        bool assignBindlessTextureIndex(const std::shared_ptr<VulkanImage>& texture, uint32_t* textureIndex);
+
+        bool isBindlessSupported() const;
+
+        std::string getMeshKey(const MeshInfo& meshInfo) const;
+
+        std::vector<std::string> getTexturePaths(const MeshInfo& meshInfo, const MeshGeometry& geometry) const;
+
+        std::shared_ptr<MeshGeometry> getGeometry(const std::string& modelPath);
 
-        void createCommandPool();
+        std::shared_ptr<MeshGeometry> loadGeometry(const std::string& modelPath) const;
 
-        void destroyCommandPool() const;
+        std::shared_ptr<MeshGeometry> takePreloadedGeometry(const std::string& modelPath);
 
-        void createDescriptorPool();
+        std::shared_ptr<ImageFile> takePreloadedImage(const std::string& path);
 
-        void destroyDescriptorPool() const;
+        std::shared_ptr<MeshGeometry> cookGeometry(const std::string& modelPath, uint64_t sourceHash) const;
+
+        uint64_t hashSourceFiles(const std::string& modelPath) const;
+
+        static std::string getMeshFilePath(const std::string& modelPath);
+
+        std::shared_ptr<VulkanImage> getTexture(const std::string& path);
+
+        static void processVerticesAndIndices(const std::shared_ptr<ObjFile>& objFile, ImportedMesh* importedMesh);
+
+        static MeshBounds calculateBounds(const std::vector<MeshVertex>& vertices);
+
+        static void generateLods(ImportedMesh* importedMesh);
+
+        static void optimizeMesh(ImportedMesh* importedMesh);
+
+        static std::vector<char> packVertices(const std::vector<MeshVertex>& vertices, MeshGeometry* geometry);
+
+        static std::vector<char> packIndices(const std::vector<uint32_t>& indices, uint32_t vertexCount, MeshGeometry* geometry);
+
+        void createVertexBuffer(const std::shared_ptr<Mesh>& mesh, const MeshGeometry& geometry) const;
+
+        void createIndexBuffer(const std::shared_ptr<Mesh>& mesh, const MeshGeometry& geometry) const;
+
+        std::shared_ptr<VulkanImage> createTexture(const std::shared_ptr<ImageFile>& imageFile) const;
+
+        void createDescriptorAllocator();
+
+        void destroyDescriptorAllocator() const;
 
         void createDescriptorSetLayout();
 
         void destroyDescriptorSetLayout() const;
 
+        void createDescriptorUpdateTemplate();
+
+        void destroyDescriptorUpdateTemplate() const;
+
+        void createBindlessDescriptorSet();
+
+        void destroyBindlessDescriptorSet() const;
+
         void createTextureSampler();
 
         void destroyTextureSampler() const;
@@ -0,0 +1,314 @@
+#include "pch.h"
+#include "MeshOptimizer.h"
+
+namespace Blink {
+    //
+    // Greedily emit the triangle with the highest score, where the score of a triangle is the sum of the scores of its
+    // vertices.
+    //
+    // Vertices score higher the more recently they were used (they are likely still in the cache) and the fewer
+    // triangles they have left (finishing off vertices avoids having to bring them back into the cache later).
+    // After every emitted triangle only the scores of the vertices in the simulated cache and their triangles change,
+    // so the next triangle is picked from those. When none of them has triangles left, the next triangle that has not
+    // been emitted is picked instead.
+    //
+    std::vector<uint32_t> MeshOptimizer::optimizeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount) {
+        auto triangleCount = (uint32_t) indices.size() / 3;
+
+        // Triangles using each vertex, the first remainingValence[vertex] entries are the ones not yet emitted
+        std::vector<uint32_t> remainingValence(vertexCount, 0);
+        for (uint32_t index : indices) {
+            remainingValence[index]++;
+        }
+        std::vector<uint32_t> vertexTriangleOffsets(vertexCount + 1, 0);
+        for (uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+            vertexTriangleOffsets[vertex + 1] = vertexTriangleOffsets[vertex] + remainingValence[vertex];
+        }
+        std::vector<uint32_t> vertexTriangles(indices.size());
+        std::vector<uint32_t> vertexTriangleCounts(vertexCount, 0);
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+            for (uint32_t i = 0; i < 3; i++) {
+                uint32_t vertex = indices[triangle * 3 + i];
+                vertexTriangles[vertexTriangleOffsets[vertex] + vertexTriangleCounts[vertex]++] = triangle;
+            }
+        }
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+            vertexScores[vertex] = getVertexScore(-1, remainingValence[vertex]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        int64_t bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+            const uint32_t* triangleIndices = &indices[triangle * 3];
+            triangleScores[triangle] = vertexScores[triangleIndices[0]] + vertexScores[triangleIndices[1]] + vertexScores[triangleIndices[2]];
+            if (triangleScores[triangle] > bestScore) {
+                bestScore = triangleScores[triangle];
+                bestTriangle = triangle;
+            }
+        }
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> nextCache;
+        cache.reserve(CACHE_SIZE + 3);
+        nextCache.reserve(CACHE_SIZE + 3);
+
+        std::vector<uint32_t> optimizedIndices;
+        optimizedIndices.reserve(indices.size());
+        uint32_t nextUnemittedTriangle = 0;
+
+        while (optimizedIndices.size() < indices.size()) {
+            if (bestTriangle == -1) {
+                while (emitted[nextUnemittedTriangle]) {
+                    nextUnemittedTriangle++;
+                }
+                bestTriangle = nextUnemittedTriangle;
+            }
+            auto triangle = (uint32_t) bestTriangle;
+            const uint32_t* triangleIndices = &indices[triangle * 3];
+            emitted[triangle] = true;
+
+            // Emit the triangle and put its vertices at the front of the cache
+            nextCache.clear();
+            for (uint32_t i = 0; i < 3; i++) {
+                uint32_t vertex = triangleIndices[i];
+                optimizedIndices.push_back(vertex);
+                if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end()) {
+                    nextCache.push_back(vertex);
+                }
+
+                // Remove the triangle from the vertex's remaining triangles
+                uint32_t* triangles = &vertexTriangles[vertexTriangleOffsets[vertex]];
+                uint32_t* lastTriangle = triangles + remainingValence[vertex] - 1;
+                std::iter_swap(std::find(triangles, lastTriangle, triangle), lastTriangle);
+                remainingValence[vertex]--;
+            }
+            for (uint32_t vertex : cache) {
+                if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end()) {
+                    nextCache.push_back(vertex);
+                }
+            }
+
+            // Vertices pushed out of the cache still need their scores updated
+            for (uint32_t i = 0; i < nextCache.size(); i++) {
+                cachePositions[nextCache[i]] = i < CACHE_SIZE ? (int32_t) i : -1;
+            }
+            for (uint32_t vertex : nextCache) {
+                vertexScores[vertex] = getVertexScore(cachePositions[vertex], remainingValence[vertex]);
+            }
+
+            bestTriangle = -1;
+            bestScore = -1.0f;
+            for (uint32_t vertex : nextCache) {
+                const uint32_t* triangles = &vertexTriangles[vertexTriangleOffsets[vertex]];
+                for (uint32_t i = 0; i < remainingValence[vertex]; i++) {
+                    uint32_t adjacentTriangle = triangles[i];
+                    const uint32_t* adjacentIndices = &indices[adjacentTriangle * 3];
+                    float score = vertexScores[adjacentIndices[0]] + vertexScores[adjacentIndices[1]] + vertexScores[adjacentIndices[2]];
+                    triangleScores[adjacentTriangle] = score;
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestTriangle = adjacentTriangle;
+                    }
+                }
+            }
+
+            if (nextCache.size() > CACHE_SIZE) {
+                nextCache.resize(CACHE_SIZE);
+            }
+            std::swap(cache, nextCache);
+        }
+        return optimizedIndices;
+    }
+
+    //
+    // Split the triangles into clusters and sort the clusters so that the ones facing away from the center of the mesh
+    // are drawn first, they are the most likely to occlude the rest of the mesh.
+    //
+    // Clusters end where the vertex cache optimization had to start over (a triangle without any cached vertices),
+    // and are split further wherever the cache miss ratio of the part before the split is not worse than the cluster's
+    // own ratio times OVERDRAW_THRESHOLD. Reordering whole clusters keeps most of the vertex cache optimization intact.
+    //
+    std::vector<uint32_t> MeshOptimizer::optimizeOverdraw(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices) {
+        auto triangleCount = (uint32_t) indices.size() / 3;
+        if (triangleCount == 0) {
+            return indices;
+        }
+        std::vector<uint32_t> cacheMisses = getCacheMisses(indices, (uint32_t) vertices.size());
+
+        std::vector<uint32_t> hardBoundaries;
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+            if (triangle == 0 || cacheMisses[triangle] == 3) {
+                hardBoundaries.push_back(triangle);
+            }
+        }
+        hardBoundaries.push_back(triangleCount);
+
+        // The cache is simulated from scratch for every cluster, as its triangles may end up anywhere in the new order
+        std::vector<uint32_t> clusterOffsets;
+        std::vector<uint32_t> cacheTimestamps(vertices.size(), 0);
+        uint32_t timestamp = ANALYSIS_CACHE_SIZE + 1;
+        for (uint32_t i = 0; i + 1 < hardBoundaries.size(); i++) {
+            uint32_t start = hardBoundaries[i];
+            uint32_t end = hardBoundaries[i + 1];
+            uint32_t clusterMisses = 0;
+            for (uint32_t triangle = start; triangle < end; triangle++) {
+                clusterMisses += cacheMisses[triangle];
+            }
+            float threshold = OVERDRAW_THRESHOLD * (float) clusterMisses / (float) (end - start);
+
+            clusterOffsets.push_back(start);
+            timestamp += ANALYSIS_CACHE_SIZE + 1;
+            uint32_t misses = 0;
+            for (uint32_t triangle = start; triangle < end - 1; triangle++) {
+                for (uint32_t j = 0; j < 3; j++) {
+                    uint32_t vertex = indices[triangle * 3 + j];
+                    if (timestamp - cacheTimestamps[vertex] > ANALYSIS_CACHE_SIZE) {
+                        cacheTimestamps[vertex] = timestamp++;
+                        misses++;
+                    }
+                }
+                if ((float) misses / (float) (triangle - clusterOffsets.back() + 1) <= threshold) {
+                    clusterOffsets.push_back(triangle + 1);
+                    timestamp += ANALYSIS_CACHE_SIZE + 1;
+                    misses = 0;
+                }
+            }
+        }
+        clusterOffsets.push_back(triangleCount);
+
+        // Area weighted centroid of the mesh
+        std::vector<glm::vec3> triangleCentroids(triangleCount);
+        std::vector<glm::vec3> triangleNormals(triangleCount); // Length is twice the area of the triangle
+        glm::vec3 meshCentroid = {0.0f, 0.0f, 0.0f};
+        float meshArea = 0.0f;
+        for (uint32_t triangle = 0; triangle < triangleCount; triangle++) {
+            const glm::vec3& p0 = vertices[indices[triangle * 3 + 0]].position;
+            const glm::vec3& p1 = vertices[indices[triangle * 3 + 1]].position;
+            const glm::vec3& p2 = vertices[indices[triangle * 3 + 2]].position;
+            triangleCentroids[triangle] = (p0 + p1 + p2) / 3.0f;
+            triangleNormals[triangle] = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(triangleNormals[triangle]);
+            meshCentroid += triangleCentroids[triangle] * area;
+            meshArea += area;
+        }
+        if (meshArea > 0.0f) {
+            meshCentroid /= meshArea;
+        }
+
+        struct Cluster {
+            uint32_t firstTriangle = 0;
+            uint32_t triangleCount = 0;
+            float sortKey = 0.0f;
+        };
+        std::vector<Cluster> clusters;
+        for (uint32_t i = 0; i + 1 < clusterOffsets.size(); i++) {
+            Cluster cluster{};
+            cluster.firstTriangle = clusterOffsets[i];
+            cluster.triangleCount = clusterOffsets[i + 1] - clusterOffsets[i];
+
+            glm::vec3 clusterCentroid = {0.0f, 0.0f, 0.0f};
+            glm::vec3 clusterNormal = {0.0f, 0.0f, 0.0f};
+            float clusterArea = 0.0f;
+            for (uint32_t triangle = cluster.firstTriangle; triangle < cluster.firstTriangle + cluster.triangleCount; triangle++) {
+                float area = glm::length(triangleNormals[triangle]);
+                clusterCentroid += triangleCentroids[triangle] * area;
+                clusterNormal += triangleNormals[triangle];
+                clusterArea += area;
+            }
+            if (clusterArea > 0.0f && glm::length(clusterNormal) > 0.0f) {
+                clusterCentroid /= clusterArea;
+                cluster.sortKey = glm::dot(clusterCentroid - meshCentroid, glm::normalize(clusterNormal));
+            }
+            clusters.push_back(cluster);
+        }
+
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+            return a.sortKey > b.sortKey;
+        });
+
+        std::vector<uint32_t> optimizedIndices;
+        optimizedIndices.reserve(indices.size());
+        for (const Cluster& cluster : clusters) {
+            auto first = indices.begin() + cluster.firstTriangle * 3;
+            optimizedIndices.insert(optimizedIndices.end(), first, first + cluster.triangleCount * 3);
+        }
+        return optimizedIndices;
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(std::vector<MeshVertex>* vertices, std::vector<uint32_t>* indices) {
+        constexpr uint32_t unmapped = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> remap(vertices->size(), unmapped);
+        std::vector<MeshVertex> optimizedVertices;
+        optimizedVertices.reserve(vertices->size());
+        for (uint32_t& index : *indices) {
+            if (remap[index] == unmapped) {
+                remap[index] = (uint32_t) optimizedVertices.size();
+                optimizedVertices.push_back((*vertices)[index]);
+            }
+            index = remap[index];
+        }
+        *vertices = std::move(optimizedVertices);
+    }
+
+    VertexCacheStatistics MeshOptimizer::analyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount) {
+        VertexCacheStatistics statistics{};
+        if (indices.empty()) {
+            return statistics;
+        }
+        std::vector<uint32_t> cacheMisses = getCacheMisses(indices, vertexCount);
+        uint32_t misses = 0;
+        for (uint32_t triangleMisses : cacheMisses) {
+            misses += triangleMisses;
+        }
+        std::vector<bool> used(vertexCount, false);
+        uint32_t usedVertexCount = 0;
+        for (uint32_t index : indices) {
+            if (!used[index]) {
+                used[index] = true;
+                usedVertexCount++;
+            }
+        }
+        statistics.acmr = (float) misses / (float) cacheMisses.size();
+        statistics.atvr = (float) misses / (float) usedVertexCount;
+        return statistics;
+    }
+
+    // Forsyth's vertex score, -1 for vertices without remaining triangles
+    float MeshOptimizer::getVertexScore(int32_t cachePosition, uint32_t remainingValence) {
+        if (remainingValence == 0) {
+            return -1.0f;
+        }
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // The vertices of the last triangle get a fixed score to avoid favoring the triangle that was just emitted
+                score = LAST_TRIANGLE_SCORE;
+            } else {
+                float scale = 1.0f / (CACHE_SIZE - 3);
+                score = std::pow(1.0f - (float) (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+            }
+        }
+        score += VALENCE_BOOST_SCALE * std::pow((float) remainingValence, -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    // Number of vertices each triangle transforms with a FIFO post-transform cache of ANALYSIS_CACHE_SIZE vertices
+    std::vector<uint32_t> MeshOptimizer::getCacheMisses(const std::vector<uint32_t>& indices, uint32_t vertexCount) {
+        std::vector<uint32_t> cacheMisses(indices.size() / 3, 0);
+        std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+        uint32_t timestamp = ANALYSIS_CACHE_SIZE + 1;
+        for (uint32_t i = 0; i < cacheMisses.size() * 3; i++) {
+            uint32_t vertex = indices[i];
+            if (timestamp - cacheTimestamps[vertex] > ANALYSIS_CACHE_SIZE) {
+                cacheTimestamps[vertex] = timestamp++;
+                cacheMisses[i / 3]++;
+            }
+        }
+        return cacheMisses;
+    }
+}
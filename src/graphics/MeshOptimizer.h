@@ -0,0 +1,48 @@
+#pragma once
+
+#include "graphics/Mesh.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Blink {
+    struct VertexCacheStatistics {
+        float acmr = 0.0f; // Average cache miss ratio, transformed vertices per triangle (0.5 is optimal for large meshes)
+        float atvr = 0.0f; // Average transformed vertex ratio, transformed vertices per vertex (1.0 is optimal)
+    };
+
+    //
+    // Reorders the triangles and vertices of an indexed mesh to make better use of the GPU.
+    //
+    // Triangles are ordered to maximize hits in the post-transform vertex cache (Forsyth's linear-speed vertex cache
+    // optimization), clusters of the cache optimized triangles are then sorted to draw outward facing geometry first
+    // and reduce overdraw (Sander et al., Tipsify). Finally vertices are ordered by their first use so that the vertex
+    // fetches of a draw read the vertex buffer sequentially.
+    //
+    class MeshOptimizer {
+    private:
+        static constexpr uint32_t CACHE_SIZE = 32; // Cache size assumed by the vertex cache optimization
+        static constexpr float CACHE_DECAY_POWER = 1.5f;
+        static constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+        static constexpr float VALENCE_BOOST_SCALE = 2.0f;
+        static constexpr float VALENCE_BOOST_POWER = 0.5f;
+        static constexpr uint32_t ANALYSIS_CACHE_SIZE = 16; // FIFO cache size used to estimate ACMR and ATVR
+        static constexpr float OVERDRAW_THRESHOLD = 1.05f; // ACMR increase allowed when splitting clusters
+
+    public:
+        static std::vector<uint32_t> optimizeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+        // Expects indices that have been optimized for the vertex cache
+        static std::vector<uint32_t> optimizeOverdraw(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices);
+
+        // Reorders the vertices by their first use in the indices and remaps the indices, unused vertices are removed
+        static void optimizeVertexFetch(std::vector<MeshVertex>* vertices, std::vector<uint32_t>* indices);
+
+        static VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+    private:
+        static float getVertexScore(int32_t cachePosition, uint32_t remainingValence);
+
+        static std::vector<uint32_t> getCacheMisses(const std::vector<uint32_t>& indices, uint32_t vertexCount);
+    };
+}
@@ -0,0 +1,260 @@
+#include "pch.h"
+#include "MeshSimplifier.h"
+
+#include <queue>
+
+namespace Blink {
+    Quadric::Quadric(const glm::dvec4& plane, double weight) {
+        double a = plane.x;
+        double b = plane.y;
+        double c = plane.z;
+        double d = plane.w;
+        a2 = a * a * weight; ab = a * b * weight; ac = a * c * weight; ad = a * d * weight;
+        b2 = b * b * weight; bc = b * c * weight; bd = b * d * weight;
+        c2 = c * c * weight; cd = c * d * weight;
+        d2 = d * d * weight;
+    }
+
+    Quadric& Quadric::operator+=(const Quadric& other) {
+        a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+        b2 += other.b2; bc += other.bc; bd += other.bd;
+        c2 += other.c2; cd += other.cd;
+        d2 += other.d2;
+        return *this;
+    }
+
+    // v^T * Q * v with v = (x, y, z, 1)
+    double Quadric::getError(const glm::dvec3& point) const {
+        double x = point.x;
+        double y = point.y;
+        double z = point.z;
+        return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+               + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+               + c2 * z * z + 2 * cd * z
+               + d2;
+    }
+
+    bool EdgeCollapse::operator>(const EdgeCollapse& other) const {
+        return error > other.error;
+    }
+
+    std::vector<uint32_t> MeshSimplifier::simplify(
+        const std::vector<MeshVertex>& vertices,
+        const std::vector<uint32_t>& indices,
+        uint32_t targetIndexCount,
+        float maxError
+    ) {
+        uint32_t vertexCount = (uint32_t) vertices.size();
+        uint32_t triangleCount = (uint32_t) indices.size() / 3;
+        if (indices.size() <= targetIndexCount) {
+            return indices;
+        }
+
+        //
+        // Vertices are split on attribute seams, so collapses are decided on the unique positions instead. Every vertex
+        // gets a representative (the first vertex with the same position), and the simplification runs on the
+        // representatives only.
+        //
+        std::unordered_map<glm::vec3, uint32_t> representativesByPosition;
+        std::vector<uint32_t> representatives(vertexCount);
+        std::vector<bool> seamVertices(vertexCount, false);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            auto [iterator, inserted] = representativesByPosition.try_emplace(vertices[i].position, i);
+            representatives[i] = iterator->second;
+            if (!inserted) {
+                seamVertices[iterator->second] = true;
+            }
+        }
+
+        std::vector<glm::dvec3> positions(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            positions[i] = glm::dvec3(vertices[i].position);
+        }
+
+        std::vector<uint32_t> triangleIndices(indices.size());
+        for (uint32_t i = 0; i < indices.size(); i++) {
+            triangleIndices[i] = representatives[indices[i]];
+        }
+
+        // Vertex quadrics from the planes of adjacent triangles, weighted by triangle area
+        std::vector<Quadric> quadrics(vertexCount);
+        std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+        std::vector<bool> removedTriangles(triangleCount, false);
+        uint32_t liveTriangleCount = triangleCount;
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            uint32_t i0 = triangleIndices[t * 3 + 0];
+            uint32_t i1 = triangleIndices[t * 3 + 1];
+            uint32_t i2 = triangleIndices[t * 3 + 2];
+            if (i0 == i1 || i1 == i2 || i0 == i2) {
+                removedTriangles[t] = true;
+                liveTriangleCount--;
+                continue;
+            }
+            glm::dvec3 normal = glm::cross(positions[i1] - positions[i0], positions[i2] - positions[i0]);
+            double area = glm::length(normal);
+            if (area > 0.0) {
+                normal /= area;
+                Quadric quadric(glm::dvec4(normal, -glm::dot(normal, positions[i0])), area * 0.5);
+                quadrics[i0] += quadric;
+                quadrics[i1] += quadric;
+                quadrics[i2] += quadric;
+            }
+            vertexTriangles[i0].push_back(t);
+            vertexTriangles[i1].push_back(t);
+            vertexTriangles[i2].push_back(t);
+        }
+
+        // Edges used by a single triangle are borders, their vertices are locked
+        std::map<std::pair<uint32_t, uint32_t>, uint32_t> edgeTriangleCounts;
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            if (removedTriangles[t]) {
+                continue;
+            }
+            for (uint32_t e = 0; e < 3; e++) {
+                uint32_t a = triangleIndices[t * 3 + e];
+                uint32_t b = triangleIndices[t * 3 + (e + 1) % 3];
+                edgeTriangleCounts[{std::min(a, b), std::max(a, b)}]++;
+            }
+        }
+        std::vector<bool> lockedVertices(vertexCount, false);
+        for (const auto& [edge, count] : edgeTriangleCounts) {
+            if (count == 1) {
+                lockedVertices[edge.first] = true;
+                lockedVertices[edge.second] = true;
+            }
+        }
+
+        //
+        // Collapses are invalidated lazily, a collapse is stale if either of its vertices changed after it was queued.
+        //
+        // Seam vertices are neither removed nor merged into, since the triangles on each side of the seam need their
+        // own vertex. Every other representative is the only vertex at its position.
+        //
+        std::vector<uint32_t> versions(vertexCount, 0);
+        std::priority_queue<EdgeCollapse, std::vector<EdgeCollapse>, std::greater<>> collapses;
+        auto queueCollapse = [&](uint32_t from, uint32_t to) {
+            if (lockedVertices[from] || seamVertices[from] || seamVertices[to]) {
+                return;
+            }
+            Quadric quadric = quadrics[from];
+            quadric += quadrics[to];
+            EdgeCollapse collapse{};
+            collapse.error = quadric.getError(positions[to]);
+            collapse.from = from;
+            collapse.to = to;
+            collapse.fromVersion = versions[from];
+            collapse.toVersion = versions[to];
+            collapses.push(collapse);
+        };
+        for (const auto& [edge, count] : edgeTriangleCounts) {
+            queueCollapse(edge.first, edge.second);
+            queueCollapse(edge.second, edge.first);
+        }
+
+        uint32_t targetTriangleCount = targetIndexCount / 3;
+        while (liveTriangleCount > targetTriangleCount && !collapses.empty()) {
+            EdgeCollapse collapse = collapses.top();
+            collapses.pop();
+            if (collapse.fromVersion != versions[collapse.from] || collapse.toVersion != versions[collapse.to]) {
+                continue;
+            }
+            if (collapse.error > maxError) {
+                break;
+            }
+            uint32_t from = collapse.from;
+            uint32_t to = collapse.to;
+
+            // Reject collapses that would turn a remaining triangle inside out
+            bool rejected = false;
+            for (uint32_t t : vertexTriangles[from]) {
+                if (!removedTriangles[t] && flipsTriangle(positions, triangleIndices, t, from, to)) {
+                    rejected = true;
+                    break;
+                }
+            }
+            if (rejected) {
+                continue;
+            }
+
+            for (uint32_t t : vertexTriangles[from]) {
+                if (removedTriangles[t]) {
+                    continue;
+                }
+                uint32_t* triangle = &triangleIndices[t * 3];
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                    removedTriangles[t] = true;
+                    liveTriangleCount--;
+                    continue;
+                }
+                for (uint32_t i = 0; i < 3; i++) {
+                    if (triangle[i] == from) {
+                        triangle[i] = to;
+                    }
+                }
+                vertexTriangles[to].push_back(t);
+            }
+            vertexTriangles[from].clear();
+            quadrics[to] += quadrics[from];
+            versions[from]++;
+            versions[to]++;
+
+            // Queue the edges around the merged vertex with their new errors
+            std::set<uint32_t> neighbors;
+            for (uint32_t t : vertexTriangles[to]) {
+                if (removedTriangles[t]) {
+                    continue;
+                }
+                for (uint32_t i = 0; i < 3; i++) {
+                    uint32_t neighbor = triangleIndices[t * 3 + i];
+                    if (neighbor != to) {
+                        neighbors.insert(neighbor);
+                    }
+                }
+            }
+            for (uint32_t neighbor : neighbors) {
+                versions[neighbor]++;
+            }
+            for (uint32_t neighbor : neighbors) {
+                queueCollapse(to, neighbor);
+                queueCollapse(neighbor, to);
+            }
+        }
+
+        // Map the remaining triangles back to the original vertices, corners that were merged use the vertex they were merged into
+        std::vector<uint32_t> simplifiedIndices;
+        simplifiedIndices.reserve(liveTriangleCount * 3);
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            if (removedTriangles[t]) {
+                continue;
+            }
+            for (uint32_t i = 0; i < 3; i++) {
+                uint32_t originalIndex = indices[t * 3 + i];
+                uint32_t simplifiedIndex = triangleIndices[t * 3 + i];
+                simplifiedIndices.push_back(representatives[originalIndex] == simplifiedIndex ? originalIndex : simplifiedIndex);
+            }
+        }
+        return simplifiedIndices;
+    }
+
+    bool MeshSimplifier::flipsTriangle(
+        const std::vector<glm::dvec3>& positions,
+        const std::vector<uint32_t>& triangleIndices,
+        uint32_t triangle,
+        uint32_t from,
+        uint32_t to
+    ) {
+        const uint32_t* indices = &triangleIndices[triangle * 3];
+        if (indices[0] == to || indices[1] == to || indices[2] == to) {
+            return false; // Removed by the collapse
+        }
+        glm::dvec3 before[3];
+        glm::dvec3 after[3];
+        for (uint32_t i = 0; i < 3; i++) {
+            before[i] = positions[indices[i]];
+            after[i] = positions[indices[i] == from ? to : indices[i]];
+        }
+        glm::dvec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+        glm::dvec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+        return glm::dot(normalBefore, normalAfter) <= 0.0;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "graphics/Mesh.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Blink {
+    // Symmetric 4x4 matrix of the sum of squared distances to a set of planes (Garland & Heckbert)
+    struct Quadric {
+        double a2 = 0, ab = 0, ac = 0, ad = 0;
+        double b2 = 0, bc = 0, bd = 0;
+        double c2 = 0, cd = 0;
+        double d2 = 0;
+
+        Quadric() = default;
+
+        Quadric(const glm::dvec4& plane, double weight);
+
+        Quadric& operator+=(const Quadric& other);
+
+        double getError(const glm::dvec3& point) const;
+    };
+
+    struct EdgeCollapse {
+        double error = 0.0;
+        uint32_t from = 0; // Vertex that is removed
+        uint32_t to = 0; // Vertex that the removed vertex is merged into
+        uint32_t fromVersion = 0;
+        uint32_t toVersion = 0;
+
+        bool operator>(const EdgeCollapse& other) const;
+    };
+
+    //
+    // Reduces the triangle count of an indexed mesh with quadric error edge collapses.
+    //
+    // Edges are collapsed into one of their endpoints (half-edge collapses), which means that the simplified indices
+    // keep referencing the original vertices and every level of detail can share the vertex buffer of the base mesh.
+    //
+    // Vertices on open borders and on seams (where the OBJ importer splits vertices with different texture coordinates
+    // or textures) are never removed, which keeps the silhouette and the texture mapping from tearing apart.
+    //
+    class MeshSimplifier {
+    public:
+        // Returns at least targetIndexCount indices unless the error of the next collapse would exceed maxError
+        static std::vector<uint32_t> simplify(
+            const std::vector<MeshVertex>& vertices,
+            const std::vector<uint32_t>& indices,
+            uint32_t targetIndexCount,
+            float maxError
+        );
+
+    private:
+        static bool flipsTriangle(
+            const std::vector<glm::dvec3>& positions,
+            const std::vector<uint32_t>& triangleIndices,
+            uint32_t triangle,
+            uint32_t from,
+            uint32_t to
+        );
+    };
+}
@@ -0,0 +1,67 @@
+#include "pch.h"
+#include "MeshVertexDeduplicator.h"
+
+#include <cstring>
+
+namespace Blink {
+    MeshVertexDeduplicator::MeshVertexDeduplicator(std::vector<MeshVertex>* vertices, uint32_t maxVertexCount) : vertices(vertices) {
+        // At most half full
+        uint32_t tableSize = 1;
+        while (tableSize < maxVertexCount * 2) {
+            tableSize *= 2;
+        }
+        table.resize(tableSize, EMPTY);
+        mask = tableSize - 1;
+        vertices->reserve(vertices->size() + maxVertexCount);
+    }
+
+    uint32_t MeshVertexDeduplicator::getIndex(const MeshVertex& vertex) {
+        uint32_t slot = hash(vertex) & mask;
+        while (true) {
+            uint32_t index = table[slot];
+            if (index == EMPTY) {
+                index = (uint32_t) vertices->size();
+                vertices->push_back(vertex);
+                table[slot] = index;
+                return index;
+            }
+            if ((*vertices)[index] == vertex) {
+                return index;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    //
+    // Hash the bits of the vertex's components with a multiply and rotate per component (similar to xxHash's rounds).
+    //
+    // Adding 0.0f turns -0.0f into 0.0f, which compare equal but have different bits.
+    //
+    uint32_t MeshVertexDeduplicator::hash(const MeshVertex& vertex) {
+        const float components[] = {
+            vertex.position.x + 0.0f,
+            vertex.position.y + 0.0f,
+            vertex.position.z + 0.0f,
+            vertex.color.r + 0.0f,
+            vertex.color.g + 0.0f,
+            vertex.color.b + 0.0f,
+            vertex.textureCoordinate.x + 0.0f,
+            vertex.textureCoordinate.y + 0.0f,
+        };
+        constexpr uint32_t prime1 = 0x9E3779B1u;
+        constexpr uint32_t prime2 = 0x85EBCA77u;
+        uint32_t hash = vertex.textureIndex * prime1;
+        for (float component : components) {
+            uint32_t bits;
+            memcpy(&bits, &component, sizeof(bits));
+            hash ^= bits * prime2;
+            hash = (hash << 13) | (hash >> 19);
+            hash *= prime1;
+        }
+        // Final avalanche so that the low bits used for the slot depend on all bits
+        hash ^= hash >> 15;
+        hash *= prime2;
+        hash ^= hash >> 13;
+        return hash;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "graphics/Mesh.h"
+
+#include <limits>
+#include <vector>
+
+namespace Blink {
+    //
+    // Finds the index of a vertex among the unique vertices seen so far, or adds it as a new unique vertex.
+    //
+    // The unique vertices are indexed by an open addressing hash table with linear probing that stores indices into
+    // the vertex vector. The table is sized up front from the maximum number of vertices (the number of face corners
+    // in the model), so it never has to grow and every lookup-or-insert is a single probe sequence.
+    //
+    class MeshVertexDeduplicator {
+    private:
+        static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+        std::vector<MeshVertex>* vertices = nullptr;
+        std::vector<uint32_t> table;
+        uint32_t mask = 0;
+
+    public:
+        MeshVertexDeduplicator(std::vector<MeshVertex>* vertices, uint32_t maxVertexCount);
+
+        uint32_t getIndex(const MeshVertex& vertex);
+
+    private:
+        static uint32_t hash(const MeshVertex& vertex);
+    };
+}
@@ -3,24 +3,37 @@
 #include "VulkanImage.h"
 #include "window/KeyEvent.h"
 
+#include <chrono>
+#include <future>
+
 namespace Blink {
     Renderer::Renderer(const RendererConfig& config) : config(config) {
+        framePacing = config.framePacing;
+        framePacing.framesInFlight = std::clamp(framePacing.framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+        pendingFramePacing = framePacing;
+        frameInputTimes.fill(-1.0);
         createCommandObjects();
         createSwapChain();
-        createUniformBuffers();
+        createFrameDataBuffer();
         createDescriptorObjects();
+        createMeshCuller();
+        createGpuProfiler();
         createGraphicsPipelines();
     }
 
     Renderer::~Renderer() {
         destroyGraphicsPipelines();
+        destroyGpuProfiler();
+        destroyMeshCuller();
         destroyDescriptorObjects();
-        destroyUniformBuffers();
+        destroyFrameDataBuffer();
         destroySwapChain();
         destroyCommandObjects();
     }
 
     void Renderer::waitUntilIdle() const {
+        // Resources are usually destroyed after waiting, make sure that none of them have uploads pending
+        config.uploadContext->flush();
         BL_ASSERT_THROW_VK_SUCCESS(config.device->waitUntilIdle());
     }
 
@@ -29,25 +42,100 @@ namespace Blink {
             reloadShaders();
             return;
         }
+        if (event.type == EventType::KeyPressed && event.as<KeyPressedEvent>().key == Key::F11 && meshCuller != nullptr) {
+            gpuCullingEnabled = !gpuCullingEnabled;
+            BL_LOG_INFO("GPU culling [{}]", gpuCullingEnabled ? "enabled" : "disabled");
+            return;
+        }
+        // Cycle the frames in flight (F10), the present mode (Shift+F10) or the additional swap chain images (Ctrl+F10)
+        if (event.type == EventType::KeyPressed && event.as<KeyPressedEvent>().key == Key::F10) {
+            int32_t mods = event.as<KeyPressedEvent>().mods;
+            FramePacing nextFramePacing = pendingFramePacing;
+            if (mods & GLFW_MOD_SHIFT) {
+                auto iterator = std::find(PRESENT_MODES.begin(), PRESENT_MODES.end(), nextFramePacing.presentMode);
+                uint32_t index = iterator == PRESENT_MODES.end() ? 0 : (uint32_t) (iterator - PRESENT_MODES.begin()) + 1;
+                nextFramePacing.presentMode = PRESENT_MODES[index % PRESENT_MODES.size()];
+            } else if (mods & GLFW_MOD_CONTROL) {
+                nextFramePacing.additionalImageCount = (nextFramePacing.additionalImageCount + 1) % (MAX_ADDITIONAL_IMAGES + 1);
+            } else {
+                nextFramePacing.framesInFlight = nextFramePacing.framesInFlight % MAX_FRAMES_IN_FLIGHT + 1;
+            }
+            setFramePacing(nextFramePacing);
+            return;
+        }
         swapChain->onEvent(event);
     }
 
-    bool Renderer::beginFrame() {
+    const FramePacing& Renderer::getFramePacing() const {
+        return framePacing;
+    }
+
+    void Renderer::setFramePacing(const FramePacing& framePacing) {
+        pendingFramePacing = framePacing;
+        pendingFramePacing.framesInFlight = std::clamp(framePacing.framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+        framePacingChanged = true;
+    }
+
+    VkPresentModeKHR Renderer::getPresentMode() const {
+        return swapChain->getPresentMode();
+    }
+
+    //
+    // With several frames in flight the CPU only waits for a frame in beginFrame, after the input has been sampled, so
+    // the input can be several frames old by the time its frame is finished.
+    //
+    // With one frame in flight the CPU has to wait for the previous frame anyway, so it waits and acquires the next swap
+    // chain image here instead, which samples the input as late as possible and starts its frame right away.
+    //
+    void Renderer::waitForNextFrame() {
+        // The frame pacing changes while no swap chain image is acquired, since the swap chain may be recreated
+        if (framePacingChanged) {
+            applyFramePacing();
+        }
+        if (framePacing.framesInFlight == 1) {
+            swapChain->acquireImage(currentFrame);
+            updateInputLatencies();
+        }
+    }
+
+    bool Renderer::beginFrame(double inputTime) {
+        // Submit the uploads of resources created since the last frame before they are used for rendering
+        config.uploadContext->flush();
+
+        // The latency of the frame that last used the frame index is measured before its fence is reset
+        swapChain->waitForFrame(currentFrame);
+        updateInputLatencies();
         if (!swapChain->beginFrame(currentFrame)) {
             return false;
         }
+        frameInputTimes[currentFrame] = inputTime;
+        // The frame's fence has been waited on by the swap chain, so its region of the frame data buffer can be reused
+        frameDataBuffer->beginFrame(currentFrame);
         currentCommandBuffer = commandBuffers[currentFrame];
         BL_ASSERT_THROW_VK_SUCCESS(currentCommandBuffer.begin());
-        swapChain->beginRenderPass(currentCommandBuffer);
+        gpuProfiler->beginFrame(currentCommandBuffer, currentFrame);
+        gpuProfiler->beginPass(currentCommandBuffer, (uint32_t) GpuPass::Frame);
+
+        // The culling mode can only change between frames
+        gpuCullingActive = gpuCullingEnabled;
+        if (gpuCullingActive) {
+            meshCuller->beginFrame(currentFrame);
+        }
+
+        pipelineIds.clear();
+        descriptorSetIds.clear();
+        geometryIds.clear();
+        lodTriangles = {};
         return true;
     }
 
-    void Renderer::setViewProjection(const ViewProjection& viewProjection) const {
-        VulkanUniformBuffer* uniformBuffer = viewProjectionUniformBuffers[currentFrame];
-
+    void Renderer::setViewProjection(const ViewProjection& viewProjection) {
         ViewProjectionUniformBufferData uniformBufferData{};
         uniformBufferData.view = std::move(viewProjection.view);
         uniformBufferData.projection = std::move(viewProjection.projection);
+        view = viewProjection.view;
+        projection = viewProjection.projection;
+        viewProjectionMatrix = viewProjection.projection * viewProjection.view;
 
         // Flip the Y-axis to align with Vulkan's coordinate system to avoid the image being rendered upside down.
         //
@@ -78,108 +166,533 @@ namespace Blink {
         //
         uniformBufferData.projection[1][1] *= -1;
 
-        uniformBuffer->setData(&uniformBufferData);
+        VkDeviceSize minUniformBufferOffsetAlignment = config.device->getPhysicalDevice()->getProperties().limits.minUniformBufferOffsetAlignment;
+        viewProjectionOffset = (uint32_t) frameDataBuffer->write(&uniformBufferData, sizeof(ViewProjectionUniformBufferData), minUniformBufferOffsetAlignment);
     }
 
-    void Renderer::renderSkybox(const std::shared_ptr<Skybox>& skybox) const {
-        skyboxGraphicsPipeline->bind(currentCommandBuffer);
-        skybox->vertexBuffer->bind(currentCommandBuffer);
-        skybox->indexBuffer->bind(currentCommandBuffer);
+    void Renderer::renderSkybox(const std::shared_ptr<Skybox>& skybox) {
+        // Recorded before the meshes at the end of the frame
+        this->skybox = skybox;
+    }
 
-        std::array<VkDescriptorSet, 2> descriptorSets = {
-            this->viewProjectionDescriptorSets[currentFrame], // Per frame descriptor set
-            skybox->descriptorSet // Per mesh descriptor set
-        };
+    void Renderer::renderMesh(const std::shared_ptr<Mesh>& mesh, const glm::mat4& model, uint32_t lod) {
+        if (gpuCullingActive) {
+            return;
+        }
+        lod = std::min(lod, (uint32_t) mesh->lods.size() - 1);
+        lodTriangles[lod] += mesh->lods[lod].indexCount / 3;
+
+        // Defer the draw until the end of the frame so that draws can be sorted by the state they need
+        MeshInstance meshInstance{};
+        meshInstance.sortKey = getSortKey(getMeshGraphicsPipeline(mesh.get()), mesh.get(), lod, model);
+        meshInstance.mesh = mesh.get();
+        meshInstance.lod = lod;
+        meshInstance.model = model;
+        meshInstances.push_back(meshInstance);
+    }
+
+    void Renderer::setMeshLodSelection(float screenSize, float bias) {
+        lodScreenSize = screenSize;
+        lodBias = bias;
+    }
+
+    uint32_t Renderer::addMeshObject(const std::shared_ptr<Mesh>& mesh, const glm::mat4& model) {
+        BL_ASSERT(meshCuller != nullptr);
+        return meshCuller->addObject(mesh.get(), model);
+    }
+
+    void Renderer::updateMeshObject(uint32_t objectId, const glm::mat4& model) {
+        meshCuller->updateObject(objectId, model);
+    }
+
+    void Renderer::setMeshObjectEnabled(uint32_t objectId, bool enabled) {
+        meshCuller->setObjectEnabled(objectId, enabled);
+    }
+
+    void Renderer::clearMeshObjects() {
+        if (meshCuller != nullptr) {
+            meshCuller->clear();
+        }
+    }
 
-        constexpr uint32_t firstSet = 0;
-        constexpr uint32_t dynamicOffsetCount = 0;
-        constexpr uint32_t* dynamicOffsets = nullptr;
-        vkCmdBindDescriptorSets(
-            currentCommandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            skyboxGraphicsPipeline->getLayout(),
-            firstSet,
-            descriptorSets.size(),
-            descriptorSets.data(),
-            dynamicOffsetCount,
-            dynamicOffsets
+    void Renderer::endFrame() {
+        // The culling dispatch has to be recorded before the render pass begins
+        if (gpuCullingActive) {
+            prepareIndirectMeshDraws();
+        } else {
+            prepareMeshDraws();
+        }
+
+        // The primary command buffer only begins the render pass and executes the secondary command buffers
+        swapChain->beginRenderPass(currentCommandBuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        recordCommandBuffers();
+        swapChain->endRenderPass(currentCommandBuffer);
+        gpuProfiler->endPass(currentCommandBuffer, (uint32_t) GpuPass::Frame);
+        BL_ASSERT_THROW_VK_SUCCESS(currentCommandBuffer.end());
+        swapChain->endFrame(currentCommandBuffer);
+        uint64_t presentId = swapChain->getPresentId();
+        if (presentId != 0) {
+            if (pendingPresents.size() == MAX_PENDING_PRESENTS) {
+                pendingPresents.erase(pendingPresents.begin());
+            }
+            pendingPresents.push_back({presentId, frameInputTimes[currentFrame]});
+        }
+        currentFrame = (currentFrame + 1) % framePacing.framesInFlight;
+        meshInstances.clear();
+        meshDraws.clear();
+        skybox = nullptr;
+    }
+
+    const RendererStatistics& Renderer::getStatistics() const {
+        return statistics;
+    }
+
+    bool Renderer::isGpuCullingSupported() const {
+        return meshCuller != nullptr;
+    }
+
+    bool Renderer::isGpuCullingActive() const {
+        return gpuCullingActive;
+    }
+
+    void Renderer::reloadShaders() {
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitUntilIdle());
+        config.shaderManager->reloadShaders();
+        destroyGraphicsPipelines();
+        createGraphicsPipelines();
+        if (meshCuller != nullptr) {
+            meshCuller->reloadShaders();
+        }
+        BL_LOG_INFO("Reloaded shaders");
+    }
+
+    void Renderer::applyFramePacing() {
+        // Frames beyond the new number of frames in flight may still be in flight
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitUntilIdle());
+        updateInputLatencies();
+
+        bool presentationChanged = pendingFramePacing.presentMode != framePacing.presentMode
+                                   || pendingFramePacing.additionalImageCount != framePacing.additionalImageCount;
+        framePacing = pendingFramePacing;
+        framePacingChanged = false;
+        currentFrame = 0;
+        inputToFrameFenceLatency = 0.0;
+        inputToPresentLatency = 0.0;
+        pendingPresents.clear();
+        if (presentationChanged) {
+            swapChain->setPresentation({framePacing.presentMode}, framePacing.additionalImageCount);
+        }
+        BL_LOG_INFO(
+            "Frame pacing [frames in flight: {}, present mode: {}, additional images: {}]",
+            framePacing.framesInFlight,
+            VulkanSwapChain::getPresentModeName(swapChain->getPresentMode()),
+            framePacing.additionalImageCount
         );
+    }
+
+    //
+    // The latency to the frame fence is measured from sampling the input of a frame until its fence is seen signaled,
+    // which happens either while waiting for it or when polling the fences of all frames at the start of every frame.
+    // It is an upper bound of the time until the frame has been rendered, which is off by at most one frame, but does
+    // not include the time the frame is queued for presentation.
+    //
+    // The latency to present is measured the same way from sampling the input until the presentation of the frame is
+    // seen completed with present wait (VK_KHR_present_wait), polled at the start of every frame. A frame that is
+    // replaced by a later one before it is shown (MAILBOX) completes when the later one is presented.
+    //
+    void Renderer::updateInputLatencies() {
+        double time = config.window->getTime();
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            if (frameInputTimes[i] < 0.0 || !swapChain->isFrameFinished(i)) {
+                continue;
+            }
+            inputToFrameFenceLatency = smoothLatency(inputToFrameFenceLatency, (time - frameInputTimes[i]) * 1000.0);
+            frameInputTimes[i] = -1.0;
+        }
+
+        // Presentations complete in order, the later ones can not have completed before the first incomplete one
+        uint32_t completedPresentCount = 0;
+        for (const PendingPresent& pendingPresent : pendingPresents) {
+            VkResult result = swapChain->getPresentStatus(pendingPresent.presentId);
+            if (result == VK_TIMEOUT) {
+                break;
+            }
+            if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+                inputToPresentLatency = smoothLatency(inputToPresentLatency, (time - pendingPresent.inputTime) * 1000.0);
+            }
+            completedPresentCount++;
+        }
+        pendingPresents.erase(pendingPresents.begin(), pendingPresents.begin() + completedPresentCount);
+    }
+
+    double Renderer::smoothLatency(double smoothedLatency, double latency) {
+        return smoothedLatency == 0.0 ? latency : smoothedLatency + (latency - smoothedLatency) * INPUT_LATENCY_SMOOTHING;
+    }
+
+    //
+    // Sort all mesh instances submitted during the frame and group them into draws.
+    //
+    // Instances are sorted by their sort key, which groups them by pipeline, descriptor set and geometry (in that
+    // order, from the most to the least expensive state change) and orders every group front to back. Every group of
+    // instances sharing the same mesh is drawn with a single instanced draw call.
+    //
+    // The model matrices of all instances are written straight into the mapped frame data buffer in sorted order,
+    // which lets every draw call address its own range of the buffer with the firstInstance parameter.
+    //
+    void Renderer::prepareMeshDraws() {
+        if (meshInstances.empty()) {
+            return;
+        }
+        if (meshInstances.size() > MAX_MESH_INSTANCES) {
+            BL_LOG_WARN("Mesh instance count exceeds the maximum [{}/{}], excess instances will not be rendered", meshInstances.size(), MAX_MESH_INSTANCES);
+            meshInstances.resize(MAX_MESH_INSTANCES);
+        }
+
+        std::sort(meshInstances.begin(), meshInstances.end(), [](const MeshInstance& a, const MeshInstance& b) {
+            return a.sortKey < b.sortKey;
+        });
+
+        VulkanRingBufferAllocation instanceAllocation = frameDataBuffer->allocate(sizeof(MeshInstanceData) * meshInstances.size(), sizeof(glm::vec4));
+        auto meshInstanceData = (MeshInstanceData*) instanceAllocation.data;
+        for (uint32_t i = 0; i < meshInstances.size(); i++) {
+            // Packed vertex positions are dequantized by the instance transform
+            meshInstanceData[i].model = meshInstances[i].model * meshInstances[i].mesh->dequantization;
+            meshInstanceData[i].textureTableOffset = meshInstances[i].mesh->textureTableOffset;
+        }
+        instanceBuffer = instanceAllocation.buffer;
+        instanceBufferOffset = instanceAllocation.offset;
+
+        uint32_t firstInstance = 0;
+        while (firstInstance < meshInstances.size()) {
+            MeshDraw meshDraw{};
+            meshDraw.mesh = meshInstances[firstInstance].mesh;
+            meshDraw.lod = meshInstances[firstInstance].lod;
+            meshDraw.firstInstance = firstInstance;
+            meshDraw.instanceCount = 1;
+            while (firstInstance + meshDraw.instanceCount < meshInstances.size()) {
+                const MeshInstance& meshInstance = meshInstances[firstInstance + meshDraw.instanceCount];
+                if (meshInstance.mesh != meshDraw.mesh || meshInstance.lod != meshDraw.lod) {
+                    break;
+                }
+                meshDraw.instanceCount++;
+            }
+            meshDraws.push_back(meshDraw);
+            firstInstance += meshDraw.instanceCount;
+        }
+    }
+
+    //
+    // Cull the mesh objects on the GPU and draw every draw group of the mesh culler with a single multi-draw.
+    //
+    // Only the instance counts of the draw commands are decided by the GPU, so every level of detail of every mesh has a
+    // draw command whether any of its instances are visible or not. Draw commands without instances are skipped by the
+    // GPU. The CPU only records one draw call (and the state it needs) per group of meshes sharing the same state.
+    //
+    void Renderer::prepareIndirectMeshDraws() {
+        // The view matrix is rigid, so the distance in view space used by Scene::selectLod is the distance to the camera
+        MeshCullerLodSelection lodSelection{};
+        lodSelection.cameraPosition = glm::vec3(glm::inverse(view)[3]);
+        lodSelection.scale = projection[1][1] * lodBias;
+        lodSelection.screenSize = lodScreenSize;
+
+        gpuProfiler->beginPass(currentCommandBuffer, (uint32_t) GpuPass::Culling);
+        meshCuller->cull(currentCommandBuffer, Frustum(viewProjectionMatrix), lodSelection);
+        gpuProfiler->endPass(currentCommandBuffer, (uint32_t) GpuPass::Culling);
+
+        for (const MeshCullerDrawGroup& drawGroup : meshCuller->getDrawGroups()) {
+            MeshDraw meshDraw{};
+            meshDraw.mesh = drawGroup.mesh;
+            meshDraw.firstDrawCommand = drawGroup.firstDrawCommand;
+            meshDraw.drawCommandCount = drawGroup.drawCommandCount;
+            meshDraws.push_back(meshDraw);
+        }
+        instanceBuffer = meshCuller->getInstanceBuffer();
+        instanceBufferOffset = 0;
+    }
+
+    //
+    // Record the draws of the frame into secondary command buffers and execute them in the render pass of the primary
+    // command buffer.
+    //
+    // The sorted draws are split into contiguous ranges, one per recording thread. The main thread records the first
+    // range (and the skybox) while the thread pool records the rest. Executing the secondary command buffers in thread
+    // order keeps the draws in sorted order.
+    //
+    // Small frames use fewer threads, since the cost of handing out the work would outweigh the recording it saves.
+    //
+    void Renderer::recordCommandBuffers() {
+        uint32_t drawCount = (uint32_t) meshDraws.size();
+        uint32_t threadCount = std::clamp((drawCount + MIN_DRAWS_PER_RECORDING_THREAD - 1) / MIN_DRAWS_PER_RECORDING_THREAD, 1u, recordingThreadCount);
+        uint32_t drawsPerThread = (drawCount + threadCount - 1) / threadCount;
+
+        std::vector<std::future<void>> futures;
+        for (uint32_t threadIndex = 1; threadIndex < threadCount; threadIndex++) {
+            uint32_t firstDraw = std::min(threadIndex * drawsPerThread, drawCount);
+            uint32_t lastDraw = std::min(firstDraw + drawsPerThread, drawCount);
+            futures.push_back(config.threadPool->submit([this, threadIndex, threadCount, firstDraw, lastDraw] {
+                recordCommandBuffer(threadIndex, threadCount, firstDraw, lastDraw);
+            }));
+        }
+        recordCommandBuffer(0, threadCount, 0, std::min(drawsPerThread, drawCount));
+
+        // Rethrows any error that occurred while recording
+        for (std::future<void>& future : futures) {
+            future.get();
+        }
+
+        std::vector<VkCommandBuffer> secondaryCommandBuffers(threadCount);
+        RendererStatistics frameStatistics{};
+        for (uint32_t threadIndex = 0; threadIndex < threadCount; threadIndex++) {
+            const RecordingContext& context = recordingContexts[threadIndex];
+            secondaryCommandBuffers[threadIndex] = context.commandBuffer;
+            frameStatistics.drawCalls += context.statistics.drawCalls;
+            frameStatistics.instances += context.statistics.instances;
+            frameStatistics.pipelineBinds += context.statistics.pipelineBinds;
+            frameStatistics.descriptorSetBinds += context.statistics.descriptorSetBinds;
+            frameStatistics.vertexBufferBinds += context.statistics.vertexBufferBinds;
+            frameStatistics.indexBufferBinds += context.statistics.indexBufferBinds;
+            frameStatistics.skippedBinds += context.statistics.skippedBinds;
+            frameStatistics.recordingTimes.push_back(context.recordingTime);
+        }
+        frameStatistics.lodTriangles = lodTriangles;
+        frameStatistics.inputToFrameFenceLatency = inputToFrameFenceLatency;
+        frameStatistics.inputToPresentLatency = inputToPresentLatency;
+        if (gpuProfiler->isSupported()) {
+            frameStatistics.gpuPassTimes = gpuProfiler->getPassTimes();
+        }
+        statistics = frameStatistics;
+
+        vkCmdExecuteCommands(currentCommandBuffer, (uint32_t) secondaryCommandBuffers.size(), secondaryCommandBuffers.data());
+    }
+
+    void Renderer::recordCommandBuffer(uint32_t threadIndex, uint32_t threadCount, uint32_t firstDraw, uint32_t lastDraw) {
+        auto startTime = std::chrono::steady_clock::now();
+
+        // Nothing is bound to a command buffer when recording begins
+        RecordingContext& context = recordingContexts[threadIndex];
+        context.commandBuffer = recordingCommandBuffers[currentFrame * recordingThreadCount + threadIndex];
+        context.renderState = {};
+        context.statistics = {};
+
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = swapChain->getRenderPass();
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = swapChain->getFramebuffer();
+
+        constexpr VkCommandBufferUsageFlags usageFlags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        BL_ASSERT_THROW_VK_SUCCESS(context.commandBuffer.begin(usageFlags, &inheritanceInfo));
+        swapChain->setViewportAndScissor(context.commandBuffer);
+
+        // The skybox is drawn first since it doesn't write depth and is covered by everything else
+        if (threadIndex == 0 && skybox != nullptr) {
+            gpuProfiler->beginPass(context.commandBuffer, (uint32_t) GpuPass::Skybox);
+            recordSkybox(&context);
+            gpuProfiler->endPass(context.commandBuffer, (uint32_t) GpuPass::Skybox);
+        }
+        // The mesh pass spans the secondary command buffers of all threads, which are executed in thread order
+        if (threadIndex == 0) {
+            gpuProfiler->beginPass(context.commandBuffer, (uint32_t) GpuPass::Meshes);
+        }
+        if (firstDraw < lastDraw) {
+            recordMeshDraws(&context, firstDraw, lastDraw);
+        }
+        if (threadIndex == threadCount - 1) {
+            gpuProfiler->endPass(context.commandBuffer, (uint32_t) GpuPass::Meshes);
+        }
+
+        BL_ASSERT_THROW_VK_SUCCESS(context.commandBuffer.end());
+
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+        context.recordingTime = duration.count();
+    }
+
+    void Renderer::recordSkybox(RecordingContext* context) const {
+        bindPipeline(context, skyboxGraphicsPipeline);
+        bindDescriptorSets(context, skyboxGraphicsPipeline, skybox->descriptorSet);
+        bindVertexBuffer(context, *skybox->vertexBuffer);
+        bindIndexBuffer(context, *skybox->indexBuffer);
 
         constexpr uint32_t instanceCount = 1;
         constexpr uint32_t firstIndex = 0;
         constexpr uint32_t vertexOffset = 0;
         constexpr uint32_t firstInstance = 0;
         vkCmdDrawIndexed(
-            currentCommandBuffer,
+            context->commandBuffer,
             (uint32_t) skybox->indices.size(),
             instanceCount,
             firstIndex,
             vertexOffset,
             firstInstance
         );
+        context->statistics.drawCalls++;
     }
 
-    void Renderer::renderMesh(const std::shared_ptr<Mesh>& mesh) const {
-        meshGraphicsPipeline->bind(currentCommandBuffer);
-        mesh->vertexBuffer->bind(currentCommandBuffer);
-        mesh->indexBuffer->bind(currentCommandBuffer);
-
-        constexpr uint32_t offset = 0;
-        vkCmdPushConstants(
-            currentCommandBuffer,
-            meshGraphicsPipeline->getLayout(),
-            VK_SHADER_STAGE_VERTEX_BIT,
-            offset,
-            sizeof(MeshPushConstantData),
-            &mesh->model
-        );
+    void Renderer::recordMeshDraws(RecordingContext* context, uint32_t firstDraw, uint32_t lastDraw) const {
+        // The instance buffer binding is shared by every mesh draw of the frame
+        VkBuffer instanceBuffers[] = { instanceBuffer };
+        VkDeviceSize instanceBufferOffsets[] = { instanceBufferOffset };
+        constexpr uint32_t firstBinding = 1;
+        constexpr uint32_t bindingCount = 1;
+        vkCmdBindVertexBuffers(context->commandBuffer, firstBinding, bindingCount, instanceBuffers, instanceBufferOffsets);
+
+        for (uint32_t i = firstDraw; i < lastDraw; i++) {
+            const MeshDraw& meshDraw = meshDraws[i];
+            Mesh* mesh = meshDraw.mesh;
+            const MeshLod& lod = mesh->lods[meshDraw.lod];
+
+            VulkanGraphicsPipeline* graphicsPipeline = getMeshGraphicsPipeline(mesh);
+            bindPipeline(context, graphicsPipeline);
+            bindDescriptorSets(context, graphicsPipeline, mesh->descriptorSet);
+            bindVertexBuffer(context, *mesh->vertexBuffer);
+            bindIndexBuffer(context, *mesh->indexBuffer);
+
+            if (gpuCullingActive) {
+                // The instance counts are only known by the GPU, the draw group is split only if it exceeds the device limit
+                constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+                uint32_t lastDrawCommand = meshDraw.firstDrawCommand + meshDraw.drawCommandCount;
+                for (uint32_t firstDrawCommand = meshDraw.firstDrawCommand; firstDrawCommand < lastDrawCommand; firstDrawCommand += maxIndirectDrawCount) {
+                    uint32_t drawCount = std::min(lastDrawCommand - firstDrawCommand, maxIndirectDrawCount);
+                    vkCmdDrawIndexedIndirect(
+                        context->commandBuffer,
+                        meshCuller->getDrawCommandBuffer(),
+                        firstDrawCommand * stride,
+                        drawCount,
+                        stride
+                    );
+                    context->statistics.drawCalls++;
+                }
+                continue;
+            }
+
+            constexpr uint32_t vertexOffset = 0;
+            vkCmdDrawIndexed(
+                context->commandBuffer,
+                lod.indexCount,
+                meshDraw.instanceCount,
+                lod.firstIndex,
+                vertexOffset,
+                meshDraw.firstInstance
+            );
+            context->statistics.drawCalls++;
+            context->statistics.instances += meshDraw.instanceCount;
+        }
+    }
 
-        std::array<VkDescriptorSet, 2> descriptorSets = {
-            this->viewProjectionDescriptorSets[currentFrame], // Per frame descriptor set
-            mesh->descriptorSet // Per mesh descriptor set
+    //
+    // 64-bit sort key, from the most to the least significant bits:
+    //
+    // [63..56] Pipeline
+    // [55..40] Descriptor set
+    // [39..26] Geometry (vertex and index buffers)
+    // [25..24] Level of detail
+    // [23..0]  View space depth
+    //
+    // The ids are handed out in order of first use during the frame, they only have to be equal for equal state.
+    //
+    uint64_t Renderer::getSortKey(const VulkanGraphicsPipeline* pipeline, const Mesh* mesh, uint32_t lod, const glm::mat4& model) {
+        auto getId = [](auto& ids, auto handle, uint64_t maxId) -> uint64_t {
+            auto [iterator, inserted] = ids.try_emplace(handle, (uint32_t) ids.size());
+            return std::min((uint64_t) iterator->second, maxId);
         };
+        uint64_t pipelineId = getId(pipelineIds, (VkPipeline) *pipeline, 0xFF);
+        uint64_t descriptorSetId = getId(descriptorSetIds, mesh->descriptorSet, 0xFFFF);
+        uint64_t geometryId = getId(geometryIds, (VkBuffer) *mesh->vertexBuffer, 0x3FFF);
+        uint64_t lodId = lod & 0x3;
+
+        // Positive floats keep their order when their bits are compared as integers, the top 24 bits are enough precision for sorting
+        float depth = std::max(-(view * model[3]).z, 0.0f);
+        uint32_t depthBits = 0;
+        memcpy(&depthBits, &depth, sizeof(float));
+        uint64_t depthKey = depthBits >> 8;
+
+        return (pipelineId << 56) | (descriptorSetId << 40) | (geometryId << 26) | (lodId << 24) | depthKey;
+    }
 
-        constexpr uint32_t firstSet = 0;
-        constexpr uint32_t dynamicOffsetCount = 0;
-        constexpr uint32_t* dynamicOffsets = nullptr;
-        vkCmdBindDescriptorSets(
-            currentCommandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            meshGraphicsPipeline->getLayout(),
-            firstSet,
-            descriptorSets.size(),
-            descriptorSets.data(),
-            dynamicOffsetCount,
-            dynamicOffsets
-        );
+    void Renderer::bindPipeline(RecordingContext* context, const VulkanGraphicsPipeline* pipeline) const {
+        if (context->renderState.pipeline == (VkPipeline) *pipeline) {
+            context->statistics.skippedBinds++;
+            return;
+        }
+        pipeline->bind(context->commandBuffer);
+        context->statistics.pipelineBinds++;
 
-        constexpr uint32_t instanceCount = 1;
-        constexpr uint32_t firstIndex = 0;
-        constexpr uint32_t vertexOffset = 0;
-        constexpr uint32_t firstInstance = 0;
-        vkCmdDrawIndexed(
-            currentCommandBuffer,
-            (uint32_t) mesh->indices.size(),
-            instanceCount,
-            firstIndex,
-            vertexOffset,
-            firstInstance
-        );
+        // The mesh and skybox pipeline layouts are compatible for set 0 (same set layout and no push constants), so the
+        // per frame descriptor set stays bound when switching between them, but the per object set has to be bound again.
+        if (context->renderState.pipelineLayout != pipeline->getLayout()) {
+            context->renderState.objectDescriptorSet = nullptr;
+        }
+        context->renderState.pipeline = *pipeline;
+        context->renderState.pipelineLayout = pipeline->getLayout();
     }
 
-    void Renderer::endFrame() {
-        swapChain->endRenderPass(currentCommandBuffer);
-        BL_ASSERT_THROW_VK_SUCCESS(currentCommandBuffer.end());
-        swapChain->endFrame(currentCommandBuffer);
-        currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    void Renderer::bindDescriptorSets(RecordingContext* context, const VulkanGraphicsPipeline* pipeline, VkDescriptorSet objectDescriptorSet) const {
+        if (context->renderState.frameDescriptorSet != viewProjectionDescriptorSet || context->renderState.frameDescriptorSetOffset != viewProjectionOffset) {
+            constexpr uint32_t firstSet = 0;
+            constexpr uint32_t descriptorSetCount = 1;
+            constexpr uint32_t dynamicOffsetCount = 1;
+            vkCmdBindDescriptorSets(
+                context->commandBuffer,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                pipeline->getLayout(),
+                firstSet,
+                descriptorSetCount,
+                &viewProjectionDescriptorSet,
+                dynamicOffsetCount,
+                &viewProjectionOffset
+            );
+            context->renderState.frameDescriptorSet = viewProjectionDescriptorSet;
+            context->renderState.frameDescriptorSetOffset = viewProjectionOffset;
+            context->statistics.descriptorSetBinds++;
+        } else {
+            context->statistics.skippedBinds++;
+        }
+
+        if (context->renderState.objectDescriptorSet != objectDescriptorSet) {
+            constexpr uint32_t firstSet = 1;
+            constexpr uint32_t descriptorSetCount = 1;
+            constexpr uint32_t dynamicOffsetCount = 0;
+            constexpr uint32_t* dynamicOffsets = nullptr;
+            vkCmdBindDescriptorSets(
+                context->commandBuffer,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                pipeline->getLayout(),
+                firstSet,
+                descriptorSetCount,
+                &objectDescriptorSet,
+                dynamicOffsetCount,
+                dynamicOffsets
+            );
+            context->renderState.objectDescriptorSet = objectDescriptorSet;
+            context->statistics.descriptorSetBinds++;
+        } else {
+            context->statistics.skippedBinds++;
+        }
     }
 
-    void Renderer::reloadShaders() {
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitUntilIdle());
-        config.shaderManager->reloadShaders();
-        destroyGraphicsPipelines();
-        createGraphicsPipelines();
-        BL_LOG_INFO("Reloaded shaders");
+    void Renderer::bindVertexBuffer(RecordingContext* context, VkBuffer vertexBuffer) {
+        if (context->renderState.vertexBuffer == vertexBuffer) {
+            context->statistics.skippedBinds++;
+            return;
+        }
+        VkBuffer buffers[] = { vertexBuffer };
+        VkDeviceSize offsets[] = { 0 };
+        constexpr uint32_t firstBinding = 0;
+        constexpr uint32_t bindingCount = 1;
+        vkCmdBindVertexBuffers(context->commandBuffer, firstBinding, bindingCount, buffers, offsets);
+        context->renderState.vertexBuffer = vertexBuffer;
+        context->statistics.vertexBufferBinds++;
+    }
+
+    void Renderer::bindIndexBuffer(RecordingContext* context, const VulkanIndexBuffer& indexBuffer) {
+        if (context->renderState.indexBuffer == indexBuffer) {
+            context->statistics.skippedBinds++;
+            return;
+        }
+        constexpr VkDeviceSize offset = 0;
+        vkCmdBindIndexBuffer(context->commandBuffer, indexBuffer, offset, indexBuffer.getIndexType());
+        context->renderState.indexBuffer = indexBuffer;
+        context->statistics.indexBufferBinds++;
     }
 
     void Renderer::createCommandObjects() {
@@ -189,9 +702,26 @@ namespace Blink {
 
         commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
         BL_ASSERT_THROW_VK_SUCCESS(commandPool->allocateCommandBuffers(&commandBuffers));
+
+        // Command pools must not be used by more than one thread at a time, so every recording thread gets its own
+        // command pool for every frame in flight. The main thread records as well as the threads of the thread pool.
+        recordingThreadCount = std::min(config.threadPool->getThreadCount() + 1, MAX_RECORDING_THREADS);
+        recordingContexts.resize(recordingThreadCount);
+        recordingCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT * recordingThreadCount);
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT * recordingThreadCount; i++) {
+            VulkanCommandPoolConfig recordingCommandPoolConfig{};
+            recordingCommandPoolConfig.device = config.device;
+            auto recordingCommandPool = new VulkanCommandPool(recordingCommandPoolConfig);
+            BL_ASSERT_THROW_VK_SUCCESS(recordingCommandPool->allocateCommandBuffers(1, recordingCommandBuffers[i].vk_ptr(), VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+            recordingCommandPools.push_back(recordingCommandPool);
+        }
+        BL_LOG_INFO("Created command objects [recording threads: {}]", recordingThreadCount);
     }
 
     void Renderer::destroyCommandObjects() const {
+        for (VulkanCommandPool* recordingCommandPool : recordingCommandPools) {
+            delete recordingCommandPool;
+        }
         delete commandPool;
     }
 
@@ -200,50 +730,53 @@ namespace Blink {
         swapChainConfig.window = config.window;
         swapChainConfig.vulkanApp = config.vulkanApp;
         swapChainConfig.device = config.device;
-        swapChainConfig.commandPool = commandPool;
+        swapChainConfig.frameCount = MAX_FRAMES_IN_FLIGHT;
+        swapChainConfig.presentModes = {framePacing.presentMode};
+        swapChainConfig.additionalImageCount = framePacing.additionalImageCount;
         swapChain = new VulkanSwapChain(swapChainConfig);
+        BL_LOG_INFO(
+            "Frame pacing [frames in flight: {}, present mode: {}, additional images: {}]",
+            framePacing.framesInFlight,
+            VulkanSwapChain::getPresentModeName(swapChain->getPresentMode()),
+            framePacing.additionalImageCount
+        );
     }
 
     void Renderer::destroySwapChain() const {
         delete swapChain;
     }
 
-    void Renderer::createUniformBuffers() {
-        viewProjectionUniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-        for (uint32_t i = 0; i < viewProjectionUniformBuffers.size(); i++) {
-            VulkanUniformBufferConfig uniformBufferConfig{};
-            uniformBufferConfig.device = config.device;
-            uniformBufferConfig.commandPool = commandPool;
-            uniformBufferConfig.size = sizeof(ViewProjectionUniformBufferData);
-            viewProjectionUniformBuffers[i] = new VulkanUniformBuffer(uniformBufferConfig);
-        }
+    void Renderer::createFrameDataBuffer() {
+        VulkanRingBufferConfig ringBufferConfig{};
+        ringBufferConfig.device = config.device;
+        ringBufferConfig.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        ringBufferConfig.frameSize = FRAME_DATA_SIZE;
+        ringBufferConfig.frameCount = MAX_FRAMES_IN_FLIGHT;
+        frameDataBuffer = new VulkanRingBuffer(ringBufferConfig);
     }
 
-    void Renderer::destroyUniformBuffers() {
-        for (VulkanUniformBuffer* uniformBuffer : viewProjectionUniformBuffers) {
-            delete uniformBuffer;
-        }
-        viewProjectionUniformBuffers.clear();
+    void Renderer::destroyFrameDataBuffer() const {
+        delete frameDataBuffer;
     }
 
     void Renderer::createDescriptorObjects() {
         // Descriptor pool
         VkDescriptorPoolSize descriptorPoolSize{};
-        descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorPoolSize.descriptorCount = (uint32_t) MAX_FRAMES_IN_FLIGHT;
+        descriptorPoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorPoolSize.descriptorCount = 1;
 
         VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
         descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         descriptorPoolCreateInfo.poolSizeCount = 1;
         descriptorPoolCreateInfo.pPoolSizes = &descriptorPoolSize;
-        descriptorPoolCreateInfo.maxSets = (uint32_t) MAX_FRAMES_IN_FLIGHT;
+        descriptorPoolCreateInfo.maxSets = 1;
 
         BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorPool(&descriptorPoolCreateInfo, &viewProjectionDescriptorPool));
 
         // Descriptor set layout
         VkDescriptorSetLayoutBinding uniformBufferLayoutBinding{};
         uniformBufferLayoutBinding.binding = 0;
-        uniformBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        uniformBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         uniformBufferLayoutBinding.descriptorCount = 1;
         uniformBufferLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
@@ -255,34 +788,33 @@ namespace Blink {
         BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorSetLayout(&descriptorSetLayoutCreateInfo, &viewProjectionDescriptorSetLayout));
 
         // Descriptor set
-        viewProjectionDescriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
-        std::vector<VkDescriptorSetLayout> descriptorSetLayouts(viewProjectionDescriptorSets.size(), viewProjectionDescriptorSetLayout);
-
+        //
+        // A single descriptor set covers the frame data buffer of every frame in flight. The view-projection of the
+        // current frame is selected with a dynamic offset when the descriptor set is bound.
+        //
         VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
         descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         descriptorSetAllocateInfo.descriptorPool = viewProjectionDescriptorPool;
-        descriptorSetAllocateInfo.descriptorSetCount = viewProjectionDescriptorSets.size();
-        descriptorSetAllocateInfo.pSetLayouts = descriptorSetLayouts.data();
-
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->allocateDescriptorSets(&descriptorSetAllocateInfo, viewProjectionDescriptorSets.data()));
-
-        for (uint32_t i = 0; i < viewProjectionDescriptorSets.size(); i++) {
-            VkDescriptorBufferInfo descriptorBufferInfo{};
-            descriptorBufferInfo.buffer = *viewProjectionUniformBuffers[i];
-            descriptorBufferInfo.offset = 0;
-            descriptorBufferInfo.range = sizeof(ViewProjectionUniformBufferData);
-
-            VkWriteDescriptorSet descriptorWrite{};
-            descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrite.dstSet = viewProjectionDescriptorSets[i];
-            descriptorWrite.dstBinding = 0;
-            descriptorWrite.dstArrayElement = 0;
-            descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptorWrite.descriptorCount = 1;
-            descriptorWrite.pBufferInfo = &descriptorBufferInfo;
-
-            config.device->updateDescriptorSets(1, &descriptorWrite);
-        }
+        descriptorSetAllocateInfo.descriptorSetCount = 1;
+        descriptorSetAllocateInfo.pSetLayouts = &viewProjectionDescriptorSetLayout;
+
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->allocateDescriptorSets(&descriptorSetAllocateInfo, &viewProjectionDescriptorSet));
+
+        VkDescriptorBufferInfo descriptorBufferInfo{};
+        descriptorBufferInfo.buffer = *frameDataBuffer;
+        descriptorBufferInfo.offset = 0;
+        descriptorBufferInfo.range = sizeof(ViewProjectionUniformBufferData);
+
+        VkWriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet = viewProjectionDescriptorSet;
+        descriptorWrite.dstBinding = 0;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &descriptorBufferInfo;
+
+        config.device->updateDescriptorSets(1, &descriptorWrite);
     }
 
     void Renderer::destroyDescriptorObjects() const {
@@ -290,48 +822,59 @@ namespace Blink {
         config.device->destroyDescriptorSetLayout(viewProjectionDescriptorSetLayout);
     }
 
-    void Renderer::createGraphicsPipelines() {
-        // Mesh
-        {
-            std::shared_ptr<VulkanShader> vertexShader = config.shaderManager->getShader("shaders/mesh.vert.spv");
-            std::shared_ptr<VulkanShader> fragmentShader = config.shaderManager->getShader("shaders/mesh.frag.spv");
-
-            VkVertexInputBindingDescription vertexBindingDescription = MeshVertex::getBindingDescription();
-            std::vector<VkVertexInputAttributeDescription> vertexAttributeDescriptions = MeshVertex::getAttributeDescriptions();
-
-            std::vector<VkDescriptorSetLayout> descriptorSetLayouts = {
-                viewProjectionDescriptorSetLayout, // Per frame descriptor set layout
-                config.meshManager->getDescriptorSetLayout() // Per mesh descriptor set layout
-            };
+    void Renderer::createMeshCuller() {
+        // The indirect draws address each mesh's range of the instance buffer with a non-zero first instance
+        if (!config.device->getPhysicalDevice()->getFeatures().drawIndirectFirstInstance) {
+            BL_LOG_WARN("GPU culling is not supported by the device (drawIndirectFirstInstance)");
+            return;
+        }
+        MeshCullerConfig meshCullerConfig{};
+        meshCullerConfig.device = config.device;
+        meshCullerConfig.pipelineCache = config.pipelineCache;
+        meshCullerConfig.shaderManager = config.shaderManager;
+        meshCullerConfig.frameCount = MAX_FRAMES_IN_FLIGHT;
+        meshCullerConfig.maxObjects = MAX_MESH_INSTANCES;
+        meshCuller = new MeshCuller(meshCullerConfig);
+        gpuCullingEnabled = config.gpuCullingEnabled;
+
+        // Without multiDrawIndirect every draw command of a draw group needs its own draw call
+        VulkanPhysicalDevice* physicalDevice = config.device->getPhysicalDevice();
+        if (physicalDevice->getFeatures().multiDrawIndirect) {
+            maxIndirectDrawCount = std::max(physicalDevice->getProperties().limits.maxDrawIndirectCount, 1u);
+        } else {
+            BL_LOG_WARN("GPU culling draws every draw command separately (multiDrawIndirect not supported)");
+        }
+    }
 
-            VkPushConstantRange pushConstantRange{};
-            pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-            pushConstantRange.offset = 0;
-            pushConstantRange.size = sizeof(MeshPushConstantData);
+    void Renderer::destroyMeshCuller() const {
+        delete meshCuller;
+    }
 
-            std::vector<VkPushConstantRange> pushConstantRanges = {
-                pushConstantRange,
-            };
+    void Renderer::createGpuProfiler() {
+        GpuProfilerConfig gpuProfilerConfig{};
+        gpuProfilerConfig.device = config.device;
+        gpuProfilerConfig.frameCount = MAX_FRAMES_IN_FLIGHT;
+        gpuProfilerConfig.passNames = {"frame", "culling", "skybox", "meshes"}; // In order of GpuPass
+        gpuProfiler = new GpuProfiler(gpuProfilerConfig);
+    }
 
-            VulkanGraphicsPipelineConfig graphicsPipelineConfig{};
-            graphicsPipelineConfig.device = config.device;
-            graphicsPipelineConfig.renderPass = swapChain->getRenderPass();
-            graphicsPipelineConfig.vertexShader = vertexShader;
-            graphicsPipelineConfig.fragmentShader = fragmentShader;
-            graphicsPipelineConfig.vertexBindingDescription = &vertexBindingDescription;
-            graphicsPipelineConfig.vertexAttributeDescriptions = &vertexAttributeDescriptions;
-            graphicsPipelineConfig.descriptorSetLayouts = &descriptorSetLayouts;
-            graphicsPipelineConfig.pushConstantRanges = &pushConstantRanges;
-            graphicsPipelineConfig.depthTestEnabled = true;
+    void Renderer::destroyGpuProfiler() const {
+        delete gpuProfiler;
+    }
 
-            meshGraphicsPipeline = new VulkanGraphicsPipeline(graphicsPipelineConfig);
-        }
+    void Renderer::createGraphicsPipelines() {
+        auto startTime = std::chrono::steady_clock::now();
+        // Mesh
+        meshGraphicsPipeline = createMeshGraphicsPipeline("shaders/mesh.vert.spv", MeshVertexFormat::Packed);
+        coloredMeshGraphicsPipeline = createMeshGraphicsPipeline("shaders/mesh_colored.vert.spv", MeshVertexFormat::PackedColor);
         // Skybox
         {
             std::shared_ptr<VulkanShader> vertexShader = config.shaderManager->getShader("shaders/skybox.vert.spv");
             std::shared_ptr<VulkanShader> fragmentShader = config.shaderManager->getShader("shaders/skybox.frag.spv");
 
-            VkVertexInputBindingDescription vertexBindingDescription = SkyboxVertex::getBindingDescription();
+            std::vector<VkVertexInputBindingDescription> vertexBindingDescriptions = {
+                SkyboxVertex::getBindingDescription()
+            };
             std::vector<VkVertexInputAttributeDescription> vertexAttributeDescriptions = SkyboxVertex::getAttributeDescriptions();
 
             std::vector<VkDescriptorSetLayout> descriptorSetLayouts = {
@@ -341,21 +884,66 @@ namespace Blink {
 
             VulkanGraphicsPipelineConfig graphicsPipelineConfig{};
             graphicsPipelineConfig.device = config.device;
+            graphicsPipelineConfig.pipelineCache = config.pipelineCache;
             graphicsPipelineConfig.renderPass = swapChain->getRenderPass();
             graphicsPipelineConfig.vertexShader = vertexShader;
             graphicsPipelineConfig.fragmentShader = fragmentShader;
-            graphicsPipelineConfig.vertexBindingDescription = &vertexBindingDescription;
+            graphicsPipelineConfig.vertexBindingDescriptions = &vertexBindingDescriptions;
             graphicsPipelineConfig.vertexAttributeDescriptions = &vertexAttributeDescriptions;
             graphicsPipelineConfig.descriptorSetLayouts = &descriptorSetLayouts;
             graphicsPipelineConfig.depthTestEnabled = false;
 
             skyboxGraphicsPipeline = new VulkanGraphicsPipeline(graphicsPipelineConfig);
         }
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+        config.pipelineCache->recordCreationTime(duration.count());
     }
 
     void Renderer::destroyGraphicsPipelines() const {
         delete skyboxGraphicsPipeline;
+        delete coloredMeshGraphicsPipeline;
         delete meshGraphicsPipeline;
     }
+
+    VulkanGraphicsPipeline* Renderer::createMeshGraphicsPipeline(const std::string& vertexShaderPath, MeshVertexFormat vertexFormat) const {
+        std::shared_ptr<VulkanShader> vertexShader = config.shaderManager->getShader(vertexShaderPath);
+        std::string fragmentShaderPath = config.meshManager->isBindless() ? "shaders/mesh_bindless.frag.spv" : "shaders/mesh.frag.spv";
+        std::shared_ptr<VulkanShader> fragmentShader = config.shaderManager->getShader(fragmentShaderPath);
+
+        std::vector<VkVertexInputBindingDescription> vertexBindingDescriptions = {
+            MeshVertex::getBindingDescription(vertexFormat), // Per vertex
+            MeshInstanceData::getBindingDescription() // Per instance
+        };
+
+        std::vector<VkVertexInputAttributeDescription> vertexAttributeDescriptions = MeshVertex::getAttributeDescriptions(vertexFormat);
+        std::vector<VkVertexInputAttributeDescription> instanceAttributeDescriptions = MeshInstanceData::getAttributeDescriptions();
+        vertexAttributeDescriptions.insert(vertexAttributeDescriptions.end(), instanceAttributeDescriptions.begin(), instanceAttributeDescriptions.end());
+
+        std::vector<VkDescriptorSetLayout> descriptorSetLayouts = {
+            viewProjectionDescriptorSetLayout, // Per frame descriptor set layout
+            config.meshManager->getDescriptorSetLayout() // Per mesh descriptor set layout
+        };
+
+        VulkanGraphicsPipelineConfig graphicsPipelineConfig{};
+        graphicsPipelineConfig.device = config.device;
+        graphicsPipelineConfig.pipelineCache = config.pipelineCache;
+        graphicsPipelineConfig.renderPass = swapChain->getRenderPass();
+        graphicsPipelineConfig.vertexShader = vertexShader;
+        graphicsPipelineConfig.fragmentShader = fragmentShader;
+        graphicsPipelineConfig.vertexBindingDescriptions = &vertexBindingDescriptions;
+        graphicsPipelineConfig.vertexAttributeDescriptions = &vertexAttributeDescriptions;
+        graphicsPipelineConfig.descriptorSetLayouts = &descriptorSetLayouts;
+        graphicsPipelineConfig.depthTestEnabled = true;
+
+        return new VulkanGraphicsPipeline(graphicsPipelineConfig);
+    }
+
+    // Meshes without vertex colors use a pipeline that doesn't fetch them
+    VulkanGraphicsPipeline* Renderer::getMeshGraphicsPipeline(const Mesh* mesh) const {
+        if (mesh->vertexFormat == MeshVertexFormat::PackedColor) {
+            return coloredMeshGraphicsPipeline;
+        }
+        return meshGraphicsPipeline;
+    }
 }
 
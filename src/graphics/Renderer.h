@@ -1,13 +1,19 @@
 #pragma once
 
 #include "system/FileSystem.h"
+#include "system/ThreadPool.h"
 #include "window/Window.h"
 #include "graphics/VulkanSwapChain.h"
+#include "graphics/VulkanCommandPool.h"
+#include "graphics/VulkanUploadContext.h"
 #include "graphics/VulkanShader.h"
 #include "graphics/VulkanGraphicsPipeline.h"
-#include "graphics/VulkanUniformBuffer.h"
+#include "graphics/VulkanPipelineCache.h"
+#include "graphics/VulkanRingBuffer.h"
+#include "graphics/GpuProfiler.h"
 #include "graphics/ViewProjection.h"
 #include "graphics/MeshManager.h"
+#include "graphics/MeshCuller.h"
 #include "graphics/ShaderManager.h"
 #include "graphics/SkyboxManager.h"
 #include "graphics/Skybox.h"
@@ -15,34 +21,158 @@
 #include <vulkan/vulkan.h>
 
 namespace Blink {
+    // Trade-off between frame rate and the time from sampling input to presenting the frame rendered from it
+    struct FramePacing {
+        uint32_t framesInFlight = 3; // 1 to Renderer::MAX_FRAMES_IN_FLIGHT, with 1 the GPU and the next image are waited for before input is sampled
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR; // FIFO is used if the surface does not support it
+        uint32_t additionalImageCount = 1; // Swap chain images beyond the surface minimum, fewer images queue fewer frames for presentation
+    };
+
+    // Presentation whose latency is measured once it has been presented
+    struct PendingPresent {
+        uint64_t presentId = 0;
+        double inputTime = 0.0; // Seconds
+    };
+
+    // Passes timed on the GPU, named in Renderer::createGpuProfiler
+    enum class GpuPass : uint32_t {
+        Frame, // The whole primary command buffer
+        Culling,
+        Skybox,
+        Meshes,
+    };
+
+    struct MeshInstance {
+        uint64_t sortKey = 0;
+        Mesh* mesh = nullptr;
+        uint32_t lod = 0;
+        glm::mat4 model = glm::mat4(1.0f);
+    };
+
+    struct RendererStatistics {
+        uint32_t drawCalls = 0;
+        uint32_t instances = 0;
+        uint32_t pipelineBinds = 0;
+        uint32_t descriptorSetBinds = 0;
+        uint32_t vertexBufferBinds = 0;
+        uint32_t indexBufferBinds = 0;
+        uint32_t skippedBinds = 0; // Binds that were not recorded because the state was already bound
+        std::vector<double> recordingTimes; // Milliseconds spent recording by each recording thread
+        std::array<uint32_t, Mesh::MAX_LODS> lodTriangles{}; // Triangles submitted per level of detail (CPU culling only, the GPU selects the levels of mesh objects)
+        double inputToFrameFenceLatency = 0.0; // Smoothed milliseconds from sampling input to seeing the fence of the frame rendered from it signaled
+        double inputToPresentLatency = 0.0; // Smoothed milliseconds from sampling input to presenting the frame rendered from it, 0 without present wait
+        std::vector<GpuPassTime> gpuPassTimes; // Of the last frame that finished with the same frame index, empty without GPU profiling
+    };
+
+    // State bound to the command buffer of the current frame
+    struct RenderState {
+        VkPipeline pipeline = nullptr;
+        VkPipelineLayout pipelineLayout = nullptr;
+        VkDescriptorSet frameDescriptorSet = nullptr;
+        uint32_t frameDescriptorSetOffset = 0;
+        VkDescriptorSet objectDescriptorSet = nullptr;
+        VkBuffer vertexBuffer = nullptr;
+        VkBuffer indexBuffer = nullptr;
+    };
+
+    // Instanced draw of consecutive mesh instances sharing the same mesh and level of detail, or with GPU culling the
+    // indirect draws of a draw group of the mesh culler
+    struct MeshDraw {
+        Mesh* mesh = nullptr;
+        uint32_t lod = 0;
+        uint32_t firstInstance = 0;
+        uint32_t instanceCount = 0;
+        uint32_t firstDrawCommand = 0; // Indirect draw commands written by the mesh culler (GPU culling only)
+        uint32_t drawCommandCount = 0;
+    };
+
+    // Secondary command buffer recorded by a single thread, together with the state bound to it
+    struct RecordingContext {
+        VulkanCommandBuffer commandBuffer;
+        RenderState renderState{};
+        RendererStatistics statistics{};
+        double recordingTime = 0.0;
+    };
+
     struct RendererConfig {
         FileSystem* fileSystem = nullptr;
         Window* window = nullptr;
         VulkanApp* vulkanApp = nullptr;
         VulkanPhysicalDevice* physicalDevice = nullptr;
         VulkanDevice* device = nullptr;
+        VulkanUploadContext* uploadContext = nullptr;
+        VulkanPipelineCache* pipelineCache = nullptr;
         ShaderManager* shaderManager = nullptr;
         MeshManager* meshManager = nullptr;
         SkyboxManager* skyboxManager = nullptr;
+        ThreadPool* threadPool = nullptr;
+        bool gpuCullingEnabled = false;
+        FramePacing framePacing{};
     };
 
     class Renderer {
     private:
         static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+        static constexpr double INPUT_LATENCY_SMOOTHING = 0.1; // Weight of the latest frame in the smoothed latencies
+        static constexpr uint32_t MAX_ADDITIONAL_IMAGES = 2;
+        static constexpr uint32_t MAX_PENDING_PRESENTS = 8; // Presentations that are not seen presented by then are no longer measured
+        static constexpr std::array<VkPresentModeKHR, 4> PRESENT_MODES = {
+            VK_PRESENT_MODE_FIFO_KHR,
+            VK_PRESENT_MODE_FIFO_RELAXED_KHR,
+            VK_PRESENT_MODE_MAILBOX_KHR,
+            VK_PRESENT_MODE_IMMEDIATE_KHR,
+        };
+        static constexpr uint32_t MAX_MESH_INSTANCES = 10000;
+        static constexpr VkDeviceSize FRAME_DATA_SIZE = sizeof(MeshInstanceData) * MAX_MESH_INSTANCES + 64 * 1024;
+        static constexpr uint32_t MAX_RECORDING_THREADS = 8;
+        static constexpr uint32_t MIN_DRAWS_PER_RECORDING_THREAD = 64;
 
     private:
         RendererConfig config;
         VulkanSwapChain* swapChain = nullptr;
         VulkanCommandPool* commandPool = nullptr;
         std::vector<VulkanCommandBuffer> commandBuffers;
-        std::vector<VulkanUniformBuffer*> viewProjectionUniformBuffers;
+        uint32_t recordingThreadCount = 0;
+        std::vector<VulkanCommandPool*> recordingCommandPools; // One per recording thread per frame in flight
+        std::vector<VulkanCommandBuffer> recordingCommandBuffers; // One per recording command pool
+        std::vector<RecordingContext> recordingContexts; // One per recording thread
+        VulkanRingBuffer* frameDataBuffer = nullptr;
         VkDescriptorPool viewProjectionDescriptorPool = nullptr;
         VkDescriptorSetLayout viewProjectionDescriptorSetLayout = nullptr;
-        std::vector<VkDescriptorSet> viewProjectionDescriptorSets;
+        VkDescriptorSet viewProjectionDescriptorSet = nullptr;
+        uint32_t viewProjectionOffset = 0;
+        glm::mat4 view = glm::mat4(1.0f);
+        glm::mat4 projection = glm::mat4(1.0f);
+        glm::mat4 viewProjectionMatrix = glm::mat4(1.0f);
+        MeshCuller* meshCuller = nullptr;
+        uint32_t maxIndirectDrawCount = 1; // Draw commands per indirect draw call, more than one needs multiDrawIndirect
+        float lodScreenSize = 0.5f;
+        float lodBias = 1.0f;
+        GpuProfiler* gpuProfiler = nullptr;
+        bool gpuCullingEnabled = false;
+        bool gpuCullingActive = false; // Whether the current frame is culled on the GPU
+        std::vector<MeshInstance> meshInstances;
+        std::vector<MeshDraw> meshDraws;
+        std::array<uint32_t, Mesh::MAX_LODS> lodTriangles{};
+        VkBuffer instanceBuffer = nullptr;
+        VkDeviceSize instanceBufferOffset = 0;
+        std::shared_ptr<Skybox> skybox = nullptr;
+        std::unordered_map<VkPipeline, uint32_t> pipelineIds;
+        std::unordered_map<VkDescriptorSet, uint32_t> descriptorSetIds;
+        std::unordered_map<VkBuffer, uint32_t> geometryIds;
+        RendererStatistics statistics{};
         VulkanGraphicsPipeline* meshGraphicsPipeline = nullptr;
+        VulkanGraphicsPipeline* coloredMeshGraphicsPipeline = nullptr;
         VulkanGraphicsPipeline* skyboxGraphicsPipeline = nullptr;
         VulkanCommandBuffer currentCommandBuffer;
         uint32_t currentFrame = 0;
+        FramePacing framePacing{};
+        FramePacing pendingFramePacing{}; // Applied before the next frame, see waitForNextFrame
+        bool framePacingChanged = false;
+        std::array<double, MAX_FRAMES_IN_FLIGHT> frameInputTimes{}; // Seconds, negative once the frame's latency is measured
+        std::vector<PendingPresent> pendingPresents; // In the order they were presented
+        double inputToFrameFenceLatency = 0.0;
+        double inputToPresentLatency = 0.0;
 
     public:
         explicit Renderer(const RendererConfig& config);
@@ -53,19 +183,86 @@ namespace Blink {
 
         void onEvent(Event& event);
 
-        bool beginFrame();
+        const FramePacing& getFramePacing() const;
+
+        // Takes effect before the next frame
+        void setFramePacing(const FramePacing& framePacing);
+
+        // The present mode of the frame pacing if the surface supports it, FIFO otherwise
+        VkPresentModeKHR getPresentMode() const;
+
+        // Call before sampling the input of the next frame
+        void waitForNextFrame();
+
+        // The input time is when the input the frame is rendered from was sampled (see Window::update)
+        bool beginFrame(double inputTime);
+
+        void setViewProjection(const ViewProjection& viewProjection);
+
+        void renderSkybox(const std::shared_ptr<Skybox>& skybox);
+
+        // Ignored while GPU culling is active, which draws the mesh objects instead
+        void renderMesh(const std::shared_ptr<Mesh>& mesh, const glm::mat4& model, uint32_t lod = 0);
+
+        // Used to select the level of detail of mesh objects on the GPU (see Scene::selectLod)
+        void setMeshLodSelection(float screenSize, float bias);
 
-        void setViewProjection(const ViewProjection& viewProjection) const;
+        //
+        // Mesh objects are kept on the GPU and drawn while GPU culling is active. They only have to be updated when
+        // they change, instead of being submitted with renderMesh every frame. The object ids are those of the mesh
+        // culler (MeshCuller::INVALID_OBJECT if an object could not be added).
+        //
+        uint32_t addMeshObject(const std::shared_ptr<Mesh>& mesh, const glm::mat4& model);
 
-        void renderSkybox(const std::shared_ptr<Skybox>& skybox) const;
+        void updateMeshObject(uint32_t objectId, const glm::mat4& model);
 
-        void renderMesh(const std::shared_ptr<Mesh>& mesh) const;
+        void setMeshObjectEnabled(uint32_t objectId, bool enabled);
+
+        // Must only be called when the GPU is idle
+        void clearMeshObjects();
 
         void endFrame();
 
+        // Statistics of the last completed frame
+        const RendererStatistics& getStatistics() const;
+
+        // Whether mesh objects can be added, GPU culling can be toggled at runtime when it is supported
+        bool isGpuCullingSupported() const;
+
+        // Mesh objects are drawn instead of the meshes rendered with renderMesh during a frame with GPU culling
+        bool isGpuCullingActive() const;
+
     private:
         void reloadShaders();
 
+        void applyFramePacing();
+
+        void updateInputLatencies();
+
+        static double smoothLatency(double smoothedLatency, double latency);
+
+        void prepareMeshDraws();
+
+        void prepareIndirectMeshDraws();
+
+        void recordCommandBuffers();
+
+        void recordCommandBuffer(uint32_t threadIndex, uint32_t threadCount, uint32_t firstDraw, uint32_t lastDraw);
+
+        void recordSkybox(RecordingContext* context) const;
+
+        void recordMeshDraws(RecordingContext* context, uint32_t firstDraw, uint32_t lastDraw) const;
+
+        uint64_t getSortKey(const VulkanGraphicsPipeline* pipeline, const Mesh* mesh, uint32_t lod, const glm::mat4& model);
+
+        void bindPipeline(RecordingContext* context, const VulkanGraphicsPipeline* pipeline) const;
+
+        void bindDescriptorSets(RecordingContext* context, const VulkanGraphicsPipeline* pipeline, VkDescriptorSet objectDescriptorSet) const;
+
+        static void bindVertexBuffer(RecordingContext* context, VkBuffer vertexBuffer);
+
+        static void bindIndexBuffer(RecordingContext* context, const VulkanIndexBuffer& indexBuffer);
+
         void createCommandObjects();
 
         void destroyCommandObjects() const;
@@ -74,16 +271,28 @@ namespace Blink {
 
         void destroySwapChain() const;
 
-        void createUniformBuffers();
+        void createFrameDataBuffer();
 
-        void destroyUniformBuffers();
+        void destroyFrameDataBuffer() const;
 
         void createDescriptorObjects();
 
         void destroyDescriptorObjects() const;
 
+        void createMeshCuller();
+
+        void destroyMeshCuller() const;
+
+        void createGpuProfiler();
+
+        void destroyGpuProfiler() const;
+
         void createGraphicsPipelines();
 
+        VulkanGraphicsPipeline* createMeshGraphicsPipeline(const std::string& vertexShaderPath, MeshVertexFormat vertexFormat) const;
+
+        VulkanGraphicsPipeline* getMeshGraphicsPipeline(const Mesh* mesh) const;
+
         void destroyGraphicsPipelines() const;
     };
 }
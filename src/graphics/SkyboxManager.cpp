@@ -29,17 +29,20 @@ namespace Blink {
     };
 
     SkyboxManager::SkyboxManager(const SkyboxManagerConfig& config) : config(config) {
-        createCommandPool();
-        createDescriptorPool();
+        createDescriptorAllocator();
         createDescriptorSetLayout();
         createSampler();
     }
 
     SkyboxManager::~SkyboxManager() {
+        for (const auto& [key, preload] : preloads) {
+            for (const std::future<void>& task : preload->tasks) {
+                task.wait();
+            }
+        }
         destroySampler();
         destroyDescriptorSetLayout();
-        destroyDescriptorPool();
-        destroyCommandPool();
+        destroyDescriptorAllocator();
     }
 
     VkDescriptorSetLayout SkyboxManager::getDescriptorSetLayout() const {
@@ -48,8 +51,7 @@ namespace Blink {
 
     void SkyboxManager::clear() {
         cache.clear();
-        destroyDescriptorPool();
-        createDescriptorPool();
+        descriptorAllocator->reset();
     }
 
     std::shared_ptr<Skybox> SkyboxManager::getSkybox(const std::vector<std::string>& paths) {
@@ -62,43 +64,85 @@ namespace Blink {
         if (iterator != cache.end()) {
             return iterator->second;
         }
-        std::shared_ptr<Skybox> skybox = loadSkybox(paths);
+        std::shared_ptr<Skybox> skybox = loadSkybox(readImages(paths));
         cache[key] = skybox;
         return skybox;
     }
 
-    std::shared_ptr<Skybox> SkyboxManager::loadSkybox(const std::vector<std::string>& paths) const {
+    void SkyboxManager::preloadSkybox(const std::vector<std::string>& paths) {
+        BL_ASSERT_THROW(paths.size() == Skybox::FACE_COUNT);
+
+        const std::string& key = paths[0];
+        BL_ASSERT_THROW(!key.empty());
+
+        // Cached skyboxes are not checked since the cache is cleared when the scene is unloaded
+        if (preloads.find(key) != preloads.end()) {
+            return;
+        }
+        auto preload = std::make_shared<SkyboxPreload>();
+        preload->imageFiles.resize(paths.size());
+        for (uint32_t i = 0; i < paths.size(); i++) {
+            preload->tasks.push_back(config.threadPool->submit([this, preload, path = paths[i], i]() {
+                preload->imageFiles[i] = config.textureLoader->readTexture(path);
+            }));
+        }
+        preloads[key] = preload;
+    }
+
+    bool SkyboxManager::isPreloaded() const {
+        for (const auto& [key, preload] : preloads) {
+            for (const std::future<void>& task : preload->tasks) {
+                if (task.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Uses the preloaded faces if the skybox has been preloaded, waiting for the preload if it is still running
+    std::vector<std::shared_ptr<ImageFile>> SkyboxManager::readImages(const std::vector<std::string>& paths) {
+        const auto iterator = preloads.find(paths[0]);
+        if (iterator != preloads.end()) {
+            std::shared_ptr<SkyboxPreload> preload = iterator->second;
+            preloads.erase(iterator);
+            // Rethrows errors from the worker threads
+            for (std::future<void>& task : preload->tasks) {
+                task.get();
+            }
+            return preload->imageFiles;
+        }
         std::vector<std::shared_ptr<ImageFile>> imageFiles;
         for (int i = 0; i < Skybox::FACE_COUNT; ++i) {
-            imageFiles.push_back(config.fileSystem->readImage(paths[i]));
+            imageFiles.push_back(config.textureLoader->readTexture(paths[i]));
+        }
+        return imageFiles;
+    }
+
+    std::shared_ptr<Skybox> SkyboxManager::loadSkybox(const std::vector<std::shared_ptr<ImageFile>>& imageFiles) const {
+        BL_ASSERT_THROW(imageFiles.size() == Skybox::FACE_COUNT);
+
+        // The faces of a cube image share a single format, which only happens if they all have the same variant
+        for (const std::shared_ptr<ImageFile>& imageFile : imageFiles) {
+            BL_ASSERT_THROW(imageFile->format == imageFiles[0]->format);
+            BL_ASSERT_THROW(imageFile->levels.size() == imageFiles[0]->levels.size());
         }
-        BL_ASSERT_THROW(imageFiles.size() == paths.size());
 
         VulkanImageConfig imageConfig{};
         imageConfig.device = config.device;
-        imageConfig.commandPool = commandPool;
         imageConfig.width = imageFiles[0]->width;
         imageConfig.height = imageFiles[0]->height;
         imageConfig.layerCount = imageFiles.size();
+        imageConfig.mipLevels = config.uploadContext->getMipLevelCount(imageFiles[0]);
         imageConfig.imageViewType = VK_IMAGE_VIEW_TYPE_CUBE;
         imageConfig.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-        imageConfig.format = VK_FORMAT_R8G8B8A8_SRGB;
-        imageConfig.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageConfig.format = imageFiles[0]->format;
+        imageConfig.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
         auto image = std::make_shared<VulkanImage>(imageConfig);
-        image->setLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        image->setData(imageFiles);
-        image->setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-        VkDescriptorSet descriptorSet;
-
-        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
-        descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        descriptorSetAllocateInfo.descriptorPool = descriptorPool;
-        descriptorSetAllocateInfo.descriptorSetCount = 1;
-        descriptorSetAllocateInfo.pSetLayouts = &descriptorSetLayout;
+        config.uploadContext->uploadImage(image.get(), imageFiles);
 
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->allocateDescriptorSets(&descriptorSetAllocateInfo, &descriptorSet));
+        VkDescriptorSet descriptorSet = descriptorAllocator->allocate(descriptorSetLayout);
 
         VkDescriptorImageInfo descriptorImageInfo{};
         descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -118,17 +162,17 @@ namespace Blink {
 
         VulkanVertexBufferConfig vertexBufferConfig{};
         vertexBufferConfig.device = config.device;
-        vertexBufferConfig.commandPool = commandPool;
+        vertexBufferConfig.uploadContext = config.uploadContext;
         vertexBufferConfig.size = sizeof(SKYBOX_VERTICES[0]) * SKYBOX_VERTICES.size();
         auto vertexBuffer = std::make_shared<VulkanVertexBuffer>(vertexBufferConfig);
-        vertexBuffer->setData((void*) SKYBOX_VERTICES.data());
+        vertexBuffer->setData(SKYBOX_VERTICES.data());
 
         VulkanIndexBufferConfig indexBufferConfig{};
         indexBufferConfig.device = config.device;
-        indexBufferConfig.commandPool = commandPool;
+        indexBufferConfig.uploadContext = config.uploadContext;
         indexBufferConfig.size = sizeof(SKYBOX_INDICES[0]) * SKYBOX_INDICES.size();
         auto indexBuffer = std::make_shared<VulkanIndexBuffer>(indexBufferConfig);
-        indexBuffer->setData((void*) SKYBOX_INDICES.data());
+        indexBuffer->setData(SKYBOX_INDICES.data());
 
         auto skybox = std::make_shared<Skybox>();
         skybox->image = image;
@@ -140,32 +184,18 @@ namespace Blink {
         return skybox;
     }
 
-    void SkyboxManager::createCommandPool() {
-        VulkanCommandPoolConfig commandPoolConfig{};
-        commandPoolConfig.device = config.device;
-        commandPool = new VulkanCommandPool(commandPoolConfig);
-    }
-
-    void SkyboxManager::destroyCommandPool() const {
-        delete commandPool;
-    }
-
-    void SkyboxManager::createDescriptorPool() {
-        VkDescriptorPoolSize samplerPoolSize{};
-        samplerPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        samplerPoolSize.descriptorCount = MAX_SKYBOXES;
-
-        VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
-        descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        descriptorPoolCreateInfo.poolSizeCount = 1;
-        descriptorPoolCreateInfo.pPoolSizes = &samplerPoolSize;
-        descriptorPoolCreateInfo.maxSets = MAX_SKYBOXES;
-
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorPool(&descriptorPoolCreateInfo, &descriptorPool));
+    void SkyboxManager::createDescriptorAllocator() {
+        VulkanDescriptorAllocatorConfig descriptorAllocatorConfig{};
+        descriptorAllocatorConfig.device = config.device;
+        descriptorAllocatorConfig.descriptorsPerSet = {
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1}
+        };
+        descriptorAllocatorConfig.setsPerPool = SKYBOXES_PER_DESCRIPTOR_POOL;
+        descriptorAllocator = new VulkanDescriptorAllocator(descriptorAllocatorConfig);
     }
 
-    void SkyboxManager::destroyDescriptorPool() const {
-        config.device->destroyDescriptorPool(descriptorPool);
+    void SkyboxManager::destroyDescriptorAllocator() const {
+        delete descriptorAllocator;
     }
 
     void SkyboxManager::createDescriptorSetLayout() {
@@ -201,7 +231,7 @@ namespace Blink {
         samplerCreateInfo.mipLodBias = 0.0f;
         samplerCreateInfo.compareOp = VK_COMPARE_OP_NEVER;
         samplerCreateInfo.minLod = 0.0f;
-        samplerCreateInfo.maxLod = 1.0f;
+        samplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE;
         samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
         samplerCreateInfo.maxAnisotropy = physicalDevice->getProperties().limits.maxSamplerAnisotropy;
         samplerCreateInfo.anisotropyEnable = VK_TRUE;
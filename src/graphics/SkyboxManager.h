@@ -4,33 +4,45 @@
 #include "graphics/ViewProjection.h"
 #include "graphics/VulkanIndexBuffer.h"
 #include "graphics/VulkanVertexBuffer.h"
+#include "graphics/VulkanDescriptorAllocator.h"
 #include "graphics/VulkanDevice.h"
 #include "graphics/VulkanSwapChain.h"
-#include "graphics/VulkanCommandPool.h"
+#include "graphics/VulkanUploadContext.h"
 #include "graphics/VulkanUniformBuffer.h"
 #include "graphics/VulkanImage.h"
 #include "graphics/VulkanGraphicsPipeline.h"
 #include "graphics/VulkanShader.h"
 #include "graphics/ShaderManager.h"
 #include "graphics/Skybox.h"
+#include "graphics/TextureLoader.h"
+#include "system/ThreadPool.h"
 
 namespace Blink {
+    // Skybox faces being decoded on worker threads ahead of the scene that uses them
+    struct SkyboxPreload {
+        std::vector<std::shared_ptr<ImageFile>> imageFiles;
+        std::vector<std::future<void>> tasks;
+    };
+
     struct SkyboxManagerConfig {
         FileSystem* fileSystem = nullptr;
+        ThreadPool* threadPool = nullptr;
         VulkanDevice* device = nullptr;
+        VulkanUploadContext* uploadContext = nullptr;
+        TextureLoader* textureLoader = nullptr;
     };
 
     class SkyboxManager {
     private:
-        static constexpr uint32_t MAX_SKYBOXES = 10;
+        static constexpr uint32_t SKYBOXES_PER_DESCRIPTOR_POOL = 4;
         static const std::vector<SkyboxVertex> SKYBOX_VERTICES;
         static const std::vector<uint32_t> SKYBOX_INDICES;
 
     private:
         SkyboxManagerConfig config;
         std::map<std::string, std::shared_ptr<Skybox>> cache;
-        VulkanCommandPool* commandPool = nullptr;
-        VkDescriptorPool descriptorPool = nullptr;
+        std::map<std::string, std::shared_ptr<SkyboxPreload>> preloads;
+        VulkanDescriptorAllocator* descriptorAllocator = nullptr;
         VkDescriptorSetLayout descriptorSetLayout = nullptr;
         VkSampler sampler = nullptr;
 
@@ -45,16 +57,19 @@ namespace Blink {
 
         std::shared_ptr<Skybox> getSkybox(const std::vector<std::string>& paths);
 
-    private:
-        std::shared_ptr<Skybox> loadSkybox(const std::vector<std::string>& paths) const;
+        // Starts decoding the faces of the skybox in the background without blocking, see isPreloaded
+        void preloadSkybox(const std::vector<std::string>& paths);
 
-        void createCommandPool();
+        bool isPreloaded() const;
+
+    private:
+        std::vector<std::shared_ptr<ImageFile>> readImages(const std::vector<std::string>& paths);
 
-        void destroyCommandPool() const;
+        std::shared_ptr<Skybox> loadSkybox(const std::vector<std::shared_ptr<ImageFile>>& imageFiles) const;
 
-        void createDescriptorPool();
+        void createDescriptorAllocator();
 
-        void destroyDescriptorPool() const;
+        void destroyDescriptorAllocator() const;
 
         void createDescriptorSetLayout();
 
@@ -0,0 +1,40 @@
+#include "pch.h"
+#include "TextureCompression.h"
+#include "system/Ktx2File.h"
+
+namespace Blink {
+    TextureCompression::TextureCompression(const TextureCompressionConfig& config) : config(config) {
+        const VkPhysicalDeviceFeatures& features = config.physicalDevice->getFeatures();
+        if (features.textureCompressionBC && isSupported({VK_FORMAT_BC1_RGB_SRGB_BLOCK, VK_FORMAT_BC3_SRGB_BLOCK, VK_FORMAT_BC7_SRGB_BLOCK})) {
+            variants.emplace_back(Ktx2File::BC_VARIANT);
+        }
+        if (features.textureCompressionETC2 && isSupported({VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK})) {
+            variants.emplace_back(Ktx2File::ETC2_VARIANT);
+        }
+        if (variants.empty()) {
+            BL_LOG_WARN("Device does not support any block-compressed texture formats, using uncompressed textures");
+        } else {
+            BL_LOG_INFO("Using block-compressed texture variant [{}]", variants[0]);
+        }
+    }
+
+    std::string TextureCompression::getTexturePath(const std::string& imagePath) const {
+        for (const std::string& variant : variants) {
+            std::string variantPath = Ktx2File::getVariantPath(imagePath, variant);
+            if (config.fileSystem->exists(variantPath)) {
+                return variantPath;
+            }
+        }
+        return imagePath;
+    }
+
+    bool TextureCompression::isSupported(const std::vector<VkFormat>& formats) const {
+        constexpr VkFormatFeatureFlags requiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        for (VkFormat format : formats) {
+            if (!config.physicalDevice->isFormatSupported(format, requiredFeatures)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
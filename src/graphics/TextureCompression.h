@@ -0,0 +1,35 @@
+#pragma once
+
+#include "graphics/VulkanPhysicalDevice.h"
+#include "system/FileSystem.h"
+
+#include <string>
+#include <vector>
+
+namespace Blink {
+    struct TextureCompressionConfig {
+        FileSystem* fileSystem = nullptr;
+        VulkanPhysicalDevice* physicalDevice = nullptr;
+    };
+
+    //
+    // Picks the block-compressed variant of a texture that the device can sample from, falling back to the source
+    // image when there is none.
+    //
+    // The variants are KTX2 files written next to the source images by the TextureConverter tool. Block-compressed
+    // textures use 4-8 times less memory and upload bandwidth than RGBA8 textures, and are sampled from directly.
+    //
+    class TextureCompression {
+    private:
+        TextureCompressionConfig config;
+        std::vector<std::string> variants; // In order of preference
+
+    public:
+        explicit TextureCompression(const TextureCompressionConfig& config);
+
+        std::string getTexturePath(const std::string& imagePath) const;
+
+    private:
+        bool isSupported(const std::vector<VkFormat>& formats) const;
+    };
+}
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "TextureFile.h"
+
+namespace Blink {
+    std::vector<char> TextureFile::write(const ImageFile& imageFile, uint64_t sourceHash) {
+        TextureFileHeader header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.sourceHash = sourceHash;
+        header.format = (uint32_t) imageFile.format;
+        header.width = (uint32_t) imageFile.width;
+        header.height = (uint32_t) imageFile.height;
+        header.channels = (uint32_t) imageFile.channels;
+
+        // The texels start aligned so that they can be copied into staging memory in place
+        header.dataOffset = alignUp(sizeof(TextureFileHeader));
+        header.dataSize = imageFile.size;
+
+        std::vector<char> bytes(header.dataOffset + header.dataSize, 0);
+        memcpy(bytes.data(), &header, sizeof(TextureFileHeader));
+        memcpy(bytes.data() + header.dataOffset, imageFile.pixels, header.dataSize);
+        return bytes;
+    }
+
+    bool TextureFile::read(const char* data, uint64_t size, uint64_t sourceHash, ImageFile* imageFile) {
+        if (size < sizeof(TextureFileHeader)) {
+            return false;
+        }
+        TextureFileHeader header{};
+        memcpy(&header, data, sizeof(TextureFileHeader));
+        if (header.magic != MAGIC || header.version != VERSION || header.sourceHash != sourceHash) {
+            return false;
+        }
+        if (header.dataSize != (uint64_t) header.width * header.height * 4 || header.dataOffset + header.dataSize > size) {
+            return false;
+        }
+
+        imageFile->format = (VkFormat) header.format;
+        imageFile->width = (int32_t) header.width;
+        imageFile->height = (int32_t) header.height;
+        imageFile->channels = (int32_t) header.channels;
+        imageFile->size = header.dataSize;
+        imageFile->pixels = (unsigned char*) data + header.dataOffset;
+        return true;
+    }
+
+    uint64_t TextureFile::alignUp(uint64_t value) {
+        return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+}
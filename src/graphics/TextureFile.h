@@ -0,0 +1,44 @@
+#pragma once
+
+#include "system/ImageFile.h"
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace Blink {
+    // Fixed size header at the start of a decoded texture file, followed by the texels
+    struct TextureFileHeader {
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint64_t sourceHash = 0; // Hash of the image file the texels were decoded from
+        uint32_t format = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t channels = 0; // Channels of the source image, the texels always have four
+        uint64_t dataOffset = 0;
+        uint64_t dataSize = 0;
+    };
+
+    //
+    // Decoded texture file (.bltex) with the RGBA8 texels of a JPG or PNG image, written the first time the image is
+    // loaded so that later loads copy the texels straight from the memory mapped file instead of decoding the image.
+    //
+    // The file stores the hash of the image it was decoded from, a file whose hash (or format version) doesn't match
+    // is ignored and the image is decoded again.
+    //
+    class TextureFile {
+    public:
+        static constexpr uint32_t MAGIC = 0x58544C42; // "BLTX"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr uint64_t ALIGNMENT = 16;
+
+    public:
+        static std::vector<char> write(const ImageFile& imageFile, uint64_t sourceHash);
+
+        // Points the image into the bytes, returns false if they are not a valid decoded texture of the source
+        static bool read(const char* data, uint64_t size, uint64_t sourceHash, ImageFile* imageFile);
+
+    private:
+        static uint64_t alignUp(uint64_t value);
+    };
+}
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "TextureLoader.h"
+
+namespace Blink {
+    TextureLoader::TextureLoader(const TextureLoaderConfig& config) : config(config) {
+    }
+
+    std::shared_ptr<ImageFile> TextureLoader::readTexture(const std::string& imagePath) const {
+        std::string texturePath = config.textureCompression->getTexturePath(imagePath);
+        if (texturePath != imagePath) {
+            return config.fileSystem->readImage(texturePath);
+        }
+
+        // Hashing the image is much cheaper than decoding it
+        std::shared_ptr<MappedFile> sourceFile = config.fileSystem->mapFile(imagePath);
+        uint64_t sourceHash = hashFnv1a(sourceFile->getData(), sourceFile->getSize());
+
+        std::string textureFilePath = getTextureFilePath(imagePath);
+        if (config.fileSystem->exists(textureFilePath)) {
+            auto imageFile = std::make_shared<ImageFile>();
+            imageFile->mappedFile = config.fileSystem->mapFile(textureFilePath);
+            if (TextureFile::read(imageFile->mappedFile->getData(), imageFile->mappedFile->getSize(), sourceHash, imageFile.get())) {
+                BL_LOG_DEBUG("Loaded decoded texture [{}]", textureFilePath);
+                return imageFile;
+            }
+            BL_LOG_INFO("Discarding outdated decoded texture [{}]", textureFilePath);
+        }
+
+        return decodeTexture(imagePath, sourceHash);
+    }
+
+    // Decode the image and write the result to its decoded texture file
+    std::shared_ptr<ImageFile> TextureLoader::decodeTexture(const std::string& imagePath, uint64_t sourceHash) const {
+        std::shared_ptr<ImageFile> imageFile = config.fileSystem->readImage(imagePath);
+
+        std::string textureFilePath = getTextureFilePath(imagePath);
+        try {
+            std::vector<char> bytes = TextureFile::write(*imageFile, sourceHash);
+            config.fileSystem->writeBytes(textureFilePath, bytes);
+            BL_LOG_INFO("Decoded texture [{}], data [{} bytes]", textureFilePath, bytes.size());
+        } catch (const Error& e) {
+            BL_LOG_WARN("Could not save decoded texture [{}]: {}", textureFilePath, e.what());
+        }
+        return imageFile;
+    }
+
+    std::string TextureLoader::getTextureFilePath(const std::string& imagePath) {
+        return imagePath.substr(0, imagePath.find_last_of('.')) + ".bltex";
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "graphics/TextureCompression.h"
+#include "graphics/TextureFile.h"
+#include "system/FileSystem.h"
+
+#include <string>
+
+namespace Blink {
+    struct TextureLoaderConfig {
+        FileSystem* fileSystem = nullptr;
+        TextureCompression* textureCompression = nullptr;
+    };
+
+    //
+    // Reads the texels of mesh and skybox textures without decoding image files more than once.
+    //
+    // Block-compressed variants of a texture are used when the device supports them. Otherwise the texels are read
+    // from the decoded texture file of the image, which is written the first time the image is decoded. Both are
+    // memory mapped, so their texels are copied straight into staging memory.
+    //
+    // Safe to call from the worker threads, as long as they read different images.
+    //
+    class TextureLoader {
+    private:
+        TextureLoaderConfig config;
+
+    public:
+        explicit TextureLoader(const TextureLoaderConfig& config);
+
+        std::shared_ptr<ImageFile> readTexture(const std::string& imagePath) const;
+
+    private:
+        std::shared_ptr<ImageFile> decodeTexture(const std::string& imagePath, uint64_t sourceHash) const;
+
+        // The decoded texture file is written next to the image file
+        static std::string getTextureFilePath(const std::string& imagePath);
+    };
+}
@@ -13,69 +13,37 @@ namespace Blink {
 
         const VkMemoryRequirements& memoryRequirements = config.device->getBufferMemoryRequirements(buffer);
 
-        VulkanPhysicalDevice* physicalDevice = config.device->getPhysicalDevice();
-        uint32_t memoryTypeIndex = physicalDevice->getMemoryTypeIndex(memoryRequirements, config.memoryProperties);
+        VulkanMemoryAllocator* memoryAllocator = config.device->getMemoryAllocator();
+        memoryAllocation = memoryAllocator->allocate(memoryRequirements, config.memoryProperties, VulkanMemoryResourceType::Buffer, config.memoryStrategy);
 
-        VkMemoryAllocateInfo memoryAllocateInfo{};
-        memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        memoryAllocateInfo.allocationSize = memoryRequirements.size;
-        memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
-
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->allocateMemory(&memoryAllocateInfo, &memory));
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->bindBufferMemory(buffer, memory));
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->bindBufferMemory(buffer, memoryAllocation.memory, memoryAllocation.offset));
     }
 
     VulkanBuffer::~VulkanBuffer() {
         config.device->destroyBuffer(buffer);
-        config.device->freeMemory(memory);
+        config.device->getMemoryAllocator()->free(memoryAllocation);
     }
 
     VulkanBuffer::operator VkBuffer() const {
         return buffer;
     }
 
-    void VulkanBuffer::setData(void* src) const {
-        void* dst;
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->mapMemory(memory, config.size, &dst));
-        memcpy(dst, src, config.size);
-        config.device->unmapMemory(memory);
+    VkDeviceSize VulkanBuffer::getSize() const {
+        return config.size;
     }
 
-    void VulkanBuffer::copyTo(VulkanBuffer* destinationBuffer) {
-        copy(this, destinationBuffer, config.device, config.commandPool);
+    void* VulkanBuffer::getMappedData() const {
+        return memoryAllocation.mappedData;
     }
 
-    void VulkanBuffer::copyFrom(VulkanBuffer* sourceBuffer) {
-        copy(sourceBuffer, this, config.device, config.commandPool);
+    void VulkanBuffer::setData(const void* src) const {
+        setData(src, config.size);
     }
 
-    void VulkanBuffer::copy(
-        VulkanBuffer* sourceBuffer,
-        VulkanBuffer* destinationBuffer,
-        VulkanDevice* device,
-        VulkanCommandPool* commandPool
-    ) {
-        BL_ASSERT(sourceBuffer->config.size == destinationBuffer->config.size);
-
-        VulkanCommandBuffer commandBuffer;
-        BL_ASSERT_THROW_VK_SUCCESS(commandPool->allocateCommandBuffer(&commandBuffer));
-        BL_ASSERT_THROW_VK_SUCCESS(commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
-
-        VkBufferCopy copyRegion{};
-        copyRegion.size = sourceBuffer->config.size;
-        constexpr uint32_t regionCount = 1;
-        vkCmdCopyBuffer(commandBuffer, sourceBuffer->buffer, destinationBuffer->buffer, regionCount, &copyRegion);
-
-        BL_ASSERT_THROW_VK_SUCCESS(commandBuffer.end());
-
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = commandBuffer.vk_ptr();
-
-        BL_ASSERT_THROW_VK_SUCCESS(device->submitToGraphicsQueue(&submitInfo));
-        BL_ASSERT_THROW_VK_SUCCESS(device->waitUntilGraphicsQueueIsIdle());
-
-        commandPool->freeCommandBuffer(&commandBuffer);
+    void VulkanBuffer::setData(const void* src, VkDeviceSize size, VkDeviceSize offset) const {
+        // Host visible memory blocks are persistently mapped by the memory allocator
+        BL_ASSERT_THROW(memoryAllocation.mappedData != nullptr);
+        BL_ASSERT(offset + size <= config.size);
+        memcpy((char*) memoryAllocation.mappedData + offset, src, size);
     }
 }
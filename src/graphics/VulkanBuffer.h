@@ -1,7 +1,6 @@
 #pragma once
 
 #include "VulkanDevice.h"
-#include "VulkanCommandPool.h"
 
 #include <vulkan/vulkan.h>
 
@@ -9,17 +8,17 @@ namespace Blink {
 
     struct VulkanBufferConfig {
         VulkanDevice* device;
-        VulkanCommandPool* commandPool;
         VkDeviceSize size = 0;
         VkBufferUsageFlags usage = 0;
         VkMemoryPropertyFlags memoryProperties = 0;
+        VulkanMemoryStrategy memoryStrategy = VulkanMemoryStrategy::FreeList;
     };
 
     class VulkanBuffer {
     private:
         VulkanBufferConfig config;
         VkBuffer buffer = nullptr;
-        VkDeviceMemory memory = nullptr;
+        VulkanMemoryAllocation memoryAllocation{};
 
     public:
         explicit VulkanBuffer(const VulkanBufferConfig& config);
@@ -28,18 +27,13 @@ namespace Blink {
 
         operator VkBuffer() const;
 
-        void setData(void* src) const;
+        VkDeviceSize getSize() const;
 
-        void copyFrom(VulkanBuffer* sourceBuffer);
+        // Only set for host visible memory, which is persistently mapped
+        void* getMappedData() const;
 
-        void copyTo(VulkanBuffer* destinationBuffer);
+        void setData(const void* src) const;
 
-    public:
-        static void copy(
-            VulkanBuffer* sourceBuffer,
-            VulkanBuffer* destinationBuffer,
-            VulkanDevice* device,
-            VulkanCommandPool* commandPool
-        );
+        void setData(const void* src, VkDeviceSize size, VkDeviceSize offset = 0) const;
     };
 }
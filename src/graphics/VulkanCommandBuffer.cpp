@@ -30,6 +30,14 @@ namespace Blink {
         return vkBeginCommandBuffer(commandBuffer, &beginInfo);
     }
 
+    VkResult VulkanCommandBuffer::begin(VkCommandBufferUsageFlags usageFlags, const VkCommandBufferInheritanceInfo* inheritanceInfo) const {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = usageFlags;
+        beginInfo.pInheritanceInfo = inheritanceInfo;
+        return vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    }
+
     VkResult VulkanCommandBuffer::end() const {
         return vkEndCommandBuffer(commandBuffer);
     }
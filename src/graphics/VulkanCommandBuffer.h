@@ -23,6 +23,9 @@ namespace Blink {
 
         VkResult begin(VkCommandBufferUsageFlags usageFlags = 0) const;
 
+        // Secondary command buffers inherit the render pass (and optionally the framebuffer) they are executed in
+        VkResult begin(VkCommandBufferUsageFlags usageFlags, const VkCommandBufferInheritanceInfo* inheritanceInfo) const;
+
         VkResult end() const;
 
         void reset(VkCommandBufferResetFlags resetFlags = 0) const;
@@ -9,7 +9,7 @@ namespace Blink {
         VkCommandPoolCreateInfo commandPoolCreateInfo{};
         commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
         commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-        commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+        commandPoolCreateInfo.queueFamilyIndex = config.queueFamilyIndex.value_or(queueFamilyIndices.graphicsFamily.value());
 
         BL_ASSERT_THROW_VK_SUCCESS(config.device->createCommandPool(&commandPoolCreateInfo, &commandPool));
     }
@@ -22,11 +22,11 @@ namespace Blink {
         return commandPool;
     }
 
-    VkResult VulkanCommandPool::allocateCommandBuffers(uint32_t count, VkCommandBuffer* commandBuffers) const {
+    VkResult VulkanCommandPool::allocateCommandBuffers(uint32_t count, VkCommandBuffer* commandBuffers, VkCommandBufferLevel level) const {
         VkCommandBufferAllocateInfo allocateInfo{};
         allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocateInfo.commandPool = commandPool;
-        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.level = level;
         allocateInfo.commandBufferCount = count;
         return config.device->allocateCommandBuffers(&allocateInfo, commandBuffers);
     }
@@ -43,8 +43,8 @@ namespace Blink {
         freeCommandBuffers(commandBuffers->size(), commandBuffers->data());
     }
 
-    VkResult VulkanCommandPool::allocateCommandBuffers(std::vector<VulkanCommandBuffer>* commandBuffers) const {
-        return allocateCommandBuffers(commandBuffers->size(), (VkCommandBuffer*) commandBuffers->data());
+    VkResult VulkanCommandPool::allocateCommandBuffers(std::vector<VulkanCommandBuffer>* commandBuffers, VkCommandBufferLevel level) const {
+        return allocateCommandBuffers(commandBuffers->size(), (VkCommandBuffer*) commandBuffers->data(), level);
     }
 
     void VulkanCommandPool::freeCommandBuffers(std::vector<VulkanCommandBuffer>* commandBuffers) const {
@@ -6,6 +6,7 @@
 namespace Blink {
     struct VulkanCommandPoolConfig {
         VulkanDevice* device = nullptr;
+        std::optional<uint32_t> queueFamilyIndex; // Defaults to the graphics queue family
     };
 
     class VulkanCommandPool {
@@ -20,7 +21,7 @@ namespace Blink {
 
         operator VkCommandPool() const;
 
-        VkResult allocateCommandBuffers(uint32_t count, VkCommandBuffer* commandBuffers) const;
+        VkResult allocateCommandBuffers(uint32_t count, VkCommandBuffer* commandBuffers, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) const;
 
         void freeCommandBuffers(uint32_t count, VkCommandBuffer* commandBuffers) const;
 
@@ -28,7 +29,7 @@ namespace Blink {
 
         void freeCommandBuffers(std::vector<VkCommandBuffer>* commandBuffers) const;
 
-        VkResult allocateCommandBuffers(std::vector<VulkanCommandBuffer>* commandBuffers) const;
+        VkResult allocateCommandBuffers(std::vector<VulkanCommandBuffer>* commandBuffers, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) const;
 
         void freeCommandBuffers(std::vector<VulkanCommandBuffer>* commandBuffers) const;
 
@@ -0,0 +1,47 @@
+#include "VulkanComputePipeline.h"
+
+namespace Blink {
+    VulkanComputePipeline::VulkanComputePipeline(const VulkanComputePipelineConfig& config) : config(config) {
+        VkPipelineShaderStageCreateInfo computeShaderStageCreateInfo{};
+        computeShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        computeShaderStageCreateInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        computeShaderStageCreateInfo.module = *config.computeShader;
+        computeShaderStageCreateInfo.pName = "main";
+
+        VkPipelineLayoutCreateInfo layoutCreateInfo{};
+        layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutCreateInfo.setLayoutCount = config.descriptorSetLayouts->size();
+        layoutCreateInfo.pSetLayouts = config.descriptorSetLayouts->data();
+        if (config.pushConstantRanges != nullptr) {
+            layoutCreateInfo.pushConstantRangeCount = config.pushConstantRanges->size();
+            layoutCreateInfo.pPushConstantRanges = config.pushConstantRanges->data();
+        }
+
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->createPipelineLayout(&layoutCreateInfo, &layout));
+
+        VkComputePipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stage = computeShaderStageCreateInfo;
+        pipelineCreateInfo.layout = layout;
+
+        VkPipelineCache pipelineCache = config.pipelineCache != nullptr ? (VkPipelineCache) *config.pipelineCache : nullptr;
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->createComputePipeline(&pipelineCreateInfo, &pipeline, pipelineCache));
+    }
+
+    VulkanComputePipeline::~VulkanComputePipeline() {
+        config.device->destroyComputePipeline(pipeline);
+        config.device->destroyPipelineLayout(layout);
+    }
+
+    VulkanComputePipeline::operator VkPipeline() const {
+        return pipeline;
+    }
+
+    VkPipelineLayout VulkanComputePipeline::getLayout() const {
+        return layout;
+    }
+
+    void VulkanComputePipeline::bind(VkCommandBuffer commandBuffer) const {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "graphics/VulkanDevice.h"
+#include "graphics/VulkanPipelineCache.h"
+#include "graphics/VulkanShader.h"
+
+#include <vulkan/vulkan.h>
+
+namespace Blink {
+    struct VulkanComputePipelineConfig {
+        VulkanDevice* device = nullptr;
+        VulkanPipelineCache* pipelineCache = nullptr;
+        std::shared_ptr<VulkanShader> computeShader;
+        std::vector<VkDescriptorSetLayout>* descriptorSetLayouts;
+        std::vector<VkPushConstantRange>* pushConstantRanges;
+    };
+
+    class VulkanComputePipeline {
+    private:
+        VulkanComputePipelineConfig config;
+        VkPipelineLayout layout = nullptr;
+        VkPipeline pipeline = nullptr;
+
+    public:
+        explicit VulkanComputePipeline(const VulkanComputePipelineConfig& config);
+
+        ~VulkanComputePipeline();
+
+        operator VkPipeline() const;
+
+        VkPipelineLayout getLayout() const;
+
+        void bind(VkCommandBuffer commandBuffer) const;
+    };
+}
@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "VulkanDescriptorAllocator.h"
+
+namespace Blink {
+    VulkanDescriptorAllocator::VulkanDescriptorAllocator(const VulkanDescriptorAllocatorConfig& config) : config(config) {
+        descriptorPools.push_back(createDescriptorPool());
+    }
+
+    VulkanDescriptorAllocator::~VulkanDescriptorAllocator() {
+        for (VkDescriptorPool descriptorPool : descriptorPools) {
+            config.device->destroyDescriptorPool(descriptorPool);
+        }
+    }
+
+    VkDescriptorSet VulkanDescriptorAllocator::allocate(VkDescriptorSetLayout descriptorSetLayout) {
+        VkDescriptorSet descriptorSet = nullptr;
+        VkResult result = allocate(descriptorPools[currentPoolIndex], descriptorSetLayout, &descriptorSet);
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+            // Continue with the next pool, which is left over from before the last reset or created now
+            currentPoolIndex++;
+            if (currentPoolIndex == descriptorPools.size()) {
+                descriptorPools.push_back(createDescriptorPool());
+                BL_LOG_DEBUG("Created descriptor pool [pools: {}, sets per pool: {}]", descriptorPools.size(), config.setsPerPool);
+            }
+            result = allocate(descriptorPools[currentPoolIndex], descriptorSetLayout, &descriptorSet);
+        }
+        BL_ASSERT_THROW_VK_SUCCESS(result);
+        return descriptorSet;
+    }
+
+    void VulkanDescriptorAllocator::reset() {
+        for (uint32_t i = 0; i <= currentPoolIndex; i++) {
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->resetDescriptorPool(descriptorPools[i]));
+        }
+        currentPoolIndex = 0;
+    }
+
+    VkResult VulkanDescriptorAllocator::allocate(VkDescriptorPool descriptorPool, VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet* descriptorSet) const {
+        VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{};
+        descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        descriptorSetAllocateInfo.descriptorPool = descriptorPool;
+        descriptorSetAllocateInfo.descriptorSetCount = 1;
+        descriptorSetAllocateInfo.pSetLayouts = &descriptorSetLayout;
+        return config.device->allocateDescriptorSets(&descriptorSetAllocateInfo, descriptorSet);
+    }
+
+    VkDescriptorPool VulkanDescriptorAllocator::createDescriptorPool() const {
+        std::vector<VkDescriptorPoolSize> descriptorPoolSizes = config.descriptorsPerSet;
+        for (VkDescriptorPoolSize& descriptorPoolSize : descriptorPoolSizes) {
+            descriptorPoolSize.descriptorCount *= config.setsPerPool;
+        }
+
+        VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
+        descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptorPoolCreateInfo.flags = config.poolFlags;
+        descriptorPoolCreateInfo.poolSizeCount = (uint32_t) descriptorPoolSizes.size();
+        descriptorPoolCreateInfo.pPoolSizes = descriptorPoolSizes.data();
+        descriptorPoolCreateInfo.maxSets = config.setsPerPool;
+
+        VkDescriptorPool descriptorPool = nullptr;
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->createDescriptorPool(&descriptorPoolCreateInfo, &descriptorPool));
+        return descriptorPool;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "graphics/VulkanDevice.h"
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+namespace Blink {
+
+    struct VulkanDescriptorAllocatorConfig {
+        VulkanDevice* device = nullptr;
+        std::vector<VkDescriptorPoolSize> descriptorsPerSet; // Multiplied by setsPerPool for the size of each pool
+        uint32_t setsPerPool = 64;
+        VkDescriptorPoolCreateFlags poolFlags = 0;
+    };
+
+    //
+    // Allocates descriptor sets from a chain of descriptor pools, creating another pool when the current one is
+    // exhausted instead of failing.
+    //
+    // Sets are never freed one by one, reset frees every set at once and keeps the pools for the sets allocated after
+    // it (e.g. by the next scene), so pools are only created while the number of sets grows beyond what it has been.
+    //
+    class VulkanDescriptorAllocator {
+    private:
+        VulkanDescriptorAllocatorConfig config;
+        std::vector<VkDescriptorPool> descriptorPools;
+        uint32_t currentPoolIndex = 0;
+
+    public:
+        explicit VulkanDescriptorAllocator(const VulkanDescriptorAllocatorConfig& config);
+
+        ~VulkanDescriptorAllocator();
+
+        VkDescriptorSet allocate(VkDescriptorSetLayout descriptorSetLayout);
+
+        // The sets must no longer be in use by the GPU
+        void reset();
+
+    private:
+        VkResult allocate(VkDescriptorPool descriptorPool, VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet* descriptorSet) const;
+
+        VkDescriptorPool createDescriptorPool() const;
+    };
+}
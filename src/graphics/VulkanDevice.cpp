@@ -13,9 +13,19 @@ namespace Blink {
 
         this->presentQueue = getDeviceQueue(queueFamilyIndices.presentFamily.value());
         BL_ASSERT_THROW(presentQueue != nullptr);
+
+        if (queueFamilyIndices.transferFamily.has_value()) {
+            this->transferQueue = getDeviceQueue(queueFamilyIndices.transferFamily.value());
+            BL_ASSERT_THROW(transferQueue != nullptr);
+        }
+
+        VulkanMemoryAllocatorConfig memoryAllocatorConfig{};
+        memoryAllocatorConfig.device = this;
+        this->memoryAllocator = new VulkanMemoryAllocator(memoryAllocatorConfig);
     }
 
     VulkanDevice::~VulkanDevice() {
+        delete memoryAllocator;
         destroyDevice();
     }
 
@@ -27,6 +37,10 @@ namespace Blink {
         return config.physicalDevice;
     }
 
+    VulkanMemoryAllocator* VulkanDevice::getMemoryAllocator() const {
+        return memoryAllocator;
+    }
+
     VkQueue VulkanDevice::getGraphicsQueue() const {
         return graphicsQueue;
     }
@@ -52,6 +66,28 @@ namespace Blink {
         return vkQueueWaitIdle(presentQueue);
     }
 
+    bool VulkanDevice::isPresentWaitSupported() const {
+        return waitForPresentFunction != nullptr;
+    }
+
+    VkResult VulkanDevice::waitForPresent(VkSwapchainKHR swapChain, uint64_t presentId, uint64_t timeout) const {
+        BL_ASSERT(waitForPresentFunction != nullptr);
+        return waitForPresentFunction(device, swapChain, presentId, timeout);
+    }
+
+    bool VulkanDevice::hasTransferQueue() const {
+        return transferQueue != nullptr;
+    }
+
+    VkQueue VulkanDevice::getTransferQueue() const {
+        return transferQueue;
+    }
+
+    VkResult VulkanDevice::submitToTransferQueue(VkSubmitInfo* submitInfo, VkFence fence) const {
+        constexpr uint32_t submitCount = 1;
+        return vkQueueSubmit(transferQueue, submitCount, submitInfo, fence);
+    }
+
     VkResult VulkanDevice::waitUntilIdle() const {
         return vkDeviceWaitIdle(device);
     }
@@ -110,9 +146,8 @@ namespace Blink {
         vkDestroyRenderPass(device, renderPass, BL_VULKAN_ALLOCATOR);
     }
 
-    VkResult VulkanDevice::createGraphicsPipeline(VkGraphicsPipelineCreateInfo* createInfo, VkPipeline* pipeline) const {
+    VkResult VulkanDevice::createGraphicsPipeline(VkGraphicsPipelineCreateInfo* createInfo, VkPipeline* pipeline, VkPipelineCache cache) const {
         constexpr uint32_t count = 1;
-        VkPipelineCache cache = nullptr;
         return vkCreateGraphicsPipelines(device, cache, count, createInfo, BL_VULKAN_ALLOCATOR, pipeline);
     }
 
@@ -120,6 +155,33 @@ namespace Blink {
         vkDestroyPipeline(device, pipeline, BL_VULKAN_ALLOCATOR);
     }
 
+    VkResult VulkanDevice::createComputePipeline(VkComputePipelineCreateInfo* createInfo, VkPipeline* pipeline, VkPipelineCache cache) const {
+        constexpr uint32_t count = 1;
+        return vkCreateComputePipelines(device, cache, count, createInfo, BL_VULKAN_ALLOCATOR, pipeline);
+    }
+
+    void VulkanDevice::destroyComputePipeline(VkPipeline pipeline) const {
+        vkDestroyPipeline(device, pipeline, BL_VULKAN_ALLOCATOR);
+    }
+
+    VkResult VulkanDevice::createPipelineCache(VkPipelineCacheCreateInfo* createInfo, VkPipelineCache* cache) const {
+        return vkCreatePipelineCache(device, createInfo, BL_VULKAN_ALLOCATOR, cache);
+    }
+
+    void VulkanDevice::destroyPipelineCache(VkPipelineCache cache) const {
+        vkDestroyPipelineCache(device, cache, BL_VULKAN_ALLOCATOR);
+    }
+
+    VkResult VulkanDevice::getPipelineCacheData(VkPipelineCache cache, std::vector<char>* data) const {
+        size_t dataSize = 0;
+        VkResult result = vkGetPipelineCacheData(device, cache, &dataSize, nullptr);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+        data->resize(dataSize);
+        return vkGetPipelineCacheData(device, cache, &dataSize, data->data());
+    }
+
     VkResult VulkanDevice::createFramebuffer(VkFramebufferCreateInfo* createInfo, VkFramebuffer* framebuffer) const {
         return vkCreateFramebuffer(device, createInfo, BL_VULKAN_ALLOCATOR, framebuffer);
     }
@@ -167,6 +229,10 @@ namespace Blink {
         return vkWaitForFences(device, count, fence, waitAll, timeout);
     }
 
+    VkResult VulkanDevice::getFenceStatus(VkFence fence) const {
+        return vkGetFenceStatus(device, fence);
+    }
+
     VkResult VulkanDevice::resetFence(VkFence* fence) const {
         return vkResetFences(device, 1, fence);
     }
@@ -203,8 +269,7 @@ namespace Blink {
         vkFreeMemory(device, memory, BL_VULKAN_ALLOCATOR);
     }
 
-    VkResult VulkanDevice::bindBufferMemory(VkBuffer buffer, VkDeviceMemory memory) const {
-        constexpr VkDeviceSize memoryOffset = 0;
+    VkResult VulkanDevice::bindBufferMemory(VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize memoryOffset) const {
         return vkBindBufferMemory(device, buffer, memory, memoryOffset);
     }
 
@@ -238,12 +303,45 @@ namespace Blink {
         return vkAllocateDescriptorSets(device, allocateInfo, descriptorSets);
     }
 
+    VkResult VulkanDevice::resetDescriptorPool(VkDescriptorPool pool) const {
+        constexpr VkDescriptorPoolResetFlags flags = 0;
+        return vkResetDescriptorPool(device, pool, flags);
+    }
+
     void VulkanDevice::updateDescriptorSets(uint32_t count, VkWriteDescriptorSet* write) const {
         constexpr uint32_t copyCount = 0;
         constexpr VkCopyDescriptorSet* copies = nullptr;
         vkUpdateDescriptorSets(device, count, write, copyCount, copies);
     }
 
+    bool VulkanDevice::hasDescriptorUpdateTemplates() const {
+        return config.physicalDevice->getProperties().apiVersion >= VK_API_VERSION_1_1;
+    }
+
+    VkResult VulkanDevice::createDescriptorUpdateTemplate(VkDescriptorUpdateTemplateCreateInfo* createInfo, VkDescriptorUpdateTemplate* updateTemplate) const {
+        return vkCreateDescriptorUpdateTemplate(device, createInfo, BL_VULKAN_ALLOCATOR, updateTemplate);
+    }
+
+    void VulkanDevice::destroyDescriptorUpdateTemplate(VkDescriptorUpdateTemplate updateTemplate) const {
+        vkDestroyDescriptorUpdateTemplate(device, updateTemplate, BL_VULKAN_ALLOCATOR);
+    }
+
+    void VulkanDevice::updateDescriptorSetWithTemplate(VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplate updateTemplate, const void* data) const {
+        vkUpdateDescriptorSetWithTemplate(device, descriptorSet, updateTemplate, data);
+    }
+
+    VkResult VulkanDevice::createQueryPool(VkQueryPoolCreateInfo* createInfo, VkQueryPool* queryPool) const {
+        return vkCreateQueryPool(device, createInfo, BL_VULKAN_ALLOCATOR, queryPool);
+    }
+
+    void VulkanDevice::destroyQueryPool(VkQueryPool queryPool) const {
+        vkDestroyQueryPool(device, queryPool, BL_VULKAN_ALLOCATOR);
+    }
+
+    VkResult VulkanDevice::getQueryPoolResults(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, size_t dataSize, void* data, VkDeviceSize stride, VkQueryResultFlags flags) const {
+        return vkGetQueryPoolResults(device, queryPool, firstQuery, queryCount, dataSize, data, stride, flags);
+    }
+
     VkResult VulkanDevice::createImage(VkImageCreateInfo* createInfo, VkImage* image) const {
         return vkCreateImage(device, createInfo, BL_VULKAN_ALLOCATOR, image);
     }
@@ -254,8 +352,7 @@ namespace Blink {
         return memoryRequirements;
     }
 
-    VkResult VulkanDevice::bindImageMemory(VkImage image, VkDeviceMemory memory) const {
-        constexpr VkDeviceSize memoryOffset = 0;
+    VkResult VulkanDevice::bindImageMemory(VkImage image, VkDeviceMemory memory, VkDeviceSize memoryOffset) const {
         return vkBindImageMemory(device, image, memory, memoryOffset);
     }
 
@@ -286,6 +383,9 @@ namespace Blink {
                 queueFamilyIndices.graphicsFamily.value(),
                 queueFamilyIndices.presentFamily.value()
         };
+        if (queueFamilyIndices.transferFamily.has_value()) {
+            queueFamilies.insert(queueFamilyIndices.transferFamily.value());
+        }
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         for (uint32_t queueFamily : queueFamilies) {
             VkDeviceQueueCreateInfo queueCreateInfo{};
@@ -296,8 +396,25 @@ namespace Blink {
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        // Like the core features, every descriptor indexing and presentation feature the device has is enabled
+        VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures = config.physicalDevice->getDescriptorIndexingFeatures();
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures = config.physicalDevice->getPresentIdFeatures();
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures = config.physicalDevice->getPresentWaitFeatures();
+
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        if (config.physicalDevice->hasExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+            descriptorIndexingFeatures.pNext = (void*) createInfo.pNext;
+            createInfo.pNext = &descriptorIndexingFeatures;
+        }
+        if (config.physicalDevice->hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME)) {
+            presentIdFeatures.pNext = (void*) createInfo.pNext;
+            createInfo.pNext = &presentIdFeatures;
+        }
+        if (config.physicalDevice->hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+            presentWaitFeatures.pNext = (void*) createInfo.pNext;
+            createInfo.pNext = &presentWaitFeatures;
+        }
         createInfo.pEnabledFeatures = &features;
         createInfo.enabledExtensionCount = (uint32_t) extensionNames.size();
         createInfo.ppEnabledExtensionNames = extensionNames.data();
@@ -306,6 +423,11 @@ namespace Blink {
 
         BL_ASSERT_THROW_VK_SUCCESS(config.physicalDevice->createDevice(&createInfo, &device));
         BL_LOG_INFO("Created device");
+
+        // Extension functions are not exported by the loader and have to be looked up
+        if (presentIdFeatures.presentId && presentWaitFeatures.presentWait) {
+            waitForPresentFunction = (PFN_vkWaitForPresentKHR) vkGetDeviceProcAddr(device, "vkWaitForPresentKHR");
+        }
     }
 
     void VulkanDevice::destroyDevice() const {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "VulkanPhysicalDevice.h"
+#include "VulkanMemoryAllocator.h"
 
 #include <vulkan/vulkan.h>
 
@@ -21,6 +22,9 @@ namespace Blink {
         VkDevice device = nullptr;
         VkQueue graphicsQueue = nullptr;
         VkQueue presentQueue = nullptr;
+        VkQueue transferQueue = nullptr;
+        VulkanMemoryAllocator* memoryAllocator = nullptr;
+        PFN_vkWaitForPresentKHR waitForPresentFunction = nullptr; // Only loaded when presentId and presentWait are enabled
 
     public:
         explicit VulkanDevice(const VulkanDeviceConfig& config);
@@ -31,6 +35,8 @@ namespace Blink {
 
         VulkanPhysicalDevice* getPhysicalDevice() const;
 
+        VulkanMemoryAllocator* getMemoryAllocator() const;
+
         VkQueue getGraphicsQueue() const;
 
         VkResult submitToGraphicsQueue(VkSubmitInfo* submitInfo, VkFence fence = nullptr) const;
@@ -43,6 +49,19 @@ namespace Blink {
 
         VkResult waitUntilPresentQueueIsIdle() const;
 
+        // Whether presentations can be given an id (VkPresentIdKHR) and be waited for with waitForPresent
+        bool isPresentWaitSupported() const;
+
+        // VK_SUCCESS once the presentation with the id (or a later one) has been presented, VK_TIMEOUT if it has not
+        // been presented before the timeout (nanoseconds)
+        VkResult waitForPresent(VkSwapchainKHR swapChain, uint64_t presentId, uint64_t timeout) const;
+
+        bool hasTransferQueue() const;
+
+        VkQueue getTransferQueue() const;
+
+        VkResult submitToTransferQueue(VkSubmitInfo* submitInfo, VkFence fence = nullptr) const;
+
         VkResult waitUntilIdle() const;
 
         VkResult waitUntilQueueIsIdle(VkQueue queue) const;
@@ -69,10 +88,20 @@ namespace Blink {
 
         void destroyRenderPass(VkRenderPass renderPass) const;
 
-        VkResult createGraphicsPipeline(VkGraphicsPipelineCreateInfo* createInfo, VkPipeline* pipeline) const;
+        VkResult createGraphicsPipeline(VkGraphicsPipelineCreateInfo* createInfo, VkPipeline* pipeline, VkPipelineCache cache = nullptr) const;
 
         void destroyGraphicsPipeline(VkPipeline pipeline) const;
 
+        VkResult createComputePipeline(VkComputePipelineCreateInfo* createInfo, VkPipeline* pipeline, VkPipelineCache cache = nullptr) const;
+
+        void destroyComputePipeline(VkPipeline pipeline) const;
+
+        VkResult createPipelineCache(VkPipelineCacheCreateInfo* createInfo, VkPipelineCache* cache) const;
+
+        void destroyPipelineCache(VkPipelineCache cache) const;
+
+        VkResult getPipelineCacheData(VkPipelineCache cache, std::vector<char>* data) const;
+
         VkResult createFramebuffer(VkFramebufferCreateInfo* createInfo, VkFramebuffer* framebuffer) const;
 
         void destroyFramebuffer(VkFramebuffer framebuffer) const;
@@ -95,6 +124,9 @@ namespace Blink {
 
         VkResult waitForFence(VkFence* fence) const;
 
+        // VK_SUCCESS if the fence is signaled, VK_NOT_READY if it is not
+        VkResult getFenceStatus(VkFence fence) const;
+
         VkResult resetFences(uint32_t count, VkFence* fences) const;
 
         VkResult resetFence(VkFence* fence) const;
@@ -111,7 +143,7 @@ namespace Blink {
 
         void freeMemory(VkDeviceMemory memory) const;
 
-        VkResult bindBufferMemory(VkBuffer buffer, VkDeviceMemory memory) const;
+        VkResult bindBufferMemory(VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize memoryOffset = 0) const;
 
         VkResult mapMemory(VkDeviceMemory memory, VkDeviceSize memorySize, void** data) const;
 
@@ -127,13 +159,31 @@ namespace Blink {
 
         VkResult allocateDescriptorSets(VkDescriptorSetAllocateInfo* allocateInfo, VkDescriptorSet* descriptorSets) const;
 
+        VkResult resetDescriptorPool(VkDescriptorPool pool) const;
+
         void updateDescriptorSets(uint32_t count, VkWriteDescriptorSet* write) const;
 
+        // Descriptor update templates are core since Vulkan 1.1
+        bool hasDescriptorUpdateTemplates() const;
+
+        VkResult createDescriptorUpdateTemplate(VkDescriptorUpdateTemplateCreateInfo* createInfo, VkDescriptorUpdateTemplate* updateTemplate) const;
+
+        void destroyDescriptorUpdateTemplate(VkDescriptorUpdateTemplate updateTemplate) const;
+
+        void updateDescriptorSetWithTemplate(VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplate updateTemplate, const void* data) const;
+
+        VkResult createQueryPool(VkQueryPoolCreateInfo* createInfo, VkQueryPool* queryPool) const;
+
+        void destroyQueryPool(VkQueryPool queryPool) const;
+
+        // VK_NOT_READY if any of the queries is unavailable, the results of the available queries are still written
+        VkResult getQueryPoolResults(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, size_t dataSize, void* data, VkDeviceSize stride, VkQueryResultFlags flags) const;
+
         VkResult createImage(VkImageCreateInfo* createInfo, VkImage* image) const;
 
         VkMemoryRequirements getImageMemoryRequirements(VkImage image) const;
 
-        VkResult bindImageMemory(VkImage image, VkDeviceMemory memory) const;
+        VkResult bindImageMemory(VkImage image, VkDeviceMemory memory, VkDeviceSize memoryOffset = 0) const;
 
         void destroyImage(VkImage image) const;
 
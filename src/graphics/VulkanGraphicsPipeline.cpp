@@ -36,8 +36,8 @@ namespace Blink {
 
         VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{};
         vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputStateCreateInfo.vertexBindingDescriptionCount = 1;
-        vertexInputStateCreateInfo.pVertexBindingDescriptions = config.vertexBindingDescription;
+        vertexInputStateCreateInfo.vertexBindingDescriptionCount = (uint32_t) config.vertexBindingDescriptions->size();
+        vertexInputStateCreateInfo.pVertexBindingDescriptions = config.vertexBindingDescriptions->data();
         vertexInputStateCreateInfo.vertexAttributeDescriptionCount = (uint32_t) config.vertexAttributeDescriptions->size();
         vertexInputStateCreateInfo.pVertexAttributeDescriptions = config.vertexAttributeDescriptions->data();
 
@@ -106,7 +106,8 @@ namespace Blink {
         pipelineCreateInfo.subpass = 0;
         pipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
 
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->createGraphicsPipeline(&pipelineCreateInfo, &pipeline));
+        VkPipelineCache pipelineCache = config.pipelineCache != nullptr ? (VkPipelineCache) *config.pipelineCache : nullptr;
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->createGraphicsPipeline(&pipelineCreateInfo, &pipeline, pipelineCache));
     }
 
     VulkanGraphicsPipeline::~VulkanGraphicsPipeline() {
@@ -114,6 +115,10 @@ namespace Blink {
         config.device->destroyPipelineLayout(layout);
     }
 
+    VulkanGraphicsPipeline::operator VkPipeline() const {
+        return pipeline;
+    }
+
     VkPipelineLayout VulkanGraphicsPipeline::getLayout() const {
         return layout;
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graphics/VulkanDevice.h"
+#include "graphics/VulkanPipelineCache.h"
 #include "graphics/VulkanShader.h"
 
 #include <vulkan/vulkan.h>
@@ -8,10 +9,11 @@
 namespace Blink {
     struct VulkanGraphicsPipelineConfig {
         VulkanDevice* device = nullptr;
+        VulkanPipelineCache* pipelineCache = nullptr;
         VkRenderPass renderPass = nullptr;
         std::shared_ptr<VulkanShader> vertexShader;
         std::shared_ptr<VulkanShader> fragmentShader;
-        VkVertexInputBindingDescription* vertexBindingDescription;
+        std::vector<VkVertexInputBindingDescription>* vertexBindingDescriptions;
         std::vector<VkVertexInputAttributeDescription>* vertexAttributeDescriptions;
         std::vector<VkDescriptorSetLayout>* descriptorSetLayouts;
         std::vector<VkPushConstantRange>* pushConstantRanges;
@@ -30,6 +32,8 @@ namespace Blink {
 
         ~VulkanGraphicsPipeline();
 
+        operator VkPipeline() const;
+
         VkPipelineLayout getLayout() const;
 
         void bind(VkCommandBuffer commandBuffer) const;
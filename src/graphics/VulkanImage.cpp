@@ -1,7 +1,5 @@
 #include "pch.h"
 #include "VulkanImage.h"
-#include "VulkanCommandBuffer.h"
-#include "VulkanCommandPool.h"
 
 namespace Blink {
     VulkanImage::VulkanImage(const VulkanImageConfig& config) : config(config), currentLayout(config.layout) {
@@ -19,8 +17,8 @@ namespace Blink {
             config.device->destroyImageView(imageView);
         }
         if (image != nullptr) {
-            config.device->freeMemory(deviceMemory);
             config.device->destroyImage(image);
+            config.device->getMemoryAllocator()->free(memoryAllocation);
         }
     }
 
@@ -44,7 +42,49 @@ namespace Blink {
         return currentLayout;
     }
 
-    void VulkanImage::setLayout(VkImageLayout layout) {
+    void VulkanImage::setImageLayout(VkImageLayout layout) {
+        this->currentLayout = layout;
+    }
+
+    VkImageSubresourceRange VulkanImage::getSubresourceRange() const {
+        VkImageSubresourceRange subresourceRange{};
+        subresourceRange.aspectMask = config.aspect;
+        subresourceRange.baseArrayLayer = 0;
+        subresourceRange.layerCount = config.layerCount;
+        subresourceRange.baseMipLevel = 0;
+        subresourceRange.levelCount = config.mipLevels;
+        return subresourceRange;
+    }
+
+    uint32_t VulkanImage::getLayerCount() const {
+        return config.layerCount;
+    }
+
+    uint32_t VulkanImage::getMipLevels() const {
+        return config.mipLevels;
+    }
+
+    uint32_t VulkanImage::getWidth() const {
+        return config.width;
+    }
+
+    uint32_t VulkanImage::getHeight() const {
+        return config.height;
+    }
+
+    VkFormat VulkanImage::getFormat() const {
+        return config.format;
+    }
+
+    uint32_t VulkanImage::getMipLevelCount(uint32_t width, uint32_t height) {
+        uint32_t mipLevelCount = 1;
+        for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+            mipLevelCount++;
+        }
+        return mipLevelCount;
+    }
+
+    void VulkanImage::setLayout(VkCommandBuffer commandBuffer, VkImageLayout layout) {
         VkImageLayout oldLayout = this->currentLayout;
         VkImageLayout newLayout = layout;
         this->currentLayout = newLayout;
@@ -59,7 +99,7 @@ namespace Blink {
         barrier.subresourceRange.aspectMask = config.aspect;
         barrier.subresourceRange.layerCount = config.layerCount;
         barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.levelCount = config.mipLevels;
 
         if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
             barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
@@ -92,10 +132,6 @@ namespace Blink {
             BL_THROW("Unsupported layout transition: [" + getLayoutName(oldLayout) + " -> " + getLayoutName(newLayout) + "]");
         }
 
-        VulkanCommandBuffer commandBuffer;
-        BL_ASSERT_THROW_VK_SUCCESS(config.commandPool->allocateCommandBuffer(&commandBuffer));
-        BL_ASSERT_THROW_VK_SUCCESS(commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
-
         constexpr VkDependencyFlags dependencyFlags = 0;
         constexpr uint32_t memoryBarrierCount = 0;
         constexpr VkMemoryBarrier* memoryBarriers = nullptr;
@@ -114,143 +150,12 @@ namespace Blink {
                 imageMemoryBarrierCount,
                 &barrier
         );
-
-        BL_ASSERT_THROW_VK_SUCCESS(commandBuffer.end());
-
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = commandBuffer.vk_ptr();
-
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->submitToGraphicsQueue(&submitInfo));
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitUntilGraphicsQueueIsIdle());
-
-        config.commandPool->freeCommandBuffer(commandBuffer.vk_ptr());
-    }
-
-    void VulkanImage::setData(const std::shared_ptr<ImageFile>& imageFile) const {
-        VulkanBufferConfig stagingBufferConfig{};
-        stagingBufferConfig.device = config.device;
-        stagingBufferConfig.commandPool = config.commandPool;
-        stagingBufferConfig.size = imageFile->size;
-        stagingBufferConfig.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        stagingBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-        VulkanBuffer stagingBuffer(stagingBufferConfig);
-        stagingBuffer.setData(imageFile->pixels);
-
-        constexpr uint32_t depth = 1;
-        VkExtent3D imageExtent = {
-                (uint32_t) imageFile->width,
-                (uint32_t) imageFile->height,
-                depth
-        };
-
-        constexpr int32_t x = 0;
-        constexpr int32_t y = 0;
-        constexpr int32_t z = 0;
-        VkOffset3D imageOffset = {x, y, z};
-
-        VkBufferImageCopy copyRegion{};
-        copyRegion.bufferOffset = 0;
-        copyRegion.bufferRowLength = 0;
-        copyRegion.bufferImageHeight = 0;
-        copyRegion.imageSubresource.aspectMask = config.aspect;
-        copyRegion.imageSubresource.layerCount = 1;
-        copyRegion.imageSubresource.baseArrayLayer = 0;
-        copyRegion.imageSubresource.mipLevel = 0;
-        copyRegion.imageOffset = imageOffset;
-        copyRegion.imageExtent = imageExtent;
-
-        VulkanCommandBuffer commandBuffer;
-        BL_ASSERT_THROW_VK_SUCCESS(config.commandPool->allocateCommandBuffer(&commandBuffer));
-        BL_ASSERT_THROW_VK_SUCCESS(commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
-
-        constexpr uint32_t copyRegionCount = 1;
-        vkCmdCopyBufferToImage(
-            commandBuffer,
-            stagingBuffer,
-            getImage(),
-            currentLayout,
-            copyRegionCount,
-            &copyRegion
-        );
-
-        BL_ASSERT_THROW_VK_SUCCESS(commandBuffer.end());
-
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = commandBuffer.vk_ptr();
-
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->submitToGraphicsQueue(&submitInfo));
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitUntilGraphicsQueueIsIdle());
-
-        config.commandPool->freeCommandBuffer(commandBuffer.vk_ptr());
-    }
-
-    void VulkanImage::setData(const std::vector<std::shared_ptr<ImageFile>>& imageFiles) const {
-        std::vector<VulkanBuffer*> stagingBuffers;
-
-        VulkanCommandBuffer commandBuffer;
-        BL_ASSERT_THROW_VK_SUCCESS(config.commandPool->allocateCommandBuffer(&commandBuffer));
-        BL_ASSERT_THROW_VK_SUCCESS(commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
-
-        for (uint32_t i = 0; i < config.layerCount; i++) {
-            auto imageFile = imageFiles[i];
-
-            VulkanBufferConfig stagingBufferConfig{};
-            stagingBufferConfig.device = config.device;
-            stagingBufferConfig.commandPool = config.commandPool;
-            stagingBufferConfig.size = imageFile->size;
-            stagingBufferConfig.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-            stagingBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-
-            auto stagingBuffer = new VulkanBuffer(stagingBufferConfig);
-            stagingBuffer->setData(imageFile->pixels);
-            stagingBuffers.push_back(stagingBuffer);
-
-            VkBufferImageCopy copyRegion{};
-            copyRegion.imageExtent.width = imageFile->width;
-            copyRegion.imageExtent.height = imageFile->height;
-            copyRegion.imageExtent.depth = 1;
-            copyRegion.imageSubresource.aspectMask = config.aspect;
-            copyRegion.imageSubresource.layerCount = 1;
-            copyRegion.imageSubresource.baseArrayLayer = i;
-            copyRegion.imageSubresource.mipLevel = 0;
-            copyRegion.bufferOffset = 0;
-
-            constexpr uint32_t copyRegionCount = 1;
-            vkCmdCopyBufferToImage(
-                commandBuffer,
-                *stagingBuffer,
-                image,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                copyRegionCount,
-                &copyRegion
-            );
-        }
-
-        BL_ASSERT_THROW_VK_SUCCESS(commandBuffer.end());
-
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = commandBuffer.vk_ptr();
-
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->submitToGraphicsQueue(&submitInfo));
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitUntilGraphicsQueueIsIdle());
-
-        config.commandPool->freeCommandBuffer(commandBuffer.vk_ptr());
-
-        for (auto stagingBuffer : stagingBuffers) {
-            delete stagingBuffer;
-        }
     }
 
     void VulkanImage::createImage() {
         BL_ASSERT_THROW(config.width > 0);
         BL_ASSERT_THROW(config.height > 0);
+        BL_ASSERT_THROW(config.mipLevels > 0 && config.mipLevels <= getMipLevelCount(config.width, config.height));
 
         VkImageCreateInfo imageCreateInfo{};
         imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -258,7 +163,7 @@ namespace Blink {
         imageCreateInfo.extent.width = config.width;
         imageCreateInfo.extent.height = config.height;
         imageCreateInfo.extent.depth = 1;
-        imageCreateInfo.mipLevels = 1;
+        imageCreateInfo.mipLevels = config.mipLevels;
         imageCreateInfo.arrayLayers = config.layerCount;
         imageCreateInfo.format = config.format;
         imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -274,16 +179,10 @@ namespace Blink {
     void VulkanImage::initializeImageMemory() {
         VkMemoryRequirements memoryRequirements = config.device->getImageMemoryRequirements(image);
 
-        VulkanPhysicalDevice* physicalDevice = config.device->getPhysicalDevice();
-        uint32_t memoryTypeIndex = physicalDevice->getMemoryTypeIndex(memoryRequirements, config.memoryProperties);
-
-        VkMemoryAllocateInfo memoryAllocateInfo{};
-        memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        memoryAllocateInfo.allocationSize = memoryRequirements.size;
-        memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+        VulkanMemoryAllocator* memoryAllocator = config.device->getMemoryAllocator();
+        memoryAllocation = memoryAllocator->allocate(memoryRequirements, config.memoryProperties, VulkanMemoryResourceType::Image);
 
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->allocateMemory(&memoryAllocateInfo, &deviceMemory));
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->bindImageMemory(image, deviceMemory));
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->bindImageMemory(image, memoryAllocation.memory, memoryAllocation.offset));
     }
 
     void VulkanImage::createImageView() {
@@ -295,7 +194,7 @@ namespace Blink {
         imageViewCreateInfo.subresourceRange.aspectMask = config.aspect;
         imageViewCreateInfo.subresourceRange.layerCount = config.layerCount;
         imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-        imageViewCreateInfo.subresourceRange.levelCount = 1;
+        imageViewCreateInfo.subresourceRange.levelCount = config.mipLevels;
 
         BL_ASSERT_THROW_VK_SUCCESS(config.device->createImageView(&imageViewCreateInfo, &imageView));
     }
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "VulkanDevice.h"
-#include "VulkanCommandPool.h"
 #include "VulkanBuffer.h"
 #include "system/FileSystem.h"
 
@@ -10,7 +9,6 @@
 namespace Blink {
     struct VulkanImageConfig {
         VulkanDevice* device = nullptr;
-        VulkanCommandPool* commandPool = nullptr;
         VkImage image = nullptr;
         VkImageView imageView = nullptr;
         VkImageViewType imageViewType = VK_IMAGE_VIEW_TYPE_2D;
@@ -24,6 +22,7 @@ namespace Blink {
         uint32_t height = 0;
         uint32_t depth = 1;
         uint32_t layerCount = 1;
+        uint32_t mipLevels = 1;
         std::string debugName = "";
     };
 
@@ -32,7 +31,7 @@ namespace Blink {
         VulkanImageConfig config;
         VkImage image = nullptr;
         VkImageView imageView = nullptr;
-        VkDeviceMemory deviceMemory = nullptr;
+        VulkanMemoryAllocation memoryAllocation{};
         VkImageLayout currentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
     public:
@@ -52,11 +51,26 @@ namespace Blink {
 
         VkImageLayout getImageLayout() const;
 
-        void setLayout(VkImageLayout layout);
+        // Only updates the tracked layout, for transitions that are recorded by the caller (e.g. queue family ownership transfers)
+        void setImageLayout(VkImageLayout layout);
 
-        void setData(const std::shared_ptr<ImageFile>& imageFile) const;
+        VkImageSubresourceRange getSubresourceRange() const;
 
-        void setData(const std::vector<std::shared_ptr<ImageFile>>& imageFiles) const;
+        uint32_t getLayerCount() const;
+
+        uint32_t getMipLevels() const;
+
+        uint32_t getWidth() const;
+
+        uint32_t getHeight() const;
+
+        VkFormat getFormat() const;
+
+        // Number of levels in a full mip chain, down to a 1x1 level
+        static uint32_t getMipLevelCount(uint32_t width, uint32_t height);
+
+        // Records the layout transition into the command buffer, it takes effect when the command buffer is executed
+        void setLayout(VkCommandBuffer commandBuffer, VkImageLayout layout);
 
     private:
         void createImage();
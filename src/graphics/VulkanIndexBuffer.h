@@ -1,22 +1,22 @@
 #pragma once
 
-#include "VulkanCommandPool.h"
 #include "VulkanDevice.h"
 #include "VulkanBuffer.h"
+#include "VulkanUploadContext.h"
 
 namespace Blink {
 
     struct VulkanIndexBufferConfig {
         VulkanDevice* device = nullptr;
-        VulkanCommandPool* commandPool = nullptr;
+        VulkanUploadContext* uploadContext = nullptr;
         VkDeviceSize size = 0;
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
     };
 
     class VulkanIndexBuffer {
     private:
         VulkanIndexBufferConfig config;
         VulkanBuffer* buffer = nullptr;
-        VulkanBuffer* stagingBuffer = nullptr;
 
     public:
         explicit VulkanIndexBuffer(const VulkanIndexBufferConfig& config);
@@ -25,7 +25,10 @@ namespace Blink {
 
         operator VkBuffer() const;
 
-        void setData(void* indices) const;
+        VkIndexType getIndexType() const;
+
+        // Stages the data, the copy into the buffer is executed when the upload context is flushed
+        void setData(const void* indices) const;
 
         void bind(VkCommandBuffer commandBuffer) const;
     };
@@ -0,0 +1,241 @@
+#include "pch.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanDevice.h"
+
+namespace Blink {
+    VulkanMemoryAllocator::VulkanMemoryAllocator(const VulkanMemoryAllocatorConfig& config) : config(config) {
+        BL_ASSERT_THROW(config.blockSize > 0);
+    }
+
+    VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+        for (const auto& [poolKey, blocks] : pools) {
+            for (VulkanMemoryBlock* block : blocks) {
+                if (block->allocationCount > 0) {
+                    BL_LOG_WARN("Destroying memory block with live allocations [{}]", block->allocationCount);
+                }
+                destroyBlock(block);
+            }
+        }
+        pools.clear();
+    }
+
+    VulkanMemoryAllocation VulkanMemoryAllocator::allocate(
+        const VkMemoryRequirements& memoryRequirements,
+        VkMemoryPropertyFlags memoryProperties,
+        VulkanMemoryResourceType resourceType,
+        VulkanMemoryStrategy strategy
+    ) {
+        VulkanPhysicalDevice* physicalDevice = config.device->getPhysicalDevice();
+        uint32_t memoryTypeIndex = physicalDevice->getMemoryTypeIndex(memoryRequirements, memoryProperties);
+        BL_ASSERT_THROW(memoryTypeIndex != (uint32_t) -1);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<VulkanMemoryBlock*>& blocks = pools[getPoolKey(memoryTypeIndex, resourceType, strategy)];
+
+        VulkanMemoryAllocation allocation{};
+
+        // Resources larger than half a block get a block of their own to not waste the remainder of a shared block
+        if (memoryRequirements.size > config.blockSize / 2) {
+            constexpr bool dedicated = true;
+            VulkanMemoryBlock* block = createBlock(memoryTypeIndex, memoryRequirements.size, strategy, dedicated);
+            block->resourceType = resourceType;
+            blocks.push_back(block);
+            BL_ASSERT_THROW(allocateFromBlock(block, memoryRequirements, &allocation));
+            return allocation;
+        }
+
+        for (VulkanMemoryBlock* block : blocks) {
+            if (!block->dedicated && allocateFromBlock(block, memoryRequirements, &allocation)) {
+                return allocation;
+            }
+        }
+
+        constexpr bool dedicated = false;
+        VulkanMemoryBlock* block = createBlock(memoryTypeIndex, config.blockSize, strategy, dedicated);
+        block->resourceType = resourceType;
+        blocks.push_back(block);
+        BL_ASSERT_THROW(allocateFromBlock(block, memoryRequirements, &allocation));
+        return allocation;
+    }
+
+    void VulkanMemoryAllocator::free(const VulkanMemoryAllocation& allocation) {
+        if (allocation.block == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+
+        VulkanMemoryBlock* block = allocation.block;
+        freeFromBlock(block, allocation);
+        if (block->allocationCount > 0) {
+            return;
+        }
+
+        // Keep a single empty block per pool to avoid reallocating device memory when resources are recreated
+        std::vector<VulkanMemoryBlock*>& blocks = pools[getPoolKey(block->memoryTypeIndex, block->resourceType, block->strategy)];
+        bool hasOtherEmptyBlock = false;
+        for (VulkanMemoryBlock* otherBlock : blocks) {
+            if (otherBlock != block && !otherBlock->dedicated && otherBlock->allocationCount == 0) {
+                hasOtherEmptyBlock = true;
+                break;
+            }
+        }
+        if (block->dedicated || hasOtherEmptyBlock) {
+            blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+            destroyBlock(block);
+        }
+    }
+
+    std::vector<VulkanMemoryHeapStatistics> VulkanMemoryAllocator::getStatistics() {
+        const VkPhysicalDeviceMemoryProperties& memoryProperties = config.device->getPhysicalDevice()->getMemoryProperties();
+
+        std::vector<VulkanMemoryHeapStatistics> statistics(memoryProperties.memoryHeapCount);
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+            statistics[i].heapIndex = i;
+            statistics[i].heapSize = memoryProperties.memoryHeaps[i].size;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [poolKey, blocks] : pools) {
+            for (VulkanMemoryBlock* block : blocks) {
+                uint32_t heapIndex = memoryProperties.memoryTypes[block->memoryTypeIndex].heapIndex;
+                VulkanMemoryHeapStatistics& heapStatistics = statistics[heapIndex];
+                heapStatistics.blockCount++;
+                heapStatistics.allocationCount += block->allocationCount;
+                heapStatistics.allocatedSize += block->size;
+                heapStatistics.usedSize += block->usedSize;
+            }
+        }
+        return statistics;
+    }
+
+    void VulkanMemoryAllocator::logStatistics() {
+        constexpr double megabyte = 1024.0 * 1024.0;
+        for (const VulkanMemoryHeapStatistics& heapStatistics : getStatistics()) {
+            BL_LOG_INFO(
+                "Memory heap [{}]: blocks [{}], allocations [{}], used [{:.1f} MB], allocated [{:.1f} MB], heap size [{:.1f} MB]",
+                heapStatistics.heapIndex,
+                heapStatistics.blockCount,
+                heapStatistics.allocationCount,
+                heapStatistics.usedSize / megabyte,
+                heapStatistics.allocatedSize / megabyte,
+                heapStatistics.heapSize / megabyte
+            );
+        }
+    }
+
+    VulkanMemoryBlock* VulkanMemoryAllocator::createBlock(uint32_t memoryTypeIndex, VkDeviceSize size, VulkanMemoryStrategy strategy, bool dedicated) const {
+        auto block = new VulkanMemoryBlock();
+        block->size = size;
+        block->memoryTypeIndex = memoryTypeIndex;
+        block->strategy = strategy;
+        block->dedicated = dedicated;
+        block->freeRanges.push_back({0, size});
+
+        VkMemoryAllocateInfo memoryAllocateInfo{};
+        memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        memoryAllocateInfo.allocationSize = size;
+        memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->allocateMemory(&memoryAllocateInfo, &block->memory));
+
+        const VkPhysicalDeviceMemoryProperties& memoryProperties = config.device->getPhysicalDevice()->getMemoryProperties();
+        VkMemoryPropertyFlags memoryPropertyFlags = memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+        if ((memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->mapMemory(block->memory, VK_WHOLE_SIZE, &block->mappedData));
+        }
+        return block;
+    }
+
+    void VulkanMemoryAllocator::destroyBlock(VulkanMemoryBlock* block) const {
+        if (block->mappedData != nullptr) {
+            config.device->unmapMemory(block->memory);
+        }
+        config.device->freeMemory(block->memory);
+        delete block;
+    }
+
+    bool VulkanMemoryAllocator::allocateFromBlock(VulkanMemoryBlock* block, const VkMemoryRequirements& memoryRequirements, VulkanMemoryAllocation* allocation) {
+        VkDeviceSize offset = 0;
+        if (block->strategy == VulkanMemoryStrategy::Linear) {
+            offset = alignUp(block->linearOffset, memoryRequirements.alignment);
+            if (offset + memoryRequirements.size > block->size) {
+                return false;
+            }
+            allocation->range.offset = block->linearOffset;
+            allocation->range.size = offset + memoryRequirements.size - block->linearOffset;
+            block->linearOffset = offset + memoryRequirements.size;
+        } else {
+            // First fit
+            bool found = false;
+            for (auto iterator = block->freeRanges.begin(); iterator != block->freeRanges.end(); ++iterator) {
+                VulkanMemoryRange& freeRange = *iterator;
+                offset = alignUp(freeRange.offset, memoryRequirements.alignment);
+                if (offset + memoryRequirements.size > freeRange.offset + freeRange.size) {
+                    continue;
+                }
+                allocation->range.offset = freeRange.offset;
+                allocation->range.size = offset + memoryRequirements.size - freeRange.offset;
+                freeRange.offset += allocation->range.size;
+                freeRange.size -= allocation->range.size;
+                if (freeRange.size == 0) {
+                    block->freeRanges.erase(iterator);
+                }
+                found = true;
+                break;
+            }
+            if (!found) {
+                return false;
+            }
+        }
+
+        block->allocationCount++;
+        block->usedSize += allocation->range.size;
+
+        allocation->memory = block->memory;
+        allocation->offset = offset;
+        allocation->size = memoryRequirements.size;
+        allocation->mappedData = block->mappedData != nullptr ? (char*) block->mappedData + offset : nullptr;
+        allocation->block = block;
+        return true;
+    }
+
+    void VulkanMemoryAllocator::freeFromBlock(VulkanMemoryBlock* block, const VulkanMemoryAllocation& allocation) {
+        block->allocationCount--;
+        block->usedSize -= allocation.range.size;
+
+        if (block->strategy == VulkanMemoryStrategy::Linear) {
+            // Linear blocks can only be reused once every allocation in them has been freed
+            if (block->allocationCount == 0) {
+                block->linearOffset = 0;
+            }
+            return;
+        }
+
+        // Insert the range back into the sorted free list and merge it with its neighbours
+        auto iterator = std::lower_bound(block->freeRanges.begin(), block->freeRanges.end(), allocation.range, [](const VulkanMemoryRange& a, const VulkanMemoryRange& b) {
+            return a.offset < b.offset;
+        });
+        iterator = block->freeRanges.insert(iterator, allocation.range);
+
+        auto next = iterator + 1;
+        if (next != block->freeRanges.end() && iterator->offset + iterator->size == next->offset) {
+            iterator->size += next->size;
+            iterator = block->freeRanges.erase(next) - 1;
+        }
+        if (iterator != block->freeRanges.begin()) {
+            auto previous = iterator - 1;
+            if (previous->offset + previous->size == iterator->offset) {
+                previous->size += iterator->size;
+                block->freeRanges.erase(iterator);
+            }
+        }
+    }
+
+    uint32_t VulkanMemoryAllocator::getPoolKey(uint32_t memoryTypeIndex, VulkanMemoryResourceType resourceType, VulkanMemoryStrategy strategy) {
+        return (memoryTypeIndex << 2) | ((uint32_t) resourceType << 1) | (uint32_t) strategy;
+    }
+
+    VkDeviceSize VulkanMemoryAllocator::alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return alignment > 0 ? (value + alignment - 1) / alignment * alignment : value;
+    }
+}
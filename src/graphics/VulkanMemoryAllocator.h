@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace Blink {
+    class VulkanDevice;
+
+    enum class VulkanMemoryStrategy {
+        FreeList = 0, // General purpose, memory is returned to the block when freed
+        Linear = 1 // Bump allocation for short-lived memory (e.g. staging), the block is reset when it becomes empty
+    };
+
+    enum class VulkanMemoryResourceType {
+        Buffer = 0,
+        Image = 1
+    };
+
+    struct VulkanMemoryRange {
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+    };
+
+    struct VulkanMemoryBlock {
+        VkDeviceMemory memory = nullptr;
+        VkDeviceSize size = 0;
+        void* mappedData = nullptr;
+        uint32_t memoryTypeIndex = 0;
+        VulkanMemoryStrategy strategy = VulkanMemoryStrategy::FreeList;
+        VulkanMemoryResourceType resourceType = VulkanMemoryResourceType::Buffer;
+        bool dedicated = false;
+        uint32_t allocationCount = 0;
+        VkDeviceSize usedSize = 0;
+        VkDeviceSize linearOffset = 0;
+        std::vector<VulkanMemoryRange> freeRanges; // Sorted by offset
+    };
+
+    struct VulkanMemoryAllocation {
+        VkDeviceMemory memory = nullptr;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void* mappedData = nullptr; // Only set for host visible memory
+        VulkanMemoryBlock* block = nullptr;
+        VulkanMemoryRange range{}; // The part of the block occupied by the allocation, including alignment padding
+    };
+
+    struct VulkanMemoryHeapStatistics {
+        uint32_t heapIndex = 0;
+        VkDeviceSize heapSize = 0;
+        uint32_t blockCount = 0;
+        uint32_t allocationCount = 0;
+        VkDeviceSize allocatedSize = 0; // Memory allocated from the device (blocks)
+        VkDeviceSize usedSize = 0; // Memory handed out to buffers and images (suballocations)
+    };
+
+    struct VulkanMemoryAllocatorConfig {
+        VulkanDevice* device = nullptr;
+        VkDeviceSize blockSize = 64 * 1024 * 1024;
+    };
+
+    //
+    // Suballocates buffer and image memory from large VkDeviceMemory blocks instead of allocating device memory for
+    // every single resource.
+    //
+    // Devices limit the number of simultaneous memory allocations (maxMemoryAllocationCount, which can be as low as
+    // 4096) and every allocation wastes memory on alignment, so allocating per resource doesn't scale to scenes
+    // with thousands of meshes.
+    //
+    // Blocks are kept in separate pools per memory type, strategy and resource type. Keeping buffers and images
+    // in separate blocks means that the bufferImageGranularity limit never has to be taken into account.
+    //
+    // Host visible blocks are persistently mapped because memory can only be mapped once per VkDeviceMemory object.
+    //
+    class VulkanMemoryAllocator {
+    private:
+        VulkanMemoryAllocatorConfig config;
+        std::map<uint32_t, std::vector<VulkanMemoryBlock*>> pools;
+        std::mutex mutex;
+
+    public:
+        explicit VulkanMemoryAllocator(const VulkanMemoryAllocatorConfig& config);
+
+        ~VulkanMemoryAllocator();
+
+        VulkanMemoryAllocation allocate(
+            const VkMemoryRequirements& memoryRequirements,
+            VkMemoryPropertyFlags memoryProperties,
+            VulkanMemoryResourceType resourceType,
+            VulkanMemoryStrategy strategy = VulkanMemoryStrategy::FreeList
+        );
+
+        void free(const VulkanMemoryAllocation& allocation);
+
+        std::vector<VulkanMemoryHeapStatistics> getStatistics();
+
+        void logStatistics();
+
+    private:
+        VulkanMemoryBlock* createBlock(uint32_t memoryTypeIndex, VkDeviceSize size, VulkanMemoryStrategy strategy, bool dedicated) const;
+
+        void destroyBlock(VulkanMemoryBlock* block) const;
+
+        static bool allocateFromBlock(VulkanMemoryBlock* block, const VkMemoryRequirements& memoryRequirements, VulkanMemoryAllocation* allocation);
+
+        static void freeFromBlock(VulkanMemoryBlock* block, const VulkanMemoryAllocation& allocation);
+
+        static uint32_t getPoolKey(uint32_t memoryTypeIndex, VulkanMemoryResourceType resourceType, VulkanMemoryStrategy strategy);
+
+        static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment);
+    };
+}
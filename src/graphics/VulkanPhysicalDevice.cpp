@@ -24,6 +24,10 @@ namespace Blink {
         return deviceInfo.properties;
     }
 
+    const VkPhysicalDeviceMemoryProperties& VulkanPhysicalDevice::getMemoryProperties() const {
+        return deviceInfo.memoryProperties;
+    }
+
     const VkPhysicalDeviceFeatures& VulkanPhysicalDevice::getFeatures() const {
         return deviceInfo.features;
     }
@@ -32,10 +36,39 @@ namespace Blink {
         return deviceInfo.extensions;
     }
 
+    bool VulkanPhysicalDevice::hasExtension(const char* extensionName) const {
+        for (const VkExtensionProperties& extension : deviceInfo.extensions) {
+            if (strcmp(extensionName, extension.extensionName) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const VkPhysicalDeviceDescriptorIndexingFeatures& VulkanPhysicalDevice::getDescriptorIndexingFeatures() const {
+        return deviceInfo.descriptorIndexingFeatures;
+    }
+
+    const VkPhysicalDeviceDescriptorIndexingProperties& VulkanPhysicalDevice::getDescriptorIndexingProperties() const {
+        return deviceInfo.descriptorIndexingProperties;
+    }
+
+    const VkPhysicalDevicePresentIdFeaturesKHR& VulkanPhysicalDevice::getPresentIdFeatures() const {
+        return deviceInfo.presentIdFeatures;
+    }
+
+    const VkPhysicalDevicePresentWaitFeaturesKHR& VulkanPhysicalDevice::getPresentWaitFeatures() const {
+        return deviceInfo.presentWaitFeatures;
+    }
+
     const QueueFamilyIndices& VulkanPhysicalDevice::getQueueFamilyIndices() const {
         return deviceInfo.queueFamilyIndices;
     }
 
+    const std::vector<VkQueueFamilyProperties>& VulkanPhysicalDevice::getQueueFamilyProperties() const {
+        return deviceInfo.queueFamilyProperties;
+    }
+
     const SwapChainInfo& VulkanPhysicalDevice::getSwapChainInfo() const {
         return deviceInfo.swapChainInfo;
     }
@@ -44,6 +77,13 @@ namespace Blink {
         return deviceInfo.depthFormat;
     }
 
+    // Only checks images with optimal tiling, which is what all sampled images use
+    bool VulkanPhysicalDevice::isFormatSupported(VkFormat format, VkFormatFeatureFlags requiredFeatures) const {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(deviceInfo.physicalDevice, format, &formatProperties);
+        return (formatProperties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
+    }
+
     void VulkanPhysicalDevice::updateSwapChainInfo() {
         deviceInfo.swapChainInfo = findSwapChainInfo(deviceInfo.physicalDevice);
     }
@@ -56,14 +96,13 @@ namespace Blink {
         const VkMemoryRequirements& memoryRequirements,
         VkMemoryPropertyFlags requiredMemoryProperties
     ) const {
-        VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
-        vkGetPhysicalDeviceMemoryProperties(deviceInfo.physicalDevice, &physicalDeviceMemoryProperties);
+        const VkPhysicalDeviceMemoryProperties& physicalDeviceMemoryProperties = deviceInfo.memoryProperties;
         for (uint32_t memoryTypeIndex = 0; memoryTypeIndex < physicalDeviceMemoryProperties.memoryTypeCount; memoryTypeIndex++) {
             bool memoryTypeIsSuitable = (memoryRequirements.memoryTypeBits & (1 << memoryTypeIndex)) > 0;
             if (!memoryTypeIsSuitable) {
                 continue;
             }
-            VkMemoryType& memoryType = physicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex];
+            const VkMemoryType& memoryType = physicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex];
             bool memoryTypeHasRequiredProperties = (memoryType.propertyFlags & requiredMemoryProperties) == requiredMemoryProperties;
             if (!memoryTypeHasRequiredProperties) {
                 continue;
@@ -100,12 +139,64 @@ namespace Blink {
         VkPhysicalDeviceFeatures features;
         vkGetPhysicalDeviceFeatures(physicalDevice, &features);
 
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
         VulkanPhysicalDeviceInfo deviceInfo{};
         deviceInfo.physicalDevice = physicalDevice;
         deviceInfo.properties = properties;
         deviceInfo.features = features;
+        deviceInfo.memoryProperties = memoryProperties;
         deviceInfo.extensions = findExtensions(physicalDevice, requiredExtensions);
+
+        // Optional extensions are enabled when they are available, the features that use them check for them
+        const std::vector<const char*> optionalExtensions = {
+                VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME,
+                VK_KHR_PRESENT_ID_EXTENSION_NAME,
+                VK_KHR_PRESENT_WAIT_EXTENSION_NAME
+        };
+        for (const VkExtensionProperties& extension : findExtensions(physicalDevice, optionalExtensions)) {
+            deviceInfo.extensions.push_back(extension);
+
+            if (strcmp(extension.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0) {
+                deviceInfo.descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+                VkPhysicalDeviceFeatures2 features2{};
+                features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features2.pNext = &deviceInfo.descriptorIndexingFeatures;
+                vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+                deviceInfo.descriptorIndexingFeatures.pNext = nullptr;
+
+                deviceInfo.descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+                VkPhysicalDeviceProperties2 properties2{};
+                properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+                properties2.pNext = &deviceInfo.descriptorIndexingProperties;
+                vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+                deviceInfo.descriptorIndexingProperties.pNext = nullptr;
+            }
+            if (strcmp(extension.extensionName, VK_KHR_PRESENT_ID_EXTENSION_NAME) == 0) {
+                deviceInfo.presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+                VkPhysicalDeviceFeatures2 features2{};
+                features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features2.pNext = &deviceInfo.presentIdFeatures;
+                vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+                deviceInfo.presentIdFeatures.pNext = nullptr;
+            }
+            if (strcmp(extension.extensionName, VK_KHR_PRESENT_WAIT_EXTENSION_NAME) == 0) {
+                deviceInfo.presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+                VkPhysicalDeviceFeatures2 features2{};
+                features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features2.pNext = &deviceInfo.presentWaitFeatures;
+                vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+                deviceInfo.presentWaitFeatures.pNext = nullptr;
+            }
+        }
         deviceInfo.queueFamilyIndices = findQueueFamilyIndices(physicalDevice);
+
+        uint32_t queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        deviceInfo.queueFamilyProperties.resize(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, deviceInfo.queueFamilyProperties.data());
+
         deviceInfo.swapChainInfo = findSwapChainInfo(physicalDevice);
         deviceInfo.depthFormat = findDepthFormat(physicalDevice);
 
@@ -155,6 +246,21 @@ namespace Blink {
                 break;
             }
         }
+
+        // Transfer queue families without graphics (and preferably without compute) support are backed by the
+        // dedicated copy engines of discrete GPUs, which lets uploads run in parallel with rendering.
+        for (int queueFamilyIndex = 0; queueFamilyIndex < queueFamilies.size(); queueFamilyIndex++) {
+            const VkQueueFamilyProperties& queueFamily = queueFamilies[queueFamilyIndex];
+            if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) == 0 || (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0) {
+                continue;
+            }
+            if (!indices.transferFamily.has_value() || (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) == 0) {
+                indices.transferFamily = queueFamilyIndex;
+            }
+            if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) == 0) {
+                break;
+            }
+        }
         return indices;
     }
 
@@ -7,6 +7,7 @@ namespace Blink {
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        std::optional<uint32_t> transferFamily; // Dedicated transfer family without graphics support, if available
     };
 
     struct SwapChainInfo {
@@ -19,8 +20,14 @@ namespace Blink {
         VkPhysicalDevice physicalDevice = nullptr;
         VkPhysicalDeviceProperties properties{};
         VkPhysicalDeviceFeatures features{};
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
+        VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{}; // All false without VK_EXT_descriptor_indexing
+        VkPhysicalDeviceDescriptorIndexingProperties descriptorIndexingProperties{};
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{}; // All false without VK_KHR_present_id
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{}; // All false without VK_KHR_present_wait
         std::vector<VkExtensionProperties> extensions{};
         QueueFamilyIndices queueFamilyIndices{};
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties{};
         SwapChainInfo swapChainInfo{};
         VkFormat depthFormat = VK_FORMAT_UNDEFINED;
     };
@@ -42,14 +49,30 @@ namespace Blink {
 
         const std::vector<VkExtensionProperties>& getExtensions() const;
 
+        bool hasExtension(const char* extensionName) const;
+
         const VkPhysicalDeviceFeatures& getFeatures() const;
 
         const VkPhysicalDeviceProperties& getProperties() const;
 
+        const VkPhysicalDeviceDescriptorIndexingFeatures& getDescriptorIndexingFeatures() const;
+
+        const VkPhysicalDeviceDescriptorIndexingProperties& getDescriptorIndexingProperties() const;
+
+        const VkPhysicalDevicePresentIdFeaturesKHR& getPresentIdFeatures() const;
+
+        const VkPhysicalDevicePresentWaitFeaturesKHR& getPresentWaitFeatures() const;
+
+        const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const;
+
         VkFormat getDepthFormat() const;
 
+        bool isFormatSupported(VkFormat format, VkFormatFeatureFlags requiredFeatures) const;
+
         const QueueFamilyIndices& getQueueFamilyIndices() const;
 
+        const std::vector<VkQueueFamilyProperties>& getQueueFamilyProperties() const;
+
         const SwapChainInfo& getSwapChainInfo() const;
 
         void updateSwapChainInfo();
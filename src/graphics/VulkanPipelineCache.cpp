@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "VulkanPipelineCache.h"
+
+namespace Blink {
+    VulkanPipelineCache::VulkanPipelineCache(const VulkanPipelineCacheConfig& config) : config(config) {
+        std::vector<char> initialData = load();
+
+        VkPipelineCacheCreateInfo pipelineCacheCreateInfo{};
+        pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        pipelineCacheCreateInfo.initialDataSize = initialData.size();
+        pipelineCacheCreateInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->createPipelineCache(&pipelineCacheCreateInfo, &pipelineCache));
+        warm = !initialData.empty();
+        BL_LOG_INFO("Created pipeline cache [{}], initial data [{} bytes]", warm ? "warm" : "cold", initialData.size());
+    }
+
+    VulkanPipelineCache::~VulkanPipelineCache() {
+        save();
+        config.device->destroyPipelineCache(pipelineCache);
+    }
+
+    VulkanPipelineCache::operator VkPipelineCache() const {
+        return pipelineCache;
+    }
+
+    void VulkanPipelineCache::recordCreationTime(double milliseconds) {
+        if (creationTimeRecorded) {
+            BL_LOG_INFO("Created pipelines in [{:.2f} ms]", milliseconds);
+            return;
+        }
+        creationTimeRecorded = true;
+        if (!warm) {
+            coldCreationTime = milliseconds;
+            BL_LOG_INFO("Created pipelines in [{:.2f} ms] with a cold pipeline cache", milliseconds);
+            return;
+        }
+        BL_LOG_INFO(
+            "Created pipelines in [{:.2f} ms] with a warm pipeline cache, saved [{:.2f} ms] compared to a cold cache [{:.2f} ms]",
+            milliseconds,
+            coldCreationTime - milliseconds,
+            coldCreationTime
+        );
+    }
+
+    void VulkanPipelineCache::save() const {
+        std::vector<char> data;
+        if (config.device->getPipelineCacheData(pipelineCache, &data) != VK_SUCCESS) {
+            BL_LOG_WARN("Could not get pipeline cache data");
+            return;
+        }
+
+        VulkanPipelineCacheHeader header = createHeader();
+        header.dataSize = data.size();
+        header.coldCreationTime = coldCreationTime;
+
+        std::vector<char> bytes(sizeof(VulkanPipelineCacheHeader) + data.size());
+        memcpy(bytes.data(), &header, sizeof(VulkanPipelineCacheHeader));
+        memcpy(bytes.data() + sizeof(VulkanPipelineCacheHeader), data.data(), data.size());
+
+        try {
+            config.fileSystem->writeBytes(config.path, bytes);
+            BL_LOG_INFO("Saved pipeline cache [{}], data [{} bytes]", config.path, data.size());
+        } catch (const Error& e) {
+            BL_LOG_WARN("Could not save pipeline cache [{}]: {}", config.path, e.what());
+        }
+    }
+
+    std::vector<char> VulkanPipelineCache::load() {
+        if (!config.fileSystem->exists(config.path)) {
+            return {};
+        }
+        std::vector<char> bytes = config.fileSystem->readBytes(config.path);
+        if (bytes.size() < sizeof(VulkanPipelineCacheHeader)) {
+            BL_LOG_WARN("Discarding truncated pipeline cache [{}]", config.path);
+            return {};
+        }
+
+        VulkanPipelineCacheHeader header{};
+        memcpy(&header, bytes.data(), sizeof(VulkanPipelineCacheHeader));
+        if (!isValid(header, bytes.size())) {
+            BL_LOG_INFO("Discarding pipeline cache created by another device or driver [{}]", config.path);
+            return {};
+        }
+
+        coldCreationTime = header.coldCreationTime;
+        return std::vector<char>(bytes.begin() + sizeof(VulkanPipelineCacheHeader), bytes.end());
+    }
+
+    VulkanPipelineCacheHeader VulkanPipelineCache::createHeader() const {
+        const VkPhysicalDeviceProperties& properties = config.device->getPhysicalDevice()->getProperties();
+
+        VulkanPipelineCacheHeader header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.vendorId = properties.vendorID;
+        header.deviceId = properties.deviceID;
+        header.driverVersion = properties.driverVersion;
+        memcpy(header.pipelineCacheUuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+        return header;
+    }
+
+    bool VulkanPipelineCache::isValid(const VulkanPipelineCacheHeader& header, uint64_t fileSize) const {
+        VulkanPipelineCacheHeader expectedHeader = createHeader();
+        return header.magic == expectedHeader.magic
+               && header.version == expectedHeader.version
+               && header.vendorId == expectedHeader.vendorId
+               && header.deviceId == expectedHeader.deviceId
+               && header.driverVersion == expectedHeader.driverVersion
+               && memcmp(header.pipelineCacheUuid, expectedHeader.pipelineCacheUuid, VK_UUID_SIZE) == 0
+               && header.dataSize == fileSize - sizeof(VulkanPipelineCacheHeader);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "system/FileSystem.h"
+#include "graphics/VulkanDevice.h"
+
+#include <vulkan/vulkan.h>
+
+namespace Blink {
+
+    // Written in front of the driver's cache data to detect caches created by another device or driver
+    struct VulkanPipelineCacheHeader {
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint32_t vendorId = 0;
+        uint32_t deviceId = 0;
+        uint32_t driverVersion = 0;
+        uint8_t pipelineCacheUuid[VK_UUID_SIZE]{};
+        uint64_t dataSize = 0;
+        double coldCreationTime = 0.0; // Milliseconds spent creating the pipelines when the cache was empty
+    };
+
+    struct VulkanPipelineCacheConfig {
+        FileSystem* fileSystem = nullptr;
+        VulkanDevice* device = nullptr;
+        std::string path = "pipeline_cache.bin";
+    };
+
+    //
+    // Pipeline cache shared by all pipeline creation, which lets the driver skip shader compilation for pipelines
+    // it has already compiled during an earlier run or before a shader hot reload.
+    //
+    // The cache is loaded from disk on startup and saved on shutdown. The file is discarded if it was written by a
+    // different device or driver version, since the driver would reject (or worse, misinterpret) its data.
+    //
+    class VulkanPipelineCache {
+    private:
+        static constexpr uint32_t MAGIC = 0x43504C42; // "BLPC"
+        static constexpr uint32_t VERSION = 1;
+
+    private:
+        VulkanPipelineCacheConfig config;
+        VkPipelineCache pipelineCache = nullptr;
+        bool warm = false;
+        double coldCreationTime = 0.0;
+        bool creationTimeRecorded = false;
+
+    public:
+        explicit VulkanPipelineCache(const VulkanPipelineCacheConfig& config);
+
+        ~VulkanPipelineCache();
+
+        operator VkPipelineCache() const;
+
+        // Logs how long the pipelines took to create compared to creating them with a cold cache
+        void recordCreationTime(double milliseconds);
+
+        void save() const;
+
+    private:
+        std::vector<char> load();
+
+        VulkanPipelineCacheHeader createHeader() const;
+
+        bool isValid(const VulkanPipelineCacheHeader& header, uint64_t fileSize) const;
+    };
+}
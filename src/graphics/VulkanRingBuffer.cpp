@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "VulkanRingBuffer.h"
+
+namespace Blink {
+    VulkanRingBuffer::VulkanRingBuffer(const VulkanRingBufferConfig& config) : config(config) {
+        BL_ASSERT_THROW(config.frameSize > 0);
+        BL_ASSERT_THROW(config.frameCount > 0);
+
+        VulkanBufferConfig bufferConfig{};
+        bufferConfig.device = config.device;
+        bufferConfig.size = config.frameSize * config.frameCount;
+        bufferConfig.usage = config.usage;
+        bufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        buffer = new VulkanBuffer(bufferConfig);
+        BL_ASSERT_THROW(buffer->getMappedData() != nullptr);
+    }
+
+    VulkanRingBuffer::~VulkanRingBuffer() {
+        delete buffer;
+    }
+
+    VulkanRingBuffer::operator VkBuffer() const {
+        return *buffer;
+    }
+
+    void VulkanRingBuffer::beginFrame(uint32_t frameIndex) {
+        BL_ASSERT(frameIndex < config.frameCount);
+        frameBegin = config.frameSize * frameIndex;
+        frameOffset = frameBegin;
+    }
+
+    VulkanRingBufferAllocation VulkanRingBuffer::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+        VkDeviceSize offset = alignUp(frameOffset, alignment);
+        if (offset + size > frameBegin + config.frameSize) {
+            BL_THROW("Ring buffer frame capacity exceeded [" + std::to_string(offset + size - frameBegin) + "/" + std::to_string(config.frameSize) + "]");
+        }
+        frameOffset = offset + size;
+
+        VulkanRingBufferAllocation allocation{};
+        allocation.buffer = *buffer;
+        allocation.offset = offset;
+        allocation.data = (char*) buffer->getMappedData() + offset;
+        return allocation;
+    }
+
+    VkDeviceSize VulkanRingBuffer::write(const void* data, VkDeviceSize size, VkDeviceSize alignment) {
+        VulkanRingBufferAllocation allocation = allocate(size, alignment);
+        memcpy(allocation.data, data, size);
+        return allocation.offset;
+    }
+
+    VkDeviceSize VulkanRingBuffer::getUsedSize() const {
+        return frameOffset - frameBegin;
+    }
+
+    VkDeviceSize VulkanRingBuffer::alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return alignment > 0 ? (value + alignment - 1) / alignment * alignment : value;
+    }
+}
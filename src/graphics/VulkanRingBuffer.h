@@ -0,0 +1,58 @@
+#pragma once
+
+#include "VulkanDevice.h"
+#include "VulkanBuffer.h"
+
+#include <vulkan/vulkan.h>
+
+namespace Blink {
+
+    struct VulkanRingBufferConfig {
+        VulkanDevice* device = nullptr;
+        VkBufferUsageFlags usage = 0;
+        VkDeviceSize frameSize = 0; // Capacity of each frame's region of the buffer
+        uint32_t frameCount = 0;
+    };
+
+    struct VulkanRingBufferAllocation {
+        VkBuffer buffer = nullptr;
+        VkDeviceSize offset = 0;
+        void* data = nullptr; // Mapped pointer to the start of the allocation
+    };
+
+    //
+    // Persistently mapped host visible buffer for data that is rewritten every frame (e.g. view-projection and
+    // instance transforms).
+    //
+    // The buffer is split into one region per frame in flight. Allocations bump a pointer through the region of the
+    // current frame, which is reset at the start of the frame once its fence has been waited on. Allocations are
+    // written to directly through the mapped pointer and addressed with offsets (dynamic uniform buffer offsets,
+    // vertex buffer offsets) so that no per-frame buffers have to be created, mapped or bound to new descriptors.
+    //
+    class VulkanRingBuffer {
+    private:
+        VulkanRingBufferConfig config;
+        VulkanBuffer* buffer = nullptr;
+        VkDeviceSize frameBegin = 0;
+        VkDeviceSize frameOffset = 0;
+
+    public:
+        explicit VulkanRingBuffer(const VulkanRingBufferConfig& config);
+
+        ~VulkanRingBuffer();
+
+        operator VkBuffer() const;
+
+        // Must only be called after the fence of the frame has been waited on
+        void beginFrame(uint32_t frameIndex);
+
+        VulkanRingBufferAllocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+        VkDeviceSize write(const void* data, VkDeviceSize size, VkDeviceSize alignment);
+
+        VkDeviceSize getUsedSize() const;
+
+    private:
+        static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment);
+    };
+}
@@ -32,18 +32,45 @@ namespace Blink {
         return extent;
     }
 
+    VkFramebuffer VulkanSwapChain::getFramebuffer() const {
+        return framebuffers[currentImageIndex];
+    }
+
+    VkPresentModeKHR VulkanSwapChain::getPresentMode() const {
+        return presentMode;
+    }
+
+    void VulkanSwapChain::setPresentation(const std::vector<VkPresentModeKHR>& presentModes, uint32_t additionalImageCount) {
+        config.presentModes = presentModes;
+        config.additionalImageCount = additionalImageCount;
+        recreateSwapChain();
+    }
+
     void VulkanSwapChain::onEvent(Event& event) {
         if (event.type == EventType::WindowResize || event.type == EventType::WindowMinimize) {
             windowResized = true;
         }
     }
 
-    bool VulkanSwapChain::beginFrame(uint32_t frameIndex) {
+    void VulkanSwapChain::waitForFrame(uint32_t frameIndex) const {
+        BL_ASSERT(frameIndex < config.frameCount);
+        VkFence inFlightFence = inFlightFences[frameIndex];
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitForFence(&inFlightFence));
+    }
+
+    bool VulkanSwapChain::isFrameFinished(uint32_t frameIndex) const {
+        BL_ASSERT(frameIndex < config.frameCount);
+        return config.device->getFenceStatus(inFlightFences[frameIndex]) == VK_SUCCESS;
+    }
+
+    bool VulkanSwapChain::acquireImage(uint32_t frameIndex) {
+        if (imageAcquired) {
+            return true;
+        }
         currentInFlightFence = inFlightFences[frameIndex];
         currentImageAvailableSemaphore = imageAvailableSemaphores[frameIndex];
-        currentRenderFinishedSemaphore = renderFinishedSemaphores[frameIndex];
 
-        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitForFence(&currentInFlightFence));
+        waitForFrame(frameIndex);
 
         VkResult nextImageResult = config.device->acquireSwapChainImage(swapChain, currentImageAvailableSemaphore, &currentImageIndex);
 
@@ -59,12 +86,25 @@ namespace Blink {
         if (nextImageResult != VK_SUCCESS && nextImageResult != VK_SUBOPTIMAL_KHR) {
             BL_THROW("Could not acquire next image from swap chain");
         }
+        // The presentation of the image waits on this semaphore, which can't be signaled again before the image has
+        // been presented and acquired again. With fewer frames in flight than images (e.g. one frame in flight with
+        // FIFO) a semaphore per frame in flight could still be waited on by an earlier presentation.
+        currentRenderFinishedSemaphore = renderFinishedSemaphores[currentImageIndex];
+        imageAcquired = true;
+        return true;
+    }
 
+    bool VulkanSwapChain::beginFrame(uint32_t frameIndex) {
+        if (!acquireImage(frameIndex)) {
+            return false;
+        }
+        // The fence is only reset once the frame is certain to be submitted
         BL_ASSERT_THROW_VK_SUCCESS(config.device->resetFence(&currentInFlightFence));
+        imageAcquired = false;
         return true;
     }
 
-    void VulkanSwapChain::beginRenderPass(const VulkanCommandBuffer& commandBuffer) const {
+    void VulkanSwapChain::beginRenderPass(const VulkanCommandBuffer& commandBuffer, VkSubpassContents subpassContents) const {
         VkRenderPassBeginInfo renderPassBeginInfo{};
         renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         renderPassBeginInfo.renderPass = renderPass;
@@ -74,8 +114,15 @@ namespace Blink {
         renderPassBeginInfo.clearValueCount = (uint32_t) clearValues.size();
         renderPassBeginInfo.pClearValues = clearValues.data();
 
-        vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, subpassContents);
 
+        // Commands other than vkCmdExecuteCommands can't be recorded in a subpass with secondary command buffer contents
+        if (subpassContents == VK_SUBPASS_CONTENTS_INLINE) {
+            setViewportAndScissor(commandBuffer);
+        }
+    }
+
+    void VulkanSwapChain::setViewportAndScissor(const VulkanCommandBuffer& commandBuffer) const {
         // Define _framebuffer space_ to be used after _NDC space_ (normalized device coordinates)
         //
         // Use same coordinate system as _NDC space_ (right-handed):
@@ -133,6 +180,16 @@ namespace Blink {
         presentInfo.pSwapchains = &swapChain;
         presentInfo.pImageIndices = &currentImageIndex;
 
+        // The ids keep increasing across recreated swap chains, which only requires them to increase per swap chain
+        VkPresentIdKHR presentIdInfo{};
+        if (config.device->isPresentWaitSupported()) {
+            presentId++;
+            presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+            presentIdInfo.swapchainCount = 1;
+            presentIdInfo.pPresentIds = &presentId;
+            presentInfo.pNext = &presentIdInfo;
+        }
+
         VkResult presentResult = config.device->submitToPresentQueue(&presentInfo);
         if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || windowResized) {
             windowResized = false;
@@ -142,10 +199,20 @@ namespace Blink {
         }
     }
 
+    uint64_t VulkanSwapChain::getPresentId() const {
+        return presentId;
+    }
+
+    VkResult VulkanSwapChain::getPresentStatus(uint64_t presentId) const {
+        constexpr uint64_t timeout = 0;
+        return config.device->waitForPresent(swapChain, presentId, timeout);
+    }
+
     void VulkanSwapChain::recreateSwapChain() {
         config.window->waitUntilNotMinimized();
         BL_ASSERT_THROW_VK_SUCCESS(config.device->waitUntilIdle());
 
+        destroyRenderFinishedSemaphores();
         destroyFramebuffers();
         destroyDepthImage();
         destroyColorImages();
@@ -157,6 +224,7 @@ namespace Blink {
         createColorImages();
         createDepthImage();
         createFramebuffers();
+        createRenderFinishedSemaphores();
 
         BL_LOG_INFO("Recreated swap chain");
     }
@@ -203,7 +271,7 @@ namespace Blink {
         }
 
         BL_ASSERT_THROW_VK_SUCCESS(config.device->createSwapChain(&createInfo, &swapChain));
-        BL_LOG_INFO("Created swap chain");
+        BL_LOG_INFO("Created swap chain [present mode: {}, images: {}]", getPresentModeName(presentMode), imageCount);
     }
 
     void VulkanSwapChain::destroySwapChain() const {
@@ -220,7 +288,6 @@ namespace Blink {
             imageConfig.format = surfaceFormat.format;
             imageConfig.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
             imageConfig.device = config.device;
-            imageConfig.commandPool = config.commandPool;
             auto image = new VulkanImage(imageConfig);
             colorImages.push_back(image);
         }
@@ -238,7 +305,6 @@ namespace Blink {
 
         VulkanImageConfig depthImageConfig{};
         depthImageConfig.device = config.device;
-        depthImageConfig.commandPool = config.commandPool;
         depthImageConfig.width = extent.width;
         depthImageConfig.height = extent.height;
         depthImageConfig.format = depthFormat;
@@ -247,8 +313,8 @@ namespace Blink {
         depthImageConfig.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
         depthImageConfig.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
 
+        // The render pass transitions the depth image from its undefined initial layout when it begins
         depthImage = new VulkanImage(depthImageConfig);
-        depthImage->setLayout(VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
     }
 
     void VulkanSwapChain::destroyDepthImage() const {
@@ -356,9 +422,9 @@ namespace Blink {
     }
 
     void VulkanSwapChain::createSyncObjects() {
-        imageAvailableSemaphores.resize(imageCount);
-        renderFinishedSemaphores.resize(imageCount);
-        inFlightFences.resize(imageCount);
+        // One set per frame in flight, the image count can be lower than the number of frames in flight
+        imageAvailableSemaphores.resize(config.frameCount);
+        inFlightFences.resize(config.frameCount);
 
         VkSemaphoreCreateInfo semaphoreCreateInfo{};
         semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -367,21 +433,40 @@ namespace Blink {
         fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
         fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-        for (size_t i = 0; i < imageCount; i++) {
+        for (size_t i = 0; i < config.frameCount; i++) {
             BL_ASSERT_THROW_VK_SUCCESS(config.device->createSemaphore(&semaphoreCreateInfo, &imageAvailableSemaphores[i]));
-            BL_ASSERT_THROW_VK_SUCCESS(config.device->createSemaphore(&semaphoreCreateInfo, &renderFinishedSemaphores[i]));
             BL_ASSERT_THROW_VK_SUCCESS(config.device->createFence(&fenceCreateInfo, &inFlightFences[i]));
         }
+        createRenderFinishedSemaphores();
     }
 
-    void VulkanSwapChain::destroySyncObjects() const {
-        for (size_t i = 0; i < imageCount; i++) {
+    void VulkanSwapChain::destroySyncObjects() {
+        destroyRenderFinishedSemaphores();
+        for (size_t i = 0; i < config.frameCount; i++) {
             config.device->destroySemaphore(imageAvailableSemaphores[i]);
-            config.device->destroySemaphore(renderFinishedSemaphores[i]);
             config.device->destroyFence(inFlightFences[i]);
         }
     }
 
+    void VulkanSwapChain::createRenderFinishedSemaphores() {
+        // One per swap chain image, see acquireImage
+        renderFinishedSemaphores.resize(imageCount);
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        for (size_t i = 0; i < imageCount; i++) {
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->createSemaphore(&semaphoreCreateInfo, &renderFinishedSemaphores[i]));
+        }
+    }
+
+    void VulkanSwapChain::destroyRenderFinishedSemaphores() {
+        for (VkSemaphore renderFinishedSemaphore : renderFinishedSemaphores) {
+            config.device->destroySemaphore(renderFinishedSemaphore);
+        }
+        renderFinishedSemaphores.clear();
+    }
+
     VkSurfaceFormatKHR VulkanSwapChain::getMostSuitableSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) const {
         for (const auto& availableFormat : availableFormats) {
             if (availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
@@ -392,14 +477,30 @@ namespace Blink {
     }
 
     VkPresentModeKHR VulkanSwapChain::getMostSuitablePresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) const {
-        for (const auto& availablePresentMode : availablePresentModes) {
-            if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-                return availablePresentMode;
+        // FIFO is the only present mode that is required to be supported
+        for (VkPresentModeKHR preferredPresentMode : config.presentModes) {
+            if (std::find(availablePresentModes.begin(), availablePresentModes.end(), preferredPresentMode) != availablePresentModes.end()) {
+                return preferredPresentMode;
             }
         }
         return VK_PRESENT_MODE_FIFO_KHR;
     }
 
+    std::string VulkanSwapChain::getPresentModeName(VkPresentModeKHR presentMode) {
+        switch (presentMode) {
+            case VK_PRESENT_MODE_IMMEDIATE_KHR:
+                return "immediate";
+            case VK_PRESENT_MODE_MAILBOX_KHR:
+                return "mailbox";
+            case VK_PRESENT_MODE_FIFO_KHR:
+                return "fifo";
+            case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+                return "fifo relaxed";
+            default:
+                return std::to_string(presentMode);
+        }
+    }
+
     VkExtent2D VulkanSwapChain::getMostSuitableExtent(const VkSurfaceCapabilitiesKHR& surfaceCapabilities) const {
         bool extentMustMatchWindowSize = surfaceCapabilities.currentExtent.width != std::numeric_limits<uint32_t>::max();
         if (extentMustMatchWindowSize) {
@@ -417,8 +518,9 @@ namespace Blink {
 
         // Simply sticking to the surface capability minimum means that we may sometimes have to wait on the driver to
         // complete internal operations before we can acquire another image to render to.
-        // Therefore it is recommended to request at least one more image than the minimum
-        uint32_t imageCount = minImageCount + 1;
+        // Therefore it is recommended to request at least one more image than the minimum, unless the frames should
+        // be presented with as little latency as possible.
+        uint32_t imageCount = minImageCount + config.additionalImageCount;
 
         if (maxImageCount > 0 && imageCount > maxImageCount) {
             imageCount = maxImageCount;
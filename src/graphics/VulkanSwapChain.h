@@ -2,7 +2,7 @@
 
 #include "VulkanApp.h"
 #include "VulkanDevice.h"
-#include "VulkanCommandPool.h"
+#include "VulkanCommandBuffer.h"
 #include "VulkanImage.h"
 
 namespace Blink {
@@ -10,8 +10,9 @@ namespace Blink {
         Window* window = nullptr;
         VulkanApp* vulkanApp = nullptr;
         VulkanDevice* device = nullptr;
-        VulkanCommandPool* commandPool = nullptr;
-        uint32_t frameCount = 0;
+        uint32_t frameCount = 0; // Maximum number of frames in flight
+        std::vector<VkPresentModeKHR> presentModes; // By preference, FIFO is used if none of them is available
+        uint32_t additionalImageCount = 1; // Images beyond the surface minimum, fewer images queue fewer frames for presentation
     };
 
     class VulkanSwapChain {
@@ -28,12 +29,14 @@ namespace Blink {
         std::array<VkClearValue, 2> clearValues;
         std::vector<VkFramebuffer> framebuffers;
         std::vector<VkSemaphore> imageAvailableSemaphores;
-        std::vector<VkSemaphore> renderFinishedSemaphores;
+        std::vector<VkSemaphore> renderFinishedSemaphores; // One per image, the others one per frame in flight
         std::vector<VkFence> inFlightFences;
         uint32_t currentImageIndex = 0;
         VkFence currentInFlightFence = nullptr;
         VkSemaphore currentImageAvailableSemaphore = nullptr;
         VkSemaphore currentRenderFinishedSemaphore = nullptr;
+        bool imageAcquired = false;
+        uint64_t presentId = 0; // Of the last presentation, presentations only get ids when the device supports present wait
         bool windowResized = false;
 
     public:
@@ -47,16 +50,44 @@ namespace Blink {
 
         const VkExtent2D& getExtent() const;
 
+        VkFramebuffer getFramebuffer() const;
+
+        VkPresentModeKHR getPresentMode() const;
+
+        // Recreates the swap chain
+        void setPresentation(const std::vector<VkPresentModeKHR>& presentModes, uint32_t additionalImageCount);
+
         void onEvent(Event& event);
 
+        // Waits until the GPU has finished the last submission of the frame
+        void waitForFrame(uint32_t frameIndex) const;
+
+        bool isFrameFinished(uint32_t frameIndex) const;
+
+        // Waits for the frame and acquires the image to render it to ahead of beginFrame, returns false if the swap
+        // chain had to be recreated
+        bool acquireImage(uint32_t frameIndex);
+
         bool beginFrame(uint32_t frameIndex);
 
-        void beginRenderPass(const VulkanCommandBuffer& commandBuffer) const;
+        void beginRenderPass(const VulkanCommandBuffer& commandBuffer, VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE) const;
+
+        // Dynamic state is not inherited by secondary command buffers, which have to set it themselves
+        void setViewportAndScissor(const VulkanCommandBuffer& commandBuffer) const;
 
         void endRenderPass(const VulkanCommandBuffer& commandBuffer) const;
 
         void endFrame(const VulkanCommandBuffer& commandBuffer);
 
+        // Id of the last presentation, 0 when the device does not support present wait
+        uint64_t getPresentId() const;
+
+        // VK_SUCCESS once the presentation with the id (or a later one) has been presented, VK_TIMEOUT if it has not
+        // been presented yet, does not block
+        VkResult getPresentStatus(uint64_t presentId) const;
+
+        static std::string getPresentModeName(VkPresentModeKHR presentMode);
+
     private:
         void recreateSwapChain();
 
@@ -82,7 +113,11 @@ namespace Blink {
 
         void createSyncObjects();
 
-        void destroySyncObjects() const;
+        void destroySyncObjects();
+
+        void createRenderFinishedSemaphores();
+
+        void destroyRenderFinishedSemaphores();
 
         VkSurfaceFormatKHR getMostSuitableSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) const;
 
@@ -6,7 +6,6 @@ namespace Blink {
 
         VulkanBufferConfig bufferConfig{};
         bufferConfig.device = config.device;
-        bufferConfig.commandPool = config.commandPool;
         bufferConfig.size = config.size;
         bufferConfig.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
         bufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
@@ -8,7 +8,6 @@ namespace Blink {
 
     struct VulkanUniformBufferConfig {
         VulkanDevice* device = nullptr;
-        VulkanCommandPool* commandPool = nullptr;
         VkDeviceSize size = 0;
     };
 
@@ -0,0 +1,600 @@
+#include "pch.h"
+#include "VulkanUploadContext.h"
+
+namespace Blink {
+    VulkanUploadContext::VulkanUploadContext(const VulkanUploadContextConfig& config) : config(config) {
+        const QueueFamilyIndices& queueFamilyIndices = config.device->getPhysicalDevice()->getQueueFamilyIndices();
+        graphicsQueueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+        dedicatedTransferQueue = config.device->hasTransferQueue();
+        transferQueueFamilyIndex = dedicatedTransferQueue ? queueFamilyIndices.transferFamily.value() : graphicsQueueFamilyIndex;
+
+        createCommandBuffers();
+        createSyncObjects();
+        createStagingBuffer();
+        BL_LOG_INFO("Created upload context, dedicated transfer queue [{}]", dedicatedTransferQueue);
+    }
+
+    VulkanUploadContext::~VulkanUploadContext() {
+        flush();
+        while (!submittedBatches.empty()) {
+            waitForOldestBatch();
+        }
+        destroyStagingBuffer();
+        destroySyncObjects();
+        destroyCommandBuffers();
+    }
+
+    void VulkanUploadContext::uploadBuffer(VkBuffer buffer, const void* data, VkDeviceSize size, VkDeviceSize bufferOffset) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        VkDeviceSize stagingOffset = 0;
+        VkBuffer source = stage(data, size, &stagingOffset);
+        beginRecording();
+
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = stagingOffset;
+        copyRegion.dstOffset = bufferOffset;
+        copyRegion.size = size;
+        constexpr uint32_t regionCount = 1;
+        vkCmdCopyBuffer(batches[currentBatch].transferCommandBuffer, source, buffer, regionCount, &copyRegion);
+
+        if (dedicatedTransferQueue) {
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = transferQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = graphicsQueueFamilyIndex;
+            barrier.buffer = buffer;
+            barrier.offset = bufferOffset;
+            barrier.size = size;
+
+            // Release
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            constexpr VkDependencyFlags dependencyFlags = 0;
+            constexpr uint32_t memoryBarrierCount = 0;
+            constexpr VkMemoryBarrier* memoryBarriers = nullptr;
+            constexpr uint32_t bufferMemoryBarrierCount = 1;
+            constexpr uint32_t imageMemoryBarrierCount = 0;
+            constexpr VkImageMemoryBarrier* imageMemoryBarriers = nullptr;
+            vkCmdPipelineBarrier(
+                    batches[currentBatch].transferCommandBuffer,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                    dependencyFlags,
+                    memoryBarrierCount,
+                    memoryBarriers,
+                    bufferMemoryBarrierCount,
+                    &barrier,
+                    imageMemoryBarrierCount,
+                    imageMemoryBarriers
+            );
+
+            // Acquire, recorded into the graphics command buffer when the uploads are submitted
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+            bufferAcquireBarriers.push_back(barrier);
+        }
+        pendingUploadCount++;
+    }
+
+    void VulkanUploadContext::uploadImage(VulkanImage* image, const std::shared_ptr<ImageFile>& imageFile) {
+        uploadImage(image, std::vector<std::shared_ptr<ImageFile>>{imageFile});
+    }
+
+    void VulkanUploadContext::uploadImage(VulkanImage* image, const std::vector<std::shared_ptr<ImageFile>>& imageFiles) {
+        BL_ASSERT_THROW(imageFiles.size() == image->getLayerCount());
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Levels that are not stored in the image files are generated from the base level after it has been copied
+        const bool storedMipLevels = !imageFiles[0]->levels.empty();
+        const uint32_t copiedMipLevels = storedMipLevels ? image->getMipLevels() : 1;
+        const bool generatedMipLevels = copiedMipLevels < image->getMipLevels();
+
+        beginRecording();
+        image->setLayout(batches[currentBatch].transferCommandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        for (uint32_t i = 0; i < imageFiles.size(); i++) {
+            const std::shared_ptr<ImageFile>& imageFile = imageFiles[i];
+            BL_ASSERT_THROW(imageFile->levels.empty() != storedMipLevels);
+            BL_ASSERT_THROW(!storedMipLevels || imageFile->levels.size() >= copiedMipLevels);
+
+            for (uint32_t mipLevel = 0; mipLevel < copiedMipLevels; mipLevel++) {
+                const void* pixels = storedMipLevels ? imageFile->levels[mipLevel].pixels : imageFile->pixels;
+                const uint64_t size = storedMipLevels ? imageFile->levels[mipLevel].size : imageFile->size;
+
+                // Staging can submit the recorded commands when the data wraps around the ring, which is fine in the middle
+                // of an image since the layout transition to the transfer destination layout has already been recorded
+                VkDeviceSize stagingOffset = 0;
+                VkBuffer source = stage(pixels, size, &stagingOffset);
+                beginRecording();
+
+                VkBufferImageCopy copyRegion{};
+                copyRegion.bufferOffset = stagingOffset;
+                copyRegion.bufferRowLength = 0;
+                copyRegion.bufferImageHeight = 0;
+                copyRegion.imageSubresource.aspectMask = image->getSubresourceRange().aspectMask;
+                copyRegion.imageSubresource.layerCount = 1;
+                copyRegion.imageSubresource.baseArrayLayer = i;
+                copyRegion.imageSubresource.mipLevel = mipLevel;
+                copyRegion.imageExtent.width = std::max((uint32_t) imageFile->width >> mipLevel, 1u);
+                copyRegion.imageExtent.height = std::max((uint32_t) imageFile->height >> mipLevel, 1u);
+                copyRegion.imageExtent.depth = 1;
+
+                constexpr uint32_t copyRegionCount = 1;
+                vkCmdCopyBufferToImage(
+                    batches[currentBatch].transferCommandBuffer,
+                    source,
+                    *image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    copyRegionCount,
+                    &copyRegion
+                );
+            }
+        }
+
+        if (!dedicatedTransferQueue) {
+            if (generatedMipLevels) {
+                generateMipLevels(batches[currentBatch].transferCommandBuffer, image);
+            } else {
+                image->setLayout(batches[currentBatch].transferCommandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            }
+            pendingUploadCount++;
+            return;
+        }
+
+        // The layout transition is part of the ownership transfer, the release and acquire barriers have to specify the same layouts.
+        // Images that still need their mip levels generated stay in the transfer destination layout until the blits are recorded.
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = generatedMipLevels ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcQueueFamilyIndex = transferQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = graphicsQueueFamilyIndex;
+        barrier.image = *image;
+        barrier.subresourceRange = image->getSubresourceRange();
+
+        // Release
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        constexpr VkDependencyFlags dependencyFlags = 0;
+        constexpr uint32_t memoryBarrierCount = 0;
+        constexpr VkMemoryBarrier* memoryBarriers = nullptr;
+        constexpr uint32_t bufferMemoryBarrierCount = 0;
+        constexpr VkBufferMemoryBarrier* bufferMemoryBarriers = nullptr;
+        constexpr uint32_t imageMemoryBarrierCount = 1;
+        vkCmdPipelineBarrier(
+                batches[currentBatch].transferCommandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                dependencyFlags,
+                memoryBarrierCount,
+                memoryBarriers,
+                bufferMemoryBarrierCount,
+                bufferMemoryBarriers,
+                imageMemoryBarrierCount,
+                &barrier
+        );
+
+        // Acquire, recorded into the graphics command buffer when the uploads are submitted
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = generatedMipLevels ? VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_SHADER_READ_BIT;
+        imageAcquireBarriers.push_back(barrier);
+
+        if (generatedMipLevels) {
+            mipLevelGenerationImages.push_back(image);
+        } else {
+            image->setImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        }
+        pendingUploadCount++;
+    }
+
+    uint32_t VulkanUploadContext::getMipLevelCount(const std::shared_ptr<ImageFile>& imageFile) const {
+        if (!imageFile->levels.empty()) {
+            return (uint32_t) imageFile->levels.size();
+        }
+        constexpr VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        if (!config.device->getPhysicalDevice()->isFormatSupported(imageFile->format, blitFeatures)) {
+            return 1;
+        }
+        return VulkanImage::getMipLevelCount(imageFile->width, imageFile->height);
+    }
+
+    void VulkanUploadContext::flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        submit();
+        retireCompletedBatches();
+    }
+
+    void VulkanUploadContext::createCommandBuffers() {
+        VulkanCommandPoolConfig graphicsCommandPoolConfig{};
+        graphicsCommandPoolConfig.device = config.device;
+        graphicsCommandPoolConfig.queueFamilyIndex = graphicsQueueFamilyIndex;
+        graphicsCommandPool = new VulkanCommandPool(graphicsCommandPoolConfig);
+
+        if (dedicatedTransferQueue) {
+            VulkanCommandPoolConfig transferCommandPoolConfig{};
+            transferCommandPoolConfig.device = config.device;
+            transferCommandPoolConfig.queueFamilyIndex = transferQueueFamilyIndex;
+            transferCommandPool = new VulkanCommandPool(transferCommandPoolConfig);
+        }
+
+        batches.resize(MAX_UPLOAD_BATCHES);
+        for (VulkanUploadBatch& batch : batches) {
+            BL_ASSERT_THROW_VK_SUCCESS(graphicsCommandPool->allocateCommandBuffer(&batch.graphicsCommandBuffer));
+            if (dedicatedTransferQueue) {
+                BL_ASSERT_THROW_VK_SUCCESS(transferCommandPool->allocateCommandBuffer(&batch.transferCommandBuffer));
+            } else {
+                // Without a dedicated transfer queue the copies are recorded straight into the graphics command buffer
+                batch.transferCommandBuffer = batch.graphicsCommandBuffer;
+            }
+        }
+    }
+
+    void VulkanUploadContext::destroyCommandBuffers() {
+        for (VulkanUploadBatch& batch : batches) {
+            if (dedicatedTransferQueue) {
+                transferCommandPool->freeCommandBuffer(&batch.transferCommandBuffer);
+            }
+            graphicsCommandPool->freeCommandBuffer(&batch.graphicsCommandBuffer);
+        }
+        if (dedicatedTransferQueue) {
+            delete transferCommandPool;
+        }
+        delete graphicsCommandPool;
+    }
+
+    void VulkanUploadContext::createSyncObjects() {
+        for (VulkanUploadBatch& batch : batches) {
+            VkFenceCreateInfo fenceCreateInfo{};
+            fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->createFence(&fenceCreateInfo, &batch.fence));
+
+            if (dedicatedTransferQueue) {
+                VkSemaphoreCreateInfo semaphoreCreateInfo{};
+                semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+                BL_ASSERT_THROW_VK_SUCCESS(config.device->createSemaphore(&semaphoreCreateInfo, &batch.transferSemaphore));
+            }
+        }
+    }
+
+    void VulkanUploadContext::destroySyncObjects() const {
+        for (const VulkanUploadBatch& batch : batches) {
+            if (batch.transferSemaphore != nullptr) {
+                config.device->destroySemaphore(batch.transferSemaphore);
+            }
+            config.device->destroyFence(batch.fence);
+        }
+    }
+
+    void VulkanUploadContext::createStagingBuffer() {
+        VulkanBufferConfig stagingBufferConfig{};
+        stagingBufferConfig.device = config.device;
+        stagingBufferConfig.size = config.stagingBufferSize;
+        stagingBufferConfig.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        stagingBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        stagingBuffer = new VulkanBuffer(stagingBufferConfig);
+    }
+
+    void VulkanUploadContext::destroyStagingBuffer() {
+        delete stagingBuffer;
+    }
+
+    void VulkanUploadContext::beginRecording() {
+        if (recording) {
+            return;
+        }
+        // Batches are used round-robin, so the batch to record into is only still in flight when all of them are
+        retireCompletedBatches();
+        if (submittedBatches.size() == MAX_UPLOAD_BATCHES) {
+            waitForOldestBatch();
+        }
+        VulkanUploadBatch& batch = batches[currentBatch];
+        batch.stagingBegin = stagingBufferOffset;
+        batch.stagingEnd = stagingBufferOffset;
+        BL_ASSERT_THROW_VK_SUCCESS(batch.transferCommandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
+        recording = true;
+    }
+
+    void VulkanUploadContext::submit() {
+        if (!recording) {
+            return;
+        }
+        VulkanUploadBatch& batch = batches[currentBatch];
+        VulkanCommandBuffer& graphicsCommandBuffer = batch.graphicsCommandBuffer;
+        VulkanCommandBuffer& transferCommandBuffer = batch.transferCommandBuffer;
+
+        if (dedicatedTransferQueue) {
+            BL_ASSERT_THROW_VK_SUCCESS(transferCommandBuffer.end());
+
+            BL_ASSERT_THROW_VK_SUCCESS(graphicsCommandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT));
+            constexpr VkDependencyFlags dependencyFlags = 0;
+            constexpr uint32_t memoryBarrierCount = 0;
+            constexpr VkMemoryBarrier* memoryBarriers = nullptr;
+            vkCmdPipelineBarrier(
+                    graphicsCommandBuffer,
+                    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                    VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    dependencyFlags,
+                    memoryBarrierCount,
+                    memoryBarriers,
+                    (uint32_t) bufferAcquireBarriers.size(),
+                    bufferAcquireBarriers.data(),
+                    (uint32_t) imageAcquireBarriers.size(),
+                    imageAcquireBarriers.data()
+            );
+            for (VulkanImage* image : mipLevelGenerationImages) {
+                generateMipLevels(graphicsCommandBuffer, image);
+            }
+            BL_ASSERT_THROW_VK_SUCCESS(graphicsCommandBuffer.end());
+
+            VkSubmitInfo transferSubmitInfo{};
+            transferSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            transferSubmitInfo.commandBufferCount = 1;
+            transferSubmitInfo.pCommandBuffers = transferCommandBuffer.vk_ptr();
+            transferSubmitInfo.signalSemaphoreCount = 1;
+            transferSubmitInfo.pSignalSemaphores = &batch.transferSemaphore;
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->submitToTransferQueue(&transferSubmitInfo));
+
+            VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            VkSubmitInfo graphicsSubmitInfo{};
+            graphicsSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            graphicsSubmitInfo.waitSemaphoreCount = 1;
+            graphicsSubmitInfo.pWaitSemaphores = &batch.transferSemaphore;
+            graphicsSubmitInfo.pWaitDstStageMask = &waitStage;
+            graphicsSubmitInfo.commandBufferCount = 1;
+            graphicsSubmitInfo.pCommandBuffers = graphicsCommandBuffer.vk_ptr();
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->submitToGraphicsQueue(&graphicsSubmitInfo, batch.fence));
+        } else {
+            // Make the copies visible to every draw submitted after the uploads
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+            constexpr VkDependencyFlags dependencyFlags = 0;
+            constexpr uint32_t memoryBarrierCount = 1;
+            constexpr uint32_t bufferMemoryBarrierCount = 0;
+            constexpr VkBufferMemoryBarrier* bufferMemoryBarriers = nullptr;
+            constexpr uint32_t imageMemoryBarrierCount = 0;
+            constexpr VkImageMemoryBarrier* imageMemoryBarriers = nullptr;
+            vkCmdPipelineBarrier(
+                    graphicsCommandBuffer,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                    dependencyFlags,
+                    memoryBarrierCount,
+                    &barrier,
+                    bufferMemoryBarrierCount,
+                    bufferMemoryBarriers,
+                    imageMemoryBarrierCount,
+                    imageMemoryBarriers
+            );
+            BL_ASSERT_THROW_VK_SUCCESS(graphicsCommandBuffer.end());
+
+            VkSubmitInfo submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = graphicsCommandBuffer.vk_ptr();
+            BL_ASSERT_THROW_VK_SUCCESS(config.device->submitToGraphicsQueue(&submitInfo, batch.fence));
+        }
+
+        // The staging memory of the batch is released once its fence has been seen signaled
+        batch.stagingEnd = std::max(stagingBufferOffset, batch.stagingBegin);
+        submittedBatches.push_back(currentBatch);
+        currentBatch = (currentBatch + 1) % MAX_UPLOAD_BATCHES;
+
+        BL_LOG_DEBUG("Submitted uploads [{}], staging memory [{}], batches in flight [{}]", pendingUploadCount, batch.stagingEnd - batch.stagingBegin, submittedBatches.size());
+
+        bufferAcquireBarriers.clear();
+        imageAcquireBarriers.clear();
+        mipLevelGenerationImages.clear();
+        pendingUploadCount = 0;
+        recording = false;
+    }
+
+    void VulkanUploadContext::retireCompletedBatches() {
+        while (!submittedBatches.empty() && config.device->getFenceStatus(batches[submittedBatches.front()].fence) == VK_SUCCESS) {
+            retireOldestBatch();
+        }
+    }
+
+    void VulkanUploadContext::waitForOldestBatch() {
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->waitForFence(&batches[submittedBatches.front()].fence));
+        retireOldestBatch();
+    }
+
+    void VulkanUploadContext::retireOldestBatch() {
+        VulkanUploadBatch& batch = batches[submittedBatches.front()];
+        BL_ASSERT_THROW_VK_SUCCESS(config.device->resetFence(&batch.fence));
+        for (VulkanBuffer* temporaryStagingBuffer : batch.temporaryStagingBuffers) {
+            delete temporaryStagingBuffer;
+        }
+        batch.temporaryStagingBuffers.clear();
+        batch.stagingBegin = 0;
+        batch.stagingEnd = 0;
+        submittedBatches.pop_front();
+    }
+
+    //
+    // The regions of the submitted batches follow each other around the ring in order of submission, so the region
+    // ahead of the current offset, if any, is the one of the oldest batch. Regions behind the current offset are only
+    // reached again by wrapping around.
+    //
+    VkDeviceSize VulkanUploadContext::getStagingLimit() const {
+        for (uint32_t batchIndex : submittedBatches) {
+            const VulkanUploadBatch& batch = batches[batchIndex];
+            if (batch.stagingEnd == batch.stagingBegin) {
+                continue;
+            }
+            return batch.stagingBegin >= stagingBufferOffset ? batch.stagingBegin : config.stagingBufferSize;
+        }
+        return config.stagingBufferSize;
+    }
+
+    VkBuffer VulkanUploadContext::stage(const void* data, VkDeviceSize size, VkDeviceSize* stagingOffset) {
+        beginRecording();
+        if (size > config.stagingBufferSize) {
+            VulkanBufferConfig temporaryStagingBufferConfig{};
+            temporaryStagingBufferConfig.device = config.device;
+            temporaryStagingBufferConfig.size = size;
+            temporaryStagingBufferConfig.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            temporaryStagingBufferConfig.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+            temporaryStagingBufferConfig.memoryStrategy = VulkanMemoryStrategy::Linear;
+
+            auto temporaryStagingBuffer = new VulkanBuffer(temporaryStagingBufferConfig);
+            temporaryStagingBuffer->setData(data, size);
+            batches[currentBatch].temporaryStagingBuffers.push_back(temporaryStagingBuffer);
+            *stagingOffset = 0;
+            return *temporaryStagingBuffer;
+        }
+
+        // Buffer to image copies require offsets that are a multiple of the texel block size and of 4
+        constexpr VkDeviceSize stagingAlignment = 16;
+        VkDeviceSize offset = alignUp(stagingBufferOffset, stagingAlignment);
+        while (offset + size > getStagingLimit()) {
+            if (getStagingLimit() == config.stagingBufferSize) {
+                // The data doesn't fit before the end of the ring, the recorded batch is submitted so that its region
+                // doesn't wrap around, and the data is staged at the start of the ring
+                submit();
+                stagingBufferOffset = 0;
+                beginRecording();
+            } else {
+                // The region ahead is still read by a batch in flight
+                waitForOldestBatch();
+            }
+            offset = alignUp(stagingBufferOffset, stagingAlignment);
+        }
+        stagingBuffer->setData(data, size, offset);
+        stagingBufferOffset = offset + size;
+        *stagingOffset = offset;
+        return *stagingBuffer;
+    }
+
+    //
+    // Each level is blitted from the previous one, which is transitioned to the transfer source layout for the blit
+    // and to the shader read-only layout once the next level has been written.
+    //
+    void VulkanUploadContext::generateMipLevels(VkCommandBuffer commandBuffer, VulkanImage* image) {
+        int32_t mipWidth = (int32_t) image->getWidth();
+        int32_t mipHeight = (int32_t) image->getHeight();
+
+        for (uint32_t mipLevel = 1; mipLevel < image->getMipLevels(); mipLevel++) {
+            recordMipLevelBarrier(
+                    commandBuffer,
+                    image,
+                    mipLevel - 1,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_ACCESS_TRANSFER_READ_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT
+            );
+
+            int32_t nextMipWidth = std::max(mipWidth / 2, 1);
+            int32_t nextMipHeight = std::max(mipHeight / 2, 1);
+
+            VkImageBlit blit{};
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = mipLevel - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = image->getLayerCount();
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {nextMipWidth, nextMipHeight, 1};
+            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.dstSubresource.mipLevel = mipLevel;
+            blit.dstSubresource.baseArrayLayer = 0;
+            blit.dstSubresource.layerCount = image->getLayerCount();
+
+            constexpr uint32_t regionCount = 1;
+            vkCmdBlitImage(
+                    commandBuffer,
+                    *image,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    *image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    regionCount,
+                    &blit,
+                    VK_FILTER_LINEAR
+            );
+
+            recordMipLevelBarrier(
+                    commandBuffer,
+                    image,
+                    mipLevel - 1,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_ACCESS_TRANSFER_READ_BIT,
+                    VK_ACCESS_SHADER_READ_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+            );
+
+            mipWidth = nextMipWidth;
+            mipHeight = nextMipHeight;
+        }
+
+        // The last level is only ever written
+        recordMipLevelBarrier(
+                commandBuffer,
+                image,
+                image->getMipLevels() - 1,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_ACCESS_TRANSFER_WRITE_BIT,
+                VK_ACCESS_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+        );
+        image->setImageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    void VulkanUploadContext::recordMipLevelBarrier(
+            VkCommandBuffer commandBuffer,
+            VulkanImage* image,
+            uint32_t mipLevel,
+            VkImageLayout oldLayout,
+            VkImageLayout newLayout,
+            VkAccessFlags srcAccessMask,
+            VkAccessFlags dstAccessMask,
+            VkPipelineStageFlags srcStageMask,
+            VkPipelineStageFlags dstStageMask
+    ) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcAccessMask = srcAccessMask;
+        barrier.dstAccessMask = dstAccessMask;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = *image;
+        barrier.subresourceRange = image->getSubresourceRange();
+        barrier.subresourceRange.baseMipLevel = mipLevel;
+        barrier.subresourceRange.levelCount = 1;
+
+        constexpr VkDependencyFlags dependencyFlags = 0;
+        constexpr uint32_t memoryBarrierCount = 0;
+        constexpr VkMemoryBarrier* memoryBarriers = nullptr;
+        constexpr uint32_t bufferMemoryBarrierCount = 0;
+        constexpr VkBufferMemoryBarrier* bufferMemoryBarriers = nullptr;
+        constexpr uint32_t imageMemoryBarrierCount = 1;
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                srcStageMask,
+                dstStageMask,
+                dependencyFlags,
+                memoryBarrierCount,
+                memoryBarriers,
+                bufferMemoryBarrierCount,
+                bufferMemoryBarriers,
+                imageMemoryBarrierCount,
+                &barrier
+        );
+    }
+
+    VkDeviceSize VulkanUploadContext::alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "VulkanDevice.h"
+#include "VulkanCommandPool.h"
+#include "VulkanCommandBuffer.h"
+#include "VulkanBuffer.h"
+#include "VulkanImage.h"
+#include "system/FileSystem.h"
+
+#include <vulkan/vulkan.h>
+#include <deque>
+#include <mutex>
+
+namespace Blink {
+
+    struct VulkanUploadContextConfig {
+        VulkanDevice* device = nullptr;
+        VkDeviceSize stagingBufferSize = 32 * 1024 * 1024;
+    };
+
+    // Commands and staging memory of one submission of uploads, reused once its fence has been signaled
+    struct VulkanUploadBatch {
+        VulkanCommandBuffer graphicsCommandBuffer;
+        VulkanCommandBuffer transferCommandBuffer; // Same as the graphics command buffer without a dedicated transfer queue
+        VkSemaphore transferSemaphore = nullptr;
+        VkFence fence = nullptr;
+        VkDeviceSize stagingBegin = 0; // Region of the staging ring read by the batch, which never wraps around
+        VkDeviceSize stagingEnd = 0;
+        std::vector<VulkanBuffer*> temporaryStagingBuffers;
+    };
+
+    //
+    // Batches buffer and image uploads into a single command buffer instead of submitting and idling the graphics
+    // queue for every copy and layout transition.
+    //
+    // Source data is copied into a persistently mapped staging ring buffer. Uploads are recorded into a batch until
+    // flush() is called (or the staging data reaches the end of the ring), which submits the batch without waiting for
+    // it. Every batch has its own fence, and its region of the ring (and any temporary staging buffers for uploads
+    // that are larger than the whole ring) is reused once the fence has been seen signaled. The CPU only waits for a
+    // batch when the ring has no free region left for the data being staged, or when every batch is in flight.
+    //
+    // Later submissions to the graphics queue are ordered after the uploads by the barriers at the end of every batch,
+    // so the uploaded resources can be used by the next frame without waiting for the batch to complete.
+    //
+    // When the device has a dedicated transfer queue the copies are submitted to it and ownership of the uploaded
+    // resources is released to the graphics queue family, which acquires it in a second command buffer that waits
+    // on the transfer submission with a semaphore.
+    //
+    // Images either get the mip levels stored in their files, or have them generated from the base level by a chain
+    // of blits. Blits need a graphics queue, so with a dedicated transfer queue they are recorded after the acquire.
+    //
+    class VulkanUploadContext {
+    private:
+        static constexpr uint32_t MAX_UPLOAD_BATCHES = 4;
+
+    private:
+        VulkanUploadContextConfig config;
+        uint32_t graphicsQueueFamilyIndex = 0;
+        uint32_t transferQueueFamilyIndex = 0;
+        bool dedicatedTransferQueue = false;
+        VulkanCommandPool* graphicsCommandPool = nullptr;
+        VulkanCommandPool* transferCommandPool = nullptr;
+        std::vector<VulkanUploadBatch> batches;
+        uint32_t currentBatch = 0; // Recorded into, batches are used round-robin
+        std::deque<uint32_t> submittedBatches; // In order of submission, until their fences have been seen signaled
+        VulkanBuffer* stagingBuffer = nullptr;
+        VkDeviceSize stagingBufferOffset = 0; // Where the next staged data is written
+        std::vector<VkBufferMemoryBarrier> bufferAcquireBarriers;
+        std::vector<VkImageMemoryBarrier> imageAcquireBarriers;
+        std::vector<VulkanImage*> mipLevelGenerationImages;
+        bool recording = false;
+        uint32_t pendingUploadCount = 0;
+        std::mutex mutex;
+
+    public:
+        explicit VulkanUploadContext(const VulkanUploadContextConfig& config);
+
+        ~VulkanUploadContext();
+
+        void uploadBuffer(VkBuffer buffer, const void* data, VkDeviceSize size, VkDeviceSize bufferOffset = 0);
+
+        void uploadImage(VulkanImage* image, const std::shared_ptr<ImageFile>& imageFile);
+
+        void uploadImage(VulkanImage* image, const std::vector<std::shared_ptr<ImageFile>>& imageFiles);
+
+        // Levels stored in the image file, or a full mip chain if the levels can be generated when the image is uploaded
+        uint32_t getMipLevelCount(const std::shared_ptr<ImageFile>& imageFile) const;
+
+        // Submits all recorded uploads without waiting for them to complete
+        void flush();
+
+    private:
+        void createCommandBuffers();
+
+        void destroyCommandBuffers();
+
+        void createSyncObjects();
+
+        void destroySyncObjects() const;
+
+        void createStagingBuffer();
+
+        void destroyStagingBuffer();
+
+        void beginRecording();
+
+        void submit();
+
+        // Releases the staging memory of the submitted batches that have completed, without waiting for any of them
+        void retireCompletedBatches();
+
+        void waitForOldestBatch();
+
+        void retireOldestBatch();
+
+        // End of the free region of the staging ring that starts at the current offset
+        VkDeviceSize getStagingLimit() const;
+
+        VkBuffer stage(const void* data, VkDeviceSize size, VkDeviceSize* stagingOffset);
+
+        // Expects all levels in the transfer destination layout and leaves them in the shader read-only layout
+        static void generateMipLevels(VkCommandBuffer commandBuffer, VulkanImage* image);
+
+        static void recordMipLevelBarrier(
+                VkCommandBuffer commandBuffer,
+                VulkanImage* image,
+                uint32_t mipLevel,
+                VkImageLayout oldLayout,
+                VkImageLayout newLayout,
+                VkAccessFlags srcAccessMask,
+                VkAccessFlags dstAccessMask,
+                VkPipelineStageFlags srcStageMask,
+                VkPipelineStageFlags dstStageMask
+        );
+
+        static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment);
+    };
+}
@@ -1,8 +1,8 @@
 #pragma once
 
-#include "VulkanCommandPool.h"
 #include "VulkanDevice.h"
 #include "VulkanBuffer.h"
+#include "VulkanUploadContext.h"
 
 #include <vulkan/vulkan.h>
 
@@ -10,7 +10,7 @@ namespace Blink {
 
     struct VulkanVertexBufferConfig {
         VulkanDevice* device = nullptr;
-        VulkanCommandPool* commandPool = nullptr;
+        VulkanUploadContext* uploadContext = nullptr;
         VkDeviceSize size = 0;
     };
 
@@ -18,7 +18,6 @@ namespace Blink {
     private:
         VulkanVertexBufferConfig config;
         VulkanBuffer* buffer = nullptr;
-        VulkanBuffer* stagingBuffer = nullptr;
 
     public:
         explicit VulkanVertexBuffer(const VulkanVertexBufferConfig& config);
@@ -27,7 +26,8 @@ namespace Blink {
 
         operator VkBuffer() const;
 
-        void setData(void* vertices) const;
+        // Stages the data, the copy into the buffer is executed when the upload context is flushed
+        void setData(const void* vertices) const;
 
         void bind(VkCommandBuffer commandBuffer) const;
     };
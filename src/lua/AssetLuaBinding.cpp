@@ -0,0 +1,149 @@
+#include "AssetLuaBinding.h"
+
+namespace Blink {
+    AssetLuaBinding::AssetLuaBinding(Scene* scene) : scene(scene) {
+    }
+
+    void AssetLuaBinding::initialize(lua_State* L, Scene* scene) {
+        std::string typeName = "Assets";
+        std::string metatableName = typeName + "__meta";
+
+        // Allocate memory for the C++ object and push a userdata onto the Lua stack
+        void* userdata = lua_newuserdata(L, sizeof(AssetLuaBinding));
+
+        // Construct the C++ object in the allocated memory block
+        new(userdata) AssetLuaBinding(scene);
+
+        // Create a new metatable and push it onto the Lua stack
+        luaL_newmetatable(L, metatableName.c_str());
+
+        // Set the __gc metamethod of the metatable to binding destroy function
+        lua_pushstring(L, "__gc");
+        lua_pushcfunction(L, AssetLuaBinding::destroy);
+        lua_settable(L, -3);
+
+        // Set the __index metamethod of the metatable to binding index function
+        lua_pushstring(L, "__index");
+        constexpr int upvalueCount = 0;
+        lua_pushcclosure(L, AssetLuaBinding::index, upvalueCount);
+        lua_settable(L, -3);
+
+        // Set the newly created metatable as the metatable of the userdata
+        lua_setmetatable(L, -2);
+
+        // Create Lua object to represent the userdata (C++ object) in Lua code
+        lua_newtable(L);
+
+        // Associate the Lua object with the userdata (C++ object) by assigning the Lua object as the userdata's user value
+        lua_setuservalue(L, -2);
+
+        // Create a global Lua variable and associate the userdata (C++ object) with it
+        lua_setglobal(L, typeName.c_str());
+    }
+
+    // Lua stack
+    // - [-1] userdata  Binding
+    int AssetLuaBinding::destroy(lua_State* L) {
+        auto* binding = (AssetLuaBinding*) lua_touserdata(L, -1);
+        binding->~AssetLuaBinding();
+        return 0;
+    }
+
+    // Lua stack
+    // - [-1] string    Name of the index being accessed
+    // - [-2] userdata  Binding
+    int AssetLuaBinding::index(lua_State* L) {
+        std::string indexName = lua_tostring(L, -1);
+        if (indexName == "preloadMesh") {
+            lua_pushcfunction(L, AssetLuaBinding::preloadMesh);
+            return 1;
+        }
+        if (indexName == "preloadSkybox") {
+            lua_pushcfunction(L, AssetLuaBinding::preloadSkybox);
+            return 1;
+        }
+        BL_LOG_WARN("Could not resolve index [{}]", indexName);
+        return 0;
+    }
+
+    // Lua stack
+    // - [-1] table     Mesh component
+    // - [-2] userdata  Binding
+    int AssetLuaBinding::preloadMesh(lua_State* L) {
+        // Lua errors unwind with longjmp, so the arguments are checked before any C++ object is constructed
+        if (!lua_istable(L, -1)) {
+            return luaL_error(L, "Could not preload mesh: expected a mesh component table");
+        }
+        lua_getfield(L, -1, "modelPath");
+        bool validModelPath = lua_isstring(L, -1);
+        lua_pop(L, 1);
+        if (!validModelPath) {
+            return luaL_error(L, "Could not preload mesh: modelPath must be a string");
+        }
+        for (const char* fieldName : {"textureAtlasPath", "texturesDirectoryPath"}) {
+            lua_getfield(L, -1, fieldName);
+            bool valid = lua_isnil(L, -1) || lua_isstring(L, -1);
+            lua_pop(L, 1);
+            if (!valid) {
+                return luaL_error(L, "Could not preload mesh: %s must be a string", fieldName);
+            }
+        }
+
+        MeshInfo meshInfo{};
+        {
+            lua_getfield(L, -1, "modelPath");
+            meshInfo.modelPath = lua_tostring(L, -1);
+            lua_pop(L, 1);
+        }
+        {
+            lua_getfield(L, -1, "textureAtlasPath");
+            bool missing = lua_isnil(L, -1);
+            if (!missing) {
+                meshInfo.textureAtlasPath = lua_tostring(L, -1);
+            }
+            lua_pop(L, 1);
+        }
+        {
+            lua_getfield(L, -1, "texturesDirectoryPath");
+            bool missing = lua_isnil(L, -1);
+            if (!missing) {
+                meshInfo.texturesDirectoryPath = lua_tostring(L, -1);
+            }
+            lua_pop(L, 1);
+        }
+        SceneAssets assets{};
+        assets.meshInfos.push_back(meshInfo);
+
+        auto binding = (AssetLuaBinding*) lua_touserdata(L, -2);
+        binding->scene->preload(assets);
+        return 0;
+    }
+
+    // Lua stack
+    // - [-1] table     Skybox image file paths list
+    // - [-2] userdata  Binding
+    int AssetLuaBinding::preloadSkybox(lua_State* L) {
+        // Lua errors unwind with longjmp, so the arguments are checked before any C++ object is constructed
+        if (!lua_istable(L, -1)) {
+            return luaL_error(L, "Could not preload skybox: expected a list of image file paths");
+        }
+        for (int i = 0; i < Skybox::FACE_COUNT; ++i) {
+            lua_geti(L, -1, i + 1);
+            bool valid = lua_isstring(L, -1);
+            lua_pop(L, 1);
+            if (!valid) {
+                return luaL_error(L, "Could not preload skybox: image file path %d must be a string", i + 1);
+            }
+        }
+
+        SceneAssets assets{};
+        for (int i = 0; i < Skybox::FACE_COUNT; ++i) {
+            lua_geti(L, -1, i + 1);
+            assets.skyboxImagePaths.emplace_back(lua_tostring(L, -1));
+            lua_pop(L, 1);
+        }
+        auto binding = (AssetLuaBinding*) lua_touserdata(L, -2);
+        binding->scene->preload(assets);
+        return 0;
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "scene/Scene.h"
+
+namespace Blink {
+    class AssetLuaBinding {
+    private:
+        Scene* scene;
+
+    public:
+        explicit AssetLuaBinding(Scene* scene);
+
+        static void initialize(lua_State* L, Scene* scene);
+
+    private:
+        static int destroy(lua_State* L);
+
+        static int index(lua_State* L);
+
+        static int preloadMesh(lua_State* L);
+
+        static int preloadSkybox(lua_State* L);
+    };
+}
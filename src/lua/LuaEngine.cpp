@@ -1,10 +1,12 @@
 #include "pch.h"
 #include "lua/LuaEngine.h"
 #include "lua/luaUtils.h"
+#include "lua/AssetLuaBinding.h"
 #include "lua/CoordinateSystemLuaBinding.h"
 #include "lua/EntityLuaBinding.h"
 #include "lua/GlmLuaBinding.h"
 #include "lua/KeyboardLuaBinding.h"
+#include "lua/RendererLuaBinding.h"
 #include "lua/SceneCameraLuaBinding.h"
 #include "lua/SkyboxLuaBinding.h"
 #include "lua/WindowLuaBinding.h"
@@ -28,10 +30,12 @@ namespace Blink {
     }
 
     void LuaEngine::initializeCoreBindings(Scene* scene) const {
+        AssetLuaBinding::initialize(L, scene);
         CoordinateSystemLuaBinding::initialize(L);
         EntityLuaBinding::initialize(L, scene);
         GlmLuaBinding::initialize(L);
         KeyboardLuaBinding::initialize(L, config.keyboard);
+        RendererLuaBinding::initialize(L, config.renderer);
         SceneCameraLuaBinding::initialize(L, config.sceneCamera);
         SkyboxLuaBinding::initialize(L, scene);
         WindowLuaBinding::initialize(L, config.window);
@@ -184,6 +188,110 @@ namespace Blink {
         lua_pop(L, lua_gettop(L));
     }
 
+    //
+    // Runs the scene script in a separate Lua state to collect the files the scene uses, so that they can be preloaded
+    // before the scene is created.
+    //
+    // The scene itself can not be created this way, since the bindings of its scripts are registered on the Lua state
+    // shared with the current scene. The separate state only has the bindings without side effects (glm, coordinate
+    // system and window). Entity, Skybox and the other bindings that change the engine are replaced by stubs, where
+    // Entity:setMeshComponent and Skybox:setSkybox record their arguments and everything else does nothing.
+    //
+    // Scripts that depend on the return values of the stubs can fail, in which case false is returned and the scene has
+    // to be created without preloading its files.
+    //
+    bool LuaEngine::readSceneAssets(const std::string& sceneFilePath, SceneAssets* assets) const {
+        static const char* stubs = R"(
+            SceneAssets = { meshComponents = {}, skyboxImagePaths = {} }
+            local ignored = setmetatable({}, { __index = function() return function() end end })
+            Entity = setmetatable({
+                create = function() return 0 end,
+                setMeshComponent = function(_, _, meshComponent) table.insert(SceneAssets.meshComponents, meshComponent) end,
+            }, getmetatable(ignored))
+            Skybox = { setSkybox = function(_, paths) SceneAssets.skyboxImagePaths = paths end }
+            Assets = ignored
+            Keyboard = ignored
+            Renderer = ignored
+            SceneCamera = ignored
+        )";
+        static const char* tableName = "Scene";
+        static const char* functionNames[] = {"onConfigureSkybox", "onConfigureCamera", "onCreateEntities"};
+
+        lua_State* sceneL = luaL_newstate();
+        luaL_openlibs(sceneL);
+        luaL_dostring(sceneL, "package.path = './lua/?.out;' .. package.path");
+        lua_pushcfunction(sceneL, LuaEngine::printLuaMessage);
+        lua_setglobal(sceneL, "print");
+        CoordinateSystemLuaBinding::initialize(sceneL);
+        GlmLuaBinding::initialize(sceneL);
+        WindowLuaBinding::initialize(sceneL, config.window);
+
+        bool succeeded = luaL_dostring(sceneL, stubs) == LUA_OK;
+        if (succeeded) {
+            lua_newtable(sceneL);
+            lua_setglobal(sceneL, tableName);
+            succeeded = luaL_dofile(sceneL, sceneFilePath.c_str()) == LUA_OK;
+        }
+        for (const char* functionName : functionNames) {
+            if (!succeeded) {
+                break;
+            }
+            lua_getglobal(sceneL, tableName);
+            lua_getfield(sceneL, -1, functionName);
+            bool functionMissing = lua_isnil(sceneL, -1);
+            if (functionMissing) {
+                lua_pop(sceneL, lua_gettop(sceneL));
+                continue;
+            }
+            constexpr int argumentCount = 0;
+            constexpr int returnValueCount = 0;
+            constexpr int errorHandlerIndex = 0;
+            succeeded = lua_pcall(sceneL, argumentCount, returnValueCount, errorHandlerIndex) == LUA_OK;
+            if (succeeded) {
+                lua_pop(sceneL, lua_gettop(sceneL));
+            }
+        }
+        if (!succeeded) {
+            const char* errorMessage = lua_tostring(sceneL, -1);
+            BL_LOG_WARN("Could not read assets of scene [{}]: {}", sceneFilePath, errorMessage != nullptr ? errorMessage : "unknown error");
+            lua_close(sceneL);
+            return false;
+        }
+
+        lua_getglobal(sceneL, "SceneAssets");
+        lua_getfield(sceneL, -1, "meshComponents");
+        auto meshComponentCount = (lua_Integer) luaL_len(sceneL, -1);
+        for (lua_Integer i = 1; i <= meshComponentCount; i++) {
+            lua_geti(sceneL, -1, i);
+            MeshInfo meshInfo{};
+            if (readStringField(sceneL, "modelPath", &meshInfo.modelPath)) {
+                readStringField(sceneL, "textureAtlasPath", &meshInfo.textureAtlasPath);
+                readStringField(sceneL, "texturesDirectoryPath", &meshInfo.texturesDirectoryPath);
+                assets->meshInfos.push_back(meshInfo);
+            }
+            lua_pop(sceneL, 1);
+        }
+        lua_pop(sceneL, 1);
+        lua_getfield(sceneL, -1, "skyboxImagePaths");
+        auto skyboxImagePathCount = (lua_Integer) luaL_len(sceneL, -1);
+        for (lua_Integer i = 1; i <= skyboxImagePathCount; i++) {
+            lua_geti(sceneL, -1, i);
+            if (lua_isstring(sceneL, -1)) {
+                assets->skyboxImagePaths.emplace_back(lua_tostring(sceneL, -1));
+            }
+            lua_pop(sceneL, 1);
+        }
+
+        lua_close(sceneL);
+        BL_LOG_INFO(
+            "Read assets of scene [{}] [meshes: {}, skybox images: {}]",
+            sceneFilePath,
+            assets->meshInfos.size(),
+            assets->skyboxImagePaths.size()
+        );
+        return true;
+    }
+
     void LuaEngine::updateEntity(entt::entity entity, const LuaComponent& luaComponent, const TagComponent& tagComponent, double timestep) const {
         static const char* functionName = "onUpdate";
         std::string tableName = luaComponent.type;
@@ -243,6 +351,16 @@ namespace Blink {
         lua_close(L);
     }
 
+    bool LuaEngine::readStringField(lua_State* L, const char* fieldName, std::string* value) {
+        lua_getfield(L, -1, fieldName);
+        bool isString = lua_isstring(L, -1);
+        if (isString) {
+            *value = lua_tostring(L, -1);
+        }
+        lua_pop(L, 1);
+        return isString;
+    }
+
     int LuaEngine::printLuaMessage(lua_State* L) {
         const char* msg = lua_tostring(L, -1);
         BL_LOG_INFO("[LUA] - {}", msg);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "graphics/Renderer.h"
 #include "scene/Components.h"
 #include "scene/SceneCamera.h"
 #include "window/Keyboard.h"
@@ -9,11 +10,13 @@
 #include <entt/entt.hpp>
 
 namespace Blink {
-    // Forward declaration
+    // Forward declarations
     class Scene;
+    struct SceneAssets;
 
     struct LuaEngineConfig {
         Keyboard* keyboard;
+        Renderer* renderer;
         SceneCamera* sceneCamera;
         Window* window;
     };
@@ -40,6 +43,9 @@ namespace Blink {
 
         void createEntities(const std::string& sceneFilePath) const;
 
+        // Collects the files used by a scene without creating it, see the implementation for details
+        bool readSceneAssets(const std::string& sceneFilePath, SceneAssets* assets) const;
+
         void updateEntity(entt::entity entity, const LuaComponent& luaComponent, const TagComponent& tagComponent, double timestep) const;
 
         void compileLuaFiles() const;
@@ -49,6 +55,8 @@ namespace Blink {
 
         void terminate() const;
 
+        static bool readStringField(lua_State* L, const char* fieldName, std::string* value);
+
         static int printLuaMessage(lua_State* L);
 
         static int printLuaError(lua_State* L);
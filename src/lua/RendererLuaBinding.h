@@ -0,0 +1,27 @@
+#pragma once
+
+#include "graphics/Renderer.h"
+
+#include <lua.hpp>
+
+namespace Blink {
+    class RendererLuaBinding {
+    private:
+        Renderer* renderer;
+
+    private:
+        explicit RendererLuaBinding(Renderer* renderer);
+
+        ~RendererLuaBinding() = default;
+
+    public:
+        static void initialize(lua_State* L, Renderer* renderer);
+
+    private:
+        static int destroy(lua_State* L);
+
+        static int index(lua_State* L);
+
+        static int getGpuPassTimes(lua_State* L);
+    };
+}
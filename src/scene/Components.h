@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graphics/Mesh.h"
+#include "graphics/MeshCuller.h"
 #include "graphics/MeshManager.h"
 
 #include <glm/glm.hpp>
@@ -39,6 +40,8 @@ namespace Blink {
     struct MeshComponent {
         std::shared_ptr<Mesh> mesh;
         MeshInfo meshInfo;
+        glm::mat4 model = glm::mat4(1.0f);
+        uint32_t meshObjectId = MeshCuller::INVALID_OBJECT; // Only set if the renderer supports GPU culling
     };
 
     struct CameraComponent {
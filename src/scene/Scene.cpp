@@ -133,7 +133,11 @@ namespace Blink {
         for (const entt::entity entity : entityRegistry.view<TransformComponent, MeshComponent>()) {
             auto& transformComponent = entityRegistry.get<TransformComponent>(entity);
             auto& meshComponent = entityRegistry.get<MeshComponent>(entity);
-            meshComponent.mesh->model = transformComponent.translation * transformComponent.rotation * transformComponent.scale;
+            glm::mat4 model = transformComponent.translation * transformComponent.rotation * transformComponent.scale;
+            if (meshComponent.meshObjectId != MeshCuller::INVALID_OBJECT && model != meshComponent.model) {
+                movedMeshEntities.push_back(entity);
+            }
+            meshComponent.model = model;
         }
 
         // Calculate camera view-projection
@@ -159,21 +163,87 @@ namespace Blink {
             viewProjection.projection = config.sceneCamera->projection;
         }
         config.renderer->setViewProjection(viewProjection);
+        config.renderer->setMeshLodSelection(LOD_SCREEN_SIZE, config.lodBias);
 
         // Render skybox
         if (skybox != nullptr) {
             config.renderer->renderSkybox(skybox);
         }
 
-        // Render all meshes in the scene
+        // The mesh objects are kept up to date even while they are not drawn, so that GPU culling can be toggled at any time
+        statistics = {};
+        if (config.renderer->isGpuCullingSupported()) {
+            updateMeshObjects();
+        }
+        if (config.renderer->isGpuCullingActive()) {
+            // Culled on the GPU, so every mesh is counted as visible
+            statistics.visibleMeshes = (uint32_t) entityRegistry.view<MeshComponent>().size();
+            return;
+        }
+
+        // Render all meshes in the scene that are inside the camera frustum
+        const Frustum frustum(viewProjection.projection * viewProjection.view);
         for (const entt::entity entity : entityRegistry.view<MeshComponent>()) {
             auto& meshComponent = entityRegistry.get<MeshComponent>(entity);
             bool isActiveCameraEntity = activeCameraEntity != entt::null && entity == activeCameraEntity;
             if (isActiveCameraEntity) {
                 continue; // Don't draw the mesh of the currently active camera entity
             }
-            config.renderer->renderMesh(meshComponent.mesh);
+            if (!isVisible(frustum, meshComponent.mesh->bounds, meshComponent.model)) {
+                statistics.culledMeshes++;
+                continue;
+            }
+            statistics.visibleMeshes++;
+            uint32_t lod = selectLod(*meshComponent.mesh, meshComponent.model, viewProjection);
+            config.renderer->renderMesh(meshComponent.mesh, meshComponent.model, lod);
+        }
+    }
+
+    bool Scene::isVisible(const Frustum& frustum, const MeshBounds& bounds, const glm::mat4& model) {
+        // Cheap sphere test first, scaling the radius by the largest axis scale to stay conservative
+        glm::vec3 center = model * glm::vec4(bounds.center, 1.0f);
+        if (!frustum.intersectsSphere(center, bounds.radius * getMaxScale(model))) {
+            return false;
+        }
+
+        // Tighter test against the world space AABB enclosing the transformed object space AABB
+        glm::vec3 boxCenter = model * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.0f);
+        glm::vec3 boxExtents = (bounds.max - bounds.min) * 0.5f;
+        glm::mat3 absoluteModel = glm::mat3(glm::abs(glm::vec3(model[0])), glm::abs(glm::vec3(model[1])), glm::abs(glm::vec3(model[2])));
+        return frustum.intersectsBox(boxCenter, absoluteModel * boxExtents);
+    }
+
+    //
+    // Select a level of detail from the projected size of the mesh's bounding sphere.
+    //
+    // Every level has about half the triangles of the previous one, so the next level is used every time the projected
+    // radius halves.
+    //
+    uint32_t Scene::selectLod(const Mesh& mesh, const glm::mat4& model, const ViewProjection& viewProjection) const {
+        if (mesh.lods.size() < 2) {
+            return 0;
+        }
+        glm::vec3 viewSpaceCenter = viewProjection.view * model * glm::vec4(mesh.bounds.center, 1.0f);
+        float distance = glm::length(viewSpaceCenter);
+        float radius = mesh.bounds.radius * getMaxScale(model);
+        if (distance <= radius) {
+            return 0; // Camera is inside the bounding sphere
         }
+        // projection[1][1] is 1 / tan(fov / 2), which turns the radius at the distance into a fraction of the viewport's half height
+        float screenSize = radius * viewProjection.projection[1][1] / distance * config.lodBias;
+        if (screenSize >= LOD_SCREEN_SIZE) {
+            return 0;
+        }
+        auto lod = (uint32_t) std::log2(LOD_SCREEN_SIZE / screenSize) + 1;
+        return std::min(lod, (uint32_t) mesh.lods.size() - 1);
+    }
+
+    float Scene::getMaxScale(const glm::mat4& model) {
+        return std::max({
+            glm::length(glm::vec3(model[0])),
+            glm::length(glm::vec3(model[1])),
+            glm::length(glm::vec3(model[2]))
+        });
     }
 
     entt::entity Scene::createEntity() {
@@ -182,6 +252,27 @@ namespace Blink {
 
     void Scene::setSkybox(const std::vector<std::string>& imageFilePaths) {
         skybox = config.skyboxManager->getSkybox(imageFilePaths);
+        skyboxImagePaths = imageFilePaths;
+    }
+
+    SceneAssets Scene::getAssets() const {
+        SceneAssets assets{};
+        for (const entt::entity entity : entityRegistry.view<const MeshComponent>()) {
+            assets.meshInfos.push_back(entityRegistry.get<const MeshComponent>(entity).meshInfo);
+        }
+        assets.skyboxImagePaths = skyboxImagePaths;
+        return assets;
+    }
+
+    void Scene::preload(const SceneAssets& assets) const {
+        config.meshManager->preloadMeshes(assets.meshInfos);
+        if (!assets.skyboxImagePaths.empty()) {
+            config.skyboxManager->preloadSkybox(assets.skyboxImagePaths);
+        }
+    }
+
+    const SceneStatistics& Scene::getStatistics() const {
+        return statistics;
     }
 
     void Scene::initializeScene() {
@@ -230,12 +321,27 @@ namespace Blink {
             calculateCameraProjection(&cameraComponent);
         }
 
-        // Load meshes for entities in the scene
+        // Load meshes for entities in the scene, all at once so that their files can be loaded in parallel
         // REQUIRES entities to have been created
+        std::vector<MeshInfo> meshInfos;
+        for (const entt::entity entity : entityRegistry.view<MeshComponent>()) {
+            meshInfos.push_back(entityRegistry.get<MeshComponent>(entity).meshInfo);
+        }
+        config.meshManager->loadMeshes(meshInfos);
         for (const entt::entity entity : entityRegistry.view<MeshComponent>()) {
             auto& meshComponent = entityRegistry.get<MeshComponent>(entity);
             meshComponent.mesh = config.meshManager->getMesh(meshComponent.meshInfo);
         }
+
+        // Release the textures kept alive from the previous scene that are not used by this scene
+        // REQUIRES meshes to have been loaded
+        config.meshManager->releaseUnusedTextures();
+
+        // Keep the meshes of all entities on the GPU for GPU culling
+        // REQUIRES meshes to have been loaded
+        if (config.renderer->isGpuCullingSupported()) {
+            addMeshObjects();
+        }
     }
 
     void Scene::terminateScene() {
@@ -243,7 +349,11 @@ namespace Blink {
         config.renderer->waitUntilIdle();
 
         // Unload scene
+        config.renderer->clearMeshObjects();
+        movedMeshEntities.clear();
+        hiddenMeshEntity = entt::null;
         activeCameraEntity = entt::null;
+        skyboxImagePaths.clear();
         entityRegistry.clear();
         config.luaEngine->clear();
         config.meshManager->clear();
@@ -267,6 +377,44 @@ namespace Blink {
         config.sceneCamera->worldUpDirection = WORLD_UP_DIRECTION;
     }
 
+    void Scene::addMeshObjects() {
+        for (const entt::entity entity : entityRegistry.view<TransformComponent, MeshComponent>()) {
+            auto& transformComponent = entityRegistry.get<TransformComponent>(entity);
+            auto& meshComponent = entityRegistry.get<MeshComponent>(entity);
+            meshComponent.model = transformComponent.translation * transformComponent.rotation * transformComponent.scale;
+            meshComponent.meshObjectId = config.renderer->addMeshObject(meshComponent.mesh, meshComponent.model);
+        }
+    }
+
+    //
+    // Only the mesh objects of the entities that moved since the last frame are updated, and the mesh object of the
+    // active camera entity is disabled so that it's not drawn.
+    //
+    void Scene::updateMeshObjects() {
+        for (const entt::entity entity : movedMeshEntities) {
+            const auto& meshComponent = entityRegistry.get<MeshComponent>(entity);
+            config.renderer->updateMeshObject(meshComponent.meshObjectId, meshComponent.model);
+        }
+        movedMeshEntities.clear();
+
+        if (hiddenMeshEntity == activeCameraEntity) {
+            return;
+        }
+        if (hiddenMeshEntity != entt::null) {
+            const auto* meshComponent = entityRegistry.try_get<MeshComponent>(hiddenMeshEntity);
+            if (meshComponent != nullptr && meshComponent->meshObjectId != MeshCuller::INVALID_OBJECT) {
+                config.renderer->setMeshObjectEnabled(meshComponent->meshObjectId, true);
+            }
+        }
+        if (activeCameraEntity != entt::null) {
+            const auto* meshComponent = entityRegistry.try_get<MeshComponent>(activeCameraEntity);
+            if (meshComponent != nullptr && meshComponent->meshObjectId != MeshCuller::INVALID_OBJECT) {
+                config.renderer->setMeshObjectEnabled(meshComponent->meshObjectId, false);
+            }
+        }
+        hiddenMeshEntity = activeCameraEntity;
+    }
+
     entt::entity Scene::createEntityWithDefaultComponents() {
         entt::entity entity = entityRegistry.create();
 
@@ -4,6 +4,8 @@
 #include "graphics/Renderer.h"
 #include "graphics/Skybox.h"
 #include "graphics/SkyboxManager.h"
+#include "graphics/Frustum.h"
+#include "graphics/ViewProjection.h"
 #include "lua/LuaEngine.h"
 #include "scene/SceneCamera.h"
 #include "scene/Components.h"
@@ -12,6 +14,17 @@
 #include <glm/glm.hpp>
 
 namespace Blink {
+    struct SceneStatistics {
+        uint32_t visibleMeshes = 0;
+        uint32_t culledMeshes = 0;
+    };
+
+    // Files used by a scene, which can be preloaded before switching to the scene
+    struct SceneAssets {
+        std::vector<MeshInfo> meshInfos;
+        std::vector<std::string> skyboxImagePaths;
+    };
+
     struct SceneConfig {
         std::string scene;
         Keyboard* keyboard = nullptr;
@@ -20,17 +33,25 @@ namespace Blink {
         Renderer* renderer = nullptr;
         LuaEngine* luaEngine = nullptr;
         SceneCamera* sceneCamera = nullptr;
+        float lodBias = 1.0f; // Larger values keep higher levels of detail at smaller screen sizes
     };
 
     class Scene {
         friend class LuaEngine;
         friend class EntityLuaBinding;
 
+    private:
+        static constexpr float LOD_SCREEN_SIZE = 0.5f; // Projected radius (in NDC) below which the first simplified level is used
+
     private:
         SceneConfig config;
         entt::registry entityRegistry;
         entt::entity activeCameraEntity = entt::null;
         std::shared_ptr<Skybox> skybox = nullptr;
+        std::vector<std::string> skyboxImagePaths;
+        std::vector<entt::entity> movedMeshEntities; // Whose mesh objects have to be updated
+        entt::entity hiddenMeshEntity = entt::null; // Whose mesh object is disabled since it's the active camera
+        SceneStatistics statistics{};
 
     public:
         explicit Scene(const SceneConfig& config);
@@ -47,6 +68,13 @@ namespace Blink {
 
         void setSkybox(const std::vector<std::string>& imageFilePaths);
 
+        SceneAssets getAssets() const;
+
+        // Starts loading the files in the background, used before switching to a scene that uses them
+        void preload(const SceneAssets& assets) const;
+
+        const SceneStatistics& getStatistics() const;
+
     private:
         void initializeScene();
 
@@ -54,6 +82,10 @@ namespace Blink {
 
         void configureSceneCameraWithDefaultSettings() const;
 
+        void addMeshObjects();
+
+        void updateMeshObjects();
+
         entt::entity createEntityWithDefaultComponents();
 
         void calculateTranslation(TransformComponent* transformComponent) const;
@@ -67,5 +99,11 @@ namespace Blink {
         void calculateCameraView(CameraComponent* cameraComponent, TransformComponent* transformComponent) const;
 
         void calculateCameraProjection(CameraComponent* cameraComponent) const;
+
+        static bool isVisible(const Frustum& frustum, const MeshBounds& bounds, const glm::mat4& model);
+
+        uint32_t selectLod(const Mesh& mesh, const glm::mat4& model, const ViewProjection& viewProjection) const;
+
+        static float getMaxScale(const glm::mat4& model);
     };
 }
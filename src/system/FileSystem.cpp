@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "FileSystem.h"
+#include "Ktx2File.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -31,6 +32,22 @@ namespace Blink {
         return buffer;
     }
 
+    void FileSystem::writeBytes(const std::string& path, const std::vector<char>& bytes) const {
+        std::ofstream file{path.c_str(), std::ios::binary | std::ios::trunc};
+        if (!file.is_open()) {
+            BL_THROW("Could not open file with path [" + path + "]");
+        }
+        file.write(bytes.data(), (std::streamsize) bytes.size());
+        file.close();
+    }
+
+    std::shared_ptr<MappedFile> FileSystem::mapFile(const std::string& path) const {
+        if (!exists(path)) {
+            BL_THROW("Could not find file [" + path + "]");
+        }
+        return std::make_shared<MappedFile>(path);
+    }
+
     std::shared_ptr<ImageFile> FileSystem::readImage(const std::string& path) const {
         std::string imageFilepath = path;
         cleanPath(&imageFilepath);
@@ -39,6 +56,9 @@ namespace Blink {
         if (!exists(imageFilepath)) {
             BL_THROW("Could not find image file [" + imageFilepath + "]");
         }
+        if (imageFilepath.size() > 5 && imageFilepath.substr(imageFilepath.size() - 5) == ".ktx2") {
+            return readKtx2Image(imageFilepath);
+        }
 
         int32_t width;
         int32_t height;
@@ -95,6 +115,30 @@ namespace Blink {
         return objFile;
     }
 
+    //
+    // Block-compressed images are uploaded as they are stored in the file, so the file is memory mapped and the image
+    // points into the mapping instead of decoding it into a buffer.
+    //
+    std::shared_ptr<ImageFile> FileSystem::readKtx2Image(const std::string& path) const {
+        auto imageFile = std::make_shared<ImageFile>();
+        imageFile->mappedFile = mapFile(path);
+
+        Ktx2Image ktx2Image{};
+        if (!Ktx2File::read(imageFile->mappedFile->getData(), imageFile->mappedFile->getSize(), &ktx2Image)) {
+            BL_THROW("Could not read KTX2 file [" + path + "]");
+        }
+        imageFile->width = (int32_t) ktx2Image.width;
+        imageFile->height = (int32_t) ktx2Image.height;
+        imageFile->channels = 4;
+        imageFile->format = ktx2Image.format;
+        imageFile->size = ktx2Image.levels[0].size;
+        imageFile->pixels = (unsigned char*) ktx2Image.levels[0].data;
+        for (const Ktx2Level& level : ktx2Image.levels) {
+            imageFile->levels.push_back({(const unsigned char*) level.data, level.size});
+        }
+        return imageFile;
+    }
+
     void FileSystem::cleanPath(std::string* path) const {
         std::replace(path->begin(), path->end(), '\\', '/');
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "system/ImageFile.h"
+#include "system/MappedFile.h"
 #include "system/ObjFile.h"
 
 #include <string>
@@ -12,11 +13,17 @@ namespace Blink {
 
         std::vector<char> readBytes(const std::string& path) const;
 
+        void writeBytes(const std::string& path, const std::vector<char>& bytes) const;
+
+        std::shared_ptr<MappedFile> mapFile(const std::string& path) const;
+
         std::shared_ptr<ImageFile> readImage(const std::string& path) const;
 
         std::shared_ptr<ObjFile> readObj(const std::string& path) const;
 
     private:
+        std::shared_ptr<ImageFile> readKtx2Image(const std::string& path) const;
+
         void cleanPath(std::string* path) const;
     };
 }
@@ -11,6 +11,12 @@ namespace Blink {
         if (pixels == nullptr) {
             return;
         }
+        if (mappedFile != nullptr) {
+            levels.clear();
+            mappedFile = nullptr;
+            pixels = nullptr;
+            return;
+        }
         stbi_image_free(pixels);
         pixels = nullptr;
     }
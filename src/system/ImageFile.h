@@ -1,12 +1,26 @@
 #pragma once
 
+#include "system/MappedFile.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+
 namespace Blink {
+    struct ImageLevel {
+        const unsigned char* pixels = nullptr;
+        uint64_t size = 0;
+    };
+
     struct ImageFile {
         int32_t width;
         int32_t height;
         int32_t channels;
         uint64_t size;
         unsigned char* pixels = nullptr;
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+        std::shared_ptr<MappedFile> mappedFile = nullptr; // Backs the (read-only) pixels of block-compressed images
+        std::vector<ImageLevel> levels; // Mip levels stored in the file starting with the base level, empty if the file only stores the pixels
 
         ImageFile() = default;
 
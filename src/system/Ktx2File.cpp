@@ -0,0 +1,205 @@
+#include "Ktx2File.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Blink {
+    std::string Ktx2File::getVariantPath(const std::string& imagePath, const std::string& variant) {
+        return imagePath.substr(0, imagePath.find_last_of('.')) + "." + variant + ".ktx2";
+    }
+
+    bool Ktx2File::isSupportedFormat(VkFormat format) {
+        return getBlockSize(format) > 0;
+    }
+
+    uint32_t Ktx2File::getBlockSize(VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+                return 8;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
+    std::vector<char> Ktx2File::write(VkFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<char>>& levels) {
+        const uint32_t blockSize = getBlockSize(format);
+        const std::vector<char> dataFormatDescriptor = getDataFormatDescriptor(format);
+
+        Ktx2Header header{};
+        std::memcpy(header.identifier, IDENTIFIER, sizeof(IDENTIFIER));
+        header.vkFormat = (uint32_t) format;
+        header.typeSize = 1;
+        header.pixelWidth = width;
+        header.pixelHeight = height;
+        header.faceCount = 1;
+        header.levelCount = (uint32_t) levels.size();
+        header.dfdByteOffset = (uint32_t) (sizeof(Ktx2Header) + sizeof(Ktx2LevelIndex) * levels.size());
+        header.dfdByteLength = (uint32_t) dataFormatDescriptor.size();
+
+        // Levels are stored from the smallest to the largest so that a streaming reader gets a usable image early
+        std::vector<Ktx2LevelIndex> levelIndices(levels.size());
+        uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+        for (int32_t i = (int32_t) levels.size() - 1; i >= 0; i--) {
+            offset = alignUp(offset, blockSize);
+            levelIndices[i].byteOffset = offset;
+            levelIndices[i].byteLength = levels[i].size();
+            levelIndices[i].uncompressedByteLength = levels[i].size();
+            offset += levels[i].size();
+        }
+
+        std::vector<char> bytes(offset, 0);
+        std::memcpy(bytes.data(), &header, sizeof(Ktx2Header));
+        std::memcpy(bytes.data() + sizeof(Ktx2Header), levelIndices.data(), sizeof(Ktx2LevelIndex) * levelIndices.size());
+        std::memcpy(bytes.data() + header.dfdByteOffset, dataFormatDescriptor.data(), dataFormatDescriptor.size());
+        for (uint32_t i = 0; i < levels.size(); i++) {
+            std::memcpy(bytes.data() + levelIndices[i].byteOffset, levels[i].data(), levels[i].size());
+        }
+        return bytes;
+    }
+
+    bool Ktx2File::read(const char* data, uint64_t size, Ktx2Image* image) {
+        if (size < sizeof(Ktx2Header)) {
+            return false;
+        }
+        Ktx2Header header{};
+        std::memcpy(&header, data, sizeof(Ktx2Header));
+        if (std::memcmp(header.identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0) {
+            return false;
+        }
+        auto format = (VkFormat) header.vkFormat;
+        if (!isSupportedFormat(format)) {
+            return false;
+        }
+        if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1) {
+            return false;
+        }
+        if (header.layerCount > 1 || header.faceCount != 1 || header.supercompressionScheme != 0 || header.levelCount == 0) {
+            return false;
+        }
+        if (sizeof(Ktx2Header) + sizeof(Ktx2LevelIndex) * (uint64_t) header.levelCount > size) {
+            return false;
+        }
+
+        const uint32_t blockSize = getBlockSize(format);
+        image->format = format;
+        image->width = header.pixelWidth;
+        image->height = header.pixelHeight;
+        image->levels.clear();
+        for (uint32_t i = 0; i < header.levelCount; i++) {
+            Ktx2LevelIndex levelIndex{};
+            std::memcpy(&levelIndex, data + sizeof(Ktx2Header) + sizeof(Ktx2LevelIndex) * i, sizeof(Ktx2LevelIndex));
+
+            uint32_t levelWidth = std::max(header.pixelWidth >> i, 1u);
+            uint32_t levelHeight = std::max(header.pixelHeight >> i, 1u);
+            uint64_t levelSize = (uint64_t) ((levelWidth + 3) / 4) * ((levelHeight + 3) / 4) * blockSize;
+            if (levelIndex.byteLength != levelSize || levelIndex.byteOffset > size || levelIndex.byteLength > size - levelIndex.byteOffset) {
+                return false;
+            }
+            image->levels.push_back({data + levelIndex.byteOffset, levelIndex.byteLength});
+        }
+        return true;
+    }
+
+    //
+    // Basic data format descriptor block (Khronos Data Format Specification 1.3), describing the color model, the
+    // transfer function and which bits of a texel block hold the color and alpha channels.
+    //
+    std::vector<char> Ktx2File::getDataFormatDescriptor(VkFormat format) {
+        constexpr uint32_t colorModelBc1 = 128;
+        constexpr uint32_t colorModelBc3 = 130;
+        constexpr uint32_t colorModelBc7 = 134;
+        constexpr uint32_t colorModelEtc2 = 161;
+        constexpr uint32_t colorPrimariesBt709 = 1;
+        constexpr uint32_t transferFunctionLinear = 1;
+        constexpr uint32_t transferFunctionSrgb = 2;
+        constexpr uint32_t channelColor = 0;
+        constexpr uint32_t channelEtc2Color = 2;
+        constexpr uint32_t channelAlpha = 15;
+        constexpr uint32_t channelQualifierLinear = 1 << 4; // Alpha is not sRGB encoded
+
+        uint32_t colorModel = 0;
+        uint32_t colorChannel = channelColor;
+        bool separateAlpha = false;
+        bool srgb = false;
+        switch (format) {
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                srgb = true;
+                [[fallthrough]];
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                colorModel = colorModelBc1;
+                break;
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                srgb = true;
+                [[fallthrough]];
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+                colorModel = colorModelBc3;
+                separateAlpha = true;
+                break;
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                srgb = true;
+                [[fallthrough]];
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+                colorModel = colorModelBc7;
+                break;
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+                srgb = true;
+                [[fallthrough]];
+            case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+                colorModel = colorModelEtc2;
+                colorChannel = channelEtc2Color;
+                break;
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                srgb = true;
+                [[fallthrough]];
+            case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+                colorModel = colorModelEtc2;
+                colorChannel = channelEtc2Color;
+                separateAlpha = true;
+                break;
+            default:
+                return {};
+        }
+
+        const uint32_t blockSize = getBlockSize(format);
+        const uint32_t colorBitOffset = separateAlpha ? 64 : 0;
+        const uint32_t colorBitLength = blockSize * 8 - colorBitOffset;
+
+        std::vector<uint32_t> words;
+        words.push_back(0); // Total size, set below
+        words.push_back(0); // Vendor ID and descriptor type (Khronos basic descriptor block)
+        words.push_back(2 | ((24 + 16 * (separateAlpha ? 2 : 1)) << 16)); // Version and descriptor block size
+        words.push_back(colorModel | (colorPrimariesBt709 << 8) | ((srgb ? transferFunctionSrgb : transferFunctionLinear) << 16));
+        words.push_back(3 | (3 << 8)); // Texel block dimensions minus one (4x4x1x1)
+        words.push_back(blockSize); // Bytes per plane
+        words.push_back(0);
+        if (separateAlpha) {
+            words.push_back(0 | (63 << 16) | ((channelAlpha | channelQualifierLinear) << 24));
+            words.push_back(0);
+            words.push_back(0);
+            words.push_back(UINT32_MAX);
+        }
+        words.push_back(colorBitOffset | ((colorBitLength - 1) << 16) | (colorChannel << 24));
+        words.push_back(0);
+        words.push_back(0);
+        words.push_back(UINT32_MAX);
+        words[0] = (uint32_t) (words.size() * sizeof(uint32_t));
+
+        std::vector<char> bytes(words.size() * sizeof(uint32_t));
+        std::memcpy(bytes.data(), words.data(), bytes.size());
+        return bytes;
+    }
+
+    uint64_t Ktx2File::alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
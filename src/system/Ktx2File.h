@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Blink {
+    // Fixed size header at the start of a KTX2 file (https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html)
+    struct Ktx2Header {
+        uint8_t identifier[12]{};
+        uint32_t vkFormat = 0;
+        uint32_t typeSize = 0;
+        uint32_t pixelWidth = 0;
+        uint32_t pixelHeight = 0;
+        uint32_t pixelDepth = 0;
+        uint32_t layerCount = 0;
+        uint32_t faceCount = 0;
+        uint32_t levelCount = 0;
+        uint32_t supercompressionScheme = 0;
+        uint32_t dfdByteOffset = 0;
+        uint32_t dfdByteLength = 0;
+        uint32_t kvdByteOffset = 0;
+        uint32_t kvdByteLength = 0;
+        uint64_t sgdByteOffset = 0;
+        uint64_t sgdByteLength = 0;
+    };
+
+    // Follows the header, one per mip level starting with the base level
+    struct Ktx2LevelIndex {
+        uint64_t byteOffset = 0;
+        uint64_t byteLength = 0;
+        uint64_t uncompressedByteLength = 0;
+    };
+
+    struct Ktx2Level {
+        const char* data = nullptr;
+        uint64_t size = 0;
+    };
+
+    struct Ktx2Image {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<Ktx2Level> levels; // Starting with the base level, point into the data that was read
+    };
+
+    //
+    // Reads and writes single 2D images (no array layers, cube faces or supercompression) in the KTX2 container.
+    //
+    // Only the block-compressed formats written by the texture converter are supported, their data descriptor is
+    // written so that other KTX2 tools can read the files but is ignored when reading.
+    //
+    class Ktx2File {
+    public:
+        // Variants written by the texture converter next to a source image, e.g. "diffuse.bc.ktx2" for "diffuse.png"
+        static constexpr const char* BC_VARIANT = "bc";
+        static constexpr const char* ETC2_VARIANT = "etc2";
+
+    private:
+        static constexpr uint8_t IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    public:
+        static std::string getVariantPath(const std::string& imagePath, const std::string& variant);
+
+        static bool isSupportedFormat(VkFormat format);
+
+        // Size in bytes of a 4x4 texel block of a supported format
+        static uint32_t getBlockSize(VkFormat format);
+
+        // Expects the levels to start with the base level, each halving the size of the previous one
+        static std::vector<char> write(VkFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<char>>& levels);
+
+        // Returns false if the data is not a KTX2 file this class can read
+        static bool read(const char* data, uint64_t size, Ktx2Image* image);
+
+    private:
+        static std::vector<char> getDataFormatDescriptor(VkFormat format);
+
+        static uint64_t alignUp(uint64_t value, uint64_t alignment);
+    };
+}
@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#if defined(BL_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Blink {
+#if defined(BL_PLATFORM_WINDOWS)
+    MappedFile::MappedFile(const std::string& path) {
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            fileHandle = nullptr;
+            BL_THROW("Could not open file with path [" + path + "]");
+        }
+        LARGE_INTEGER fileSize{};
+        GetFileSizeEx(fileHandle, &fileSize);
+        size = (uint64_t) fileSize.QuadPart;
+        if (size == 0) {
+            return;
+        }
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) {
+            CloseHandle(fileHandle);
+            fileHandle = nullptr;
+            BL_THROW("Could not map file with path [" + path + "]");
+        }
+        data = (const char*) MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            CloseHandle(mappingHandle);
+            CloseHandle(fileHandle);
+            mappingHandle = nullptr;
+            fileHandle = nullptr;
+            BL_THROW("Could not map file with path [" + path + "]");
+        }
+    }
+
+    MappedFile::~MappedFile() {
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mappingHandle != nullptr) {
+            CloseHandle(mappingHandle);
+        }
+        if (fileHandle != nullptr) {
+            CloseHandle(fileHandle);
+        }
+    }
+#else
+    MappedFile::MappedFile(const std::string& path) {
+        int fileDescriptor = open(path.c_str(), O_RDONLY);
+        if (fileDescriptor == -1) {
+            BL_THROW("Could not open file with path [" + path + "]");
+        }
+        struct stat fileStatus{};
+        if (fstat(fileDescriptor, &fileStatus) == -1) {
+            close(fileDescriptor);
+            BL_THROW("Could not read size of file with path [" + path + "]");
+        }
+        size = (uint64_t) fileStatus.st_size;
+        if (size == 0) {
+            close(fileDescriptor);
+            return;
+        }
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        // The mapping keeps its own reference to the file
+        close(fileDescriptor);
+        if (mapping == MAP_FAILED) {
+            BL_THROW("Could not map file with path [" + path + "]");
+        }
+        data = (const char*) mapping;
+    }
+
+    MappedFile::~MappedFile() {
+        if (data != nullptr) {
+            munmap((void*) data, size);
+        }
+    }
+#endif
+
+    const char* MappedFile::getData() const {
+        return data;
+    }
+
+    uint64_t MappedFile::getSize() const {
+        return size;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+
+namespace Blink {
+    //
+    // Read-only memory mapping of a whole file.
+    //
+    // The pages are only read from disk when they are first accessed, and are shared with the OS file cache instead
+    // of being copied into a buffer owned by the process.
+    //
+    class MappedFile {
+    private:
+        const char* data = nullptr;
+        uint64_t size = 0;
+#if defined(BL_PLATFORM_WINDOWS)
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+
+    public:
+        explicit MappedFile(const std::string& path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* getData() const;
+
+        uint64_t getSize() const;
+    };
+}
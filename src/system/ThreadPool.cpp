@@ -0,0 +1,62 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+namespace Blink {
+    ThreadPool::ThreadPool(const ThreadPoolConfig& config) : config(config) {
+        uint32_t threadCount = config.threadCount;
+        if (threadCount == 0) {
+            uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+            threadCount = hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 1;
+        }
+        for (uint32_t i = 0; i < threadCount; i++) {
+            threads.emplace_back(&ThreadPool::run, this);
+        }
+        BL_LOG_INFO("Created thread pool [threads: {}]", threadCount);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    uint32_t ThreadPool::getThreadCount() const {
+        return (uint32_t) threads.size();
+    }
+
+    std::future<void> ThreadPool::submit(const std::function<void()>& task) {
+        std::packaged_task<void()> packagedTask(task);
+        std::future<void> future = packagedTask.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push(std::move(packagedTask));
+        }
+        condition.notify_one();
+        return future;
+    }
+
+    void ThreadPool::run() {
+        while (true) {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] {
+                    return stopping || !tasks.empty();
+                });
+                // Finish the remaining tasks before stopping so that no future is left without a result
+                if (stopping && tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            // Exceptions thrown by the task are stored in its future
+            task();
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+namespace Blink {
+    struct ThreadPoolConfig {
+        uint32_t threadCount = 0; // Defaults to the number of hardware threads minus the main thread
+    };
+
+    //
+    // Fixed set of worker threads executing tasks in the order they were submitted.
+    //
+    class ThreadPool {
+    private:
+        ThreadPoolConfig config;
+        std::vector<std::thread> threads;
+        std::queue<std::packaged_task<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+
+    public:
+        explicit ThreadPool(const ThreadPoolConfig& config);
+
+        ~ThreadPool();
+
+        uint32_t getThreadCount() const;
+
+        std::future<void> submit(const std::function<void()>& task);
+
+    private:
+        void run();
+    };
+}
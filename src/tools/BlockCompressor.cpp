@@ -0,0 +1,596 @@
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Blink {
+    namespace {
+        // ETC1 modifier tables, the pixel index selects +a, +b, -a or -b
+        constexpr int32_t ETC_MODIFIERS[8][4] = {
+            {2, 8, -2, -8},
+            {5, 17, -5, -17},
+            {9, 29, -9, -29},
+            {13, 42, -13, -42},
+            {18, 60, -18, -60},
+            {24, 80, -24, -80},
+            {33, 106, -33, -106},
+            {47, 183, -47, -183},
+        };
+
+        constexpr int32_t EAC_MODIFIERS[16][8] = {
+            {-3, -6, -9, -15, 2, 5, 8, 14},
+            {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5, -8, -13, 1, 4, 7, 12},
+            {-2, -4, -6, -13, 1, 3, 5, 12},
+            {-3, -6, -8, -12, 2, 5, 7, 11},
+            {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10},
+            {-3, -5, -8, -11, 2, 4, 7, 10},
+            {-2, -6, -8, -10, 1, 5, 7, 9},
+            {-2, -5, -8, -10, 1, 4, 7, 9},
+            {-2, -4, -8, -10, 1, 3, 7, 9},
+            {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},
+            {-1, -2, -3, -10, 0, 1, 2, 9},
+            {-4, -6, -8, -9, 3, 5, 7, 8},
+            {-3, -5, -7, -9, 2, 4, 6, 8},
+        };
+
+        constexpr int32_t BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        int32_t clampByte(int32_t value) {
+            return std::clamp(value, 0, 255);
+        }
+
+        int32_t square(int32_t value) {
+            return value * value;
+        }
+
+        // Writes bits into a block from the least significant bit of the first byte (BC7)
+        void writeBits(uint8_t* block, uint32_t* bitOffset, uint32_t value, uint32_t bitCount) {
+            for (uint32_t i = 0; i < bitCount; i++) {
+                uint32_t bit = *bitOffset + i;
+                if ((value >> i) & 1) {
+                    block[bit / 8] |= (uint8_t) (1 << (bit % 8));
+                }
+            }
+            *bitOffset += bitCount;
+        }
+
+        // ETC2 and EAC blocks are stored as big endian 64-bit words
+        void writeBigEndian(uint64_t value, uint8_t* block) {
+            for (uint32_t i = 0; i < 8; i++) {
+                block[i] = (uint8_t) (value >> (56 - i * 8));
+            }
+        }
+    }
+
+    bool BlockCompressor::isSupportedFormat(VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    std::vector<char> BlockCompressor::compress(const uint8_t* pixels, uint32_t width, uint32_t height, VkFormat format) {
+        const bool eightByteBlocks = format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || format == VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+        const uint32_t blockSize = eightByteBlocks ? 8 : 16;
+        const uint32_t blockCountX = (width + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+        const uint32_t blockCountY = (height + BLOCK_HEIGHT - 1) / BLOCK_HEIGHT;
+
+        std::vector<char> blocks((size_t) blockCountX * blockCountY * blockSize, 0);
+        uint8_t texels[BLOCK_TEXELS * 4];
+        for (uint32_t blockY = 0; blockY < blockCountY; blockY++) {
+            for (uint32_t blockX = 0; blockX < blockCountX; blockX++) {
+                for (uint32_t y = 0; y < BLOCK_HEIGHT; y++) {
+                    for (uint32_t x = 0; x < BLOCK_WIDTH; x++) {
+                        uint32_t pixelX = std::min(blockX * BLOCK_WIDTH + x, width - 1);
+                        uint32_t pixelY = std::min(blockY * BLOCK_HEIGHT + y, height - 1);
+                        std::memcpy(&texels[(y * BLOCK_WIDTH + x) * 4], &pixels[((size_t) pixelY * width + pixelX) * 4], 4);
+                    }
+                }
+                auto* block = (uint8_t*) &blocks[((size_t) blockY * blockCountX + blockX) * blockSize];
+                compressBlock(texels, format, block);
+            }
+        }
+        return blocks;
+    }
+
+    void BlockCompressor::compressBlock(const uint8_t* texels, VkFormat format, uint8_t* block) {
+        switch (format) {
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                compressBc1(texels, block);
+                break;
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                compressBc4(texels, 3, block);
+                compressBc1(texels, block + 8);
+                break;
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                compressBc7(texels, block);
+                break;
+            case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+                compressEtc2Rgb(texels, block);
+                break;
+            case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+                compressEacAlpha(texels, block);
+                compressEtc2Rgb(texels, block + 8);
+                break;
+            default:
+                break;
+        }
+    }
+
+    //
+    // BC1 stores two RGB565 endpoints and a 2-bit index per texel, selecting an endpoint or one of the two colors
+    // interpolated at 1/3 and 2/3 between them. The first endpoint is kept larger than the second, which selects the
+    // four color mode instead of the three color mode with transparency.
+    //
+    void BlockCompressor::compressBc1(const uint8_t* texels, uint8_t* block) {
+        float endpoint0[4];
+        float endpoint1[4];
+        fitEndpoints(texels, 3, endpoint0, endpoint1);
+
+        int32_t bestError = INT32_MAX;
+        for (uint32_t iteration = 0; iteration < 2; iteration++) {
+            uint16_t color0 = packRgb565(endpoint0);
+            uint16_t color1 = packRgb565(endpoint1);
+            if (color0 < color1) {
+                std::swap(color0, color1);
+                std::swap(endpoint0, endpoint1);
+            }
+
+            int32_t palette[4][3];
+            unpackRgb565(color0, palette[0]);
+            unpackRgb565(color1, palette[1]);
+            for (uint32_t c = 0; c < 3; c++) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            const uint32_t paletteSize = color0 == color1 ? 1 : 4;
+            constexpr float paletteWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+            uint32_t indices = 0;
+            int32_t error = 0;
+            float weights[BLOCK_TEXELS];
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                const uint8_t* texel = &texels[i * 4];
+                uint32_t bestIndex = 0;
+                int32_t bestTexelError = INT32_MAX;
+                for (uint32_t p = 0; p < paletteSize; p++) {
+                    int32_t texelError = square(palette[p][0] - texel[0]) + square(palette[p][1] - texel[1]) + square(palette[p][2] - texel[2]);
+                    if (texelError < bestTexelError) {
+                        bestTexelError = texelError;
+                        bestIndex = p;
+                    }
+                }
+                indices |= bestIndex << (i * 2);
+                weights[i] = paletteWeights[bestIndex];
+                error += bestTexelError;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                block[0] = (uint8_t) color0;
+                block[1] = (uint8_t) (color0 >> 8);
+                block[2] = (uint8_t) color1;
+                block[3] = (uint8_t) (color1 >> 8);
+                std::memcpy(&block[4], &indices, sizeof(indices));
+            }
+            refineEndpoints(texels, 3, weights, endpoint0, endpoint1);
+        }
+    }
+
+    //
+    // BC4 (the alpha block of BC3) stores two 8-bit endpoints and a 3-bit index per texel, selecting an endpoint or
+    // one of the six values interpolated between them.
+    //
+    void BlockCompressor::compressBc4(const uint8_t* texels, uint32_t channel, uint8_t* block) {
+        int32_t minValue = 255;
+        int32_t maxValue = 0;
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            minValue = std::min(minValue, (int32_t) texels[i * 4 + channel]);
+            maxValue = std::max(maxValue, (int32_t) texels[i * 4 + channel]);
+        }
+
+        int32_t palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for (int32_t i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * maxValue + (i - 1) * minValue) / 7;
+        }
+
+        uint64_t indices = 0;
+        for (uint32_t i = 0; i < BLOCK_TEXELS && maxValue > minValue; i++) {
+            int32_t value = texels[i * 4 + channel];
+            uint64_t bestIndex = 0;
+            for (uint32_t p = 1; p < 8; p++) {
+                if (std::abs(palette[p] - value) < std::abs(palette[bestIndex] - value)) {
+                    bestIndex = p;
+                }
+            }
+            indices |= bestIndex << (i * 3);
+        }
+
+        block[0] = (uint8_t) maxValue;
+        block[1] = (uint8_t) minValue;
+        for (uint32_t i = 0; i < 6; i++) {
+            block[2 + i] = (uint8_t) (indices >> (i * 8));
+        }
+    }
+
+    //
+    // BC7 mode 6 stores two RGBA endpoints with 7 bits per channel and a shared least significant bit per endpoint,
+    // and a 4-bit index per texel selecting one of the 16 colors interpolated between them.
+    //
+    void BlockCompressor::compressBc7(const uint8_t* texels, uint8_t* block) {
+        float endpoint0[4];
+        float endpoint1[4];
+        fitEndpoints(texels, 4, endpoint0, endpoint1);
+
+        int32_t bestError = INT32_MAX;
+        for (uint32_t iteration = 0; iteration < 2; iteration++) {
+            // Quantize each endpoint with the shared bit that reconstructs it best, preferring exact alpha so that
+            // opaque blocks stay opaque
+            uint32_t quantized[2][4];
+            uint32_t sharedBits[2];
+            int32_t endpoints[2][4];
+            const float* endpointColors[2] = {endpoint0, endpoint1};
+            for (uint32_t e = 0; e < 2; e++) {
+                float bestEndpointError = INFINITY;
+                for (uint32_t sharedBit = 0; sharedBit < 2; sharedBit++) {
+                    float endpointError = 0.0f;
+                    uint32_t candidate[4];
+                    for (uint32_t c = 0; c < 4; c++) {
+                        candidate[c] = (uint32_t) std::clamp((int32_t) std::lround((endpointColors[e][c] - (float) sharedBit) / 2.0f), 0, 127);
+                        float reconstructed = (float) ((candidate[c] << 1) | sharedBit);
+                        float channelWeight = c == 3 ? ALPHA_WEIGHT : 1.0f;
+                        endpointError += channelWeight * (reconstructed - endpointColors[e][c]) * (reconstructed - endpointColors[e][c]);
+                    }
+                    if (endpointError < bestEndpointError) {
+                        bestEndpointError = endpointError;
+                        sharedBits[e] = sharedBit;
+                        std::memcpy(quantized[e], candidate, sizeof(candidate));
+                    }
+                }
+                for (uint32_t c = 0; c < 4; c++) {
+                    endpoints[e][c] = (int32_t) ((quantized[e][c] << 1) | sharedBits[e]);
+                }
+            }
+
+            int32_t palette[16][4];
+            for (uint32_t p = 0; p < 16; p++) {
+                for (uint32_t c = 0; c < 4; c++) {
+                    palette[p][c] = ((64 - BC7_WEIGHTS[p]) * endpoints[0][c] + BC7_WEIGHTS[p] * endpoints[1][c] + 32) >> 6;
+                }
+            }
+
+            uint32_t indices[BLOCK_TEXELS];
+            float weights[BLOCK_TEXELS];
+            int32_t error = 0;
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                const uint8_t* texel = &texels[i * 4];
+                uint32_t bestIndex = 0;
+                int32_t bestTexelError = INT32_MAX;
+                for (uint32_t p = 0; p < 16; p++) {
+                    int32_t texelError = 0;
+                    for (uint32_t c = 0; c < 4; c++) {
+                        texelError += square(palette[p][c] - texel[c]);
+                    }
+                    if (texelError < bestTexelError) {
+                        bestTexelError = texelError;
+                        bestIndex = p;
+                    }
+                }
+                indices[i] = bestIndex;
+                weights[i] = (float) BC7_WEIGHTS[bestIndex] / 64.0f;
+                error += bestTexelError;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+
+                // The most significant bit of the first index is implicitly zero, swap the endpoints if it is set
+                uint32_t first = 0;
+                uint32_t second = 1;
+                bool swapped = indices[0] >= 8;
+                if (swapped) {
+                    std::swap(first, second);
+                }
+
+                std::memset(block, 0, 16);
+                uint32_t bitOffset = 0;
+                writeBits(block, &bitOffset, 1 << 6, 7);
+                for (uint32_t c = 0; c < 4; c++) {
+                    writeBits(block, &bitOffset, quantized[first][c], 7);
+                    writeBits(block, &bitOffset, quantized[second][c], 7);
+                }
+                writeBits(block, &bitOffset, sharedBits[first], 1);
+                writeBits(block, &bitOffset, sharedBits[second], 1);
+                for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                    uint32_t index = swapped ? 15 - indices[i] : indices[i];
+                    writeBits(block, &bitOffset, index, i == 0 ? 3 : 4);
+                }
+            }
+            refineEndpoints(texels, 4, weights, endpoint0, endpoint1);
+        }
+    }
+
+    //
+    // ETC1 splits the block into two 2x4 or 4x2 subblocks (the flip bit), each with a base color and a table of
+    // modifiers added to all its channels. The base colors are either stored individually with 4 bits per channel,
+    // or as 5 bits per channel with the second color as a 3-bit difference from the first.
+    //
+    // The differences are kept within the 5-bit range, since ETC2 decoders use overflowing differences to select
+    // its additional modes.
+    //
+    void BlockCompressor::compressEtc2Rgb(const uint8_t* texels, uint8_t* block) {
+        uint64_t bestWord = 0;
+        int64_t bestError = INT64_MAX;
+        for (uint32_t flip = 0; flip < 2; flip++) {
+            // Texel indices of the two subblocks
+            uint32_t subblocks[2][8];
+            uint32_t counts[2] = {0, 0};
+            for (uint32_t y = 0; y < BLOCK_HEIGHT; y++) {
+                for (uint32_t x = 0; x < BLOCK_WIDTH; x++) {
+                    uint32_t subblock = flip ? (y >= 2 ? 1 : 0) : (x >= 2 ? 1 : 0);
+                    subblocks[subblock][counts[subblock]++] = y * BLOCK_WIDTH + x;
+                }
+            }
+
+            float averages[2][3] = {};
+            for (uint32_t s = 0; s < 2; s++) {
+                for (uint32_t i = 0; i < 8; i++) {
+                    for (uint32_t c = 0; c < 3; c++) {
+                        averages[s][c] += (float) texels[subblocks[s][i] * 4 + c] / 8.0f;
+                    }
+                }
+            }
+
+            for (uint32_t differential = 0; differential < 2; differential++) {
+                uint32_t quantized[2][3];
+                int32_t baseColors[2][3];
+                bool valid = true;
+                for (uint32_t s = 0; s < 2; s++) {
+                    for (uint32_t c = 0; c < 3; c++) {
+                        if (differential) {
+                            quantized[s][c] = (uint32_t) std::lround(averages[s][c] * 31.0f / 255.0f);
+                            baseColors[s][c] = (int32_t) ((quantized[s][c] << 3) | (quantized[s][c] >> 2));
+                        } else {
+                            quantized[s][c] = (uint32_t) std::lround(averages[s][c] * 15.0f / 255.0f);
+                            baseColors[s][c] = (int32_t) ((quantized[s][c] << 4) | quantized[s][c]);
+                        }
+                    }
+                }
+                int32_t differences[3] = {};
+                for (uint32_t c = 0; c < 3 && differential; c++) {
+                    differences[c] = (int32_t) quantized[1][c] - (int32_t) quantized[0][c];
+                    valid = valid && differences[c] >= -4 && differences[c] <= 3;
+                }
+                if (!valid) {
+                    continue;
+                }
+
+                uint32_t tables[2] = {0, 0};
+                uint32_t pixelIndices = 0;
+                int64_t error = 0;
+                for (uint32_t s = 0; s < 2; s++) {
+                    int64_t bestSubblockError = INT64_MAX;
+                    uint32_t bestSubblockIndices = 0;
+                    for (uint32_t table = 0; table < 8; table++) {
+                        int64_t subblockError = 0;
+                        uint32_t subblockIndices = 0;
+                        for (uint32_t i = 0; i < 8; i++) {
+                            uint32_t texelIndex = subblocks[s][i];
+                            const uint8_t* texel = &texels[texelIndex * 4];
+                            uint32_t bestModifier = 0;
+                            int32_t bestTexelError = INT32_MAX;
+                            for (uint32_t m = 0; m < 4; m++) {
+                                int32_t texelError = 0;
+                                for (uint32_t c = 0; c < 3; c++) {
+                                    texelError += square(clampByte(baseColors[s][c] + ETC_MODIFIERS[table][m]) - texel[c]);
+                                }
+                                if (texelError < bestTexelError) {
+                                    bestTexelError = texelError;
+                                    bestModifier = m;
+                                }
+                            }
+                            subblockError += bestTexelError;
+
+                            // Pixels are numbered column by column, with the index split into a high and a low bit
+                            uint32_t x = texelIndex % BLOCK_WIDTH;
+                            uint32_t y = texelIndex / BLOCK_WIDTH;
+                            uint32_t pixel = x * BLOCK_HEIGHT + y;
+                            subblockIndices |= ((bestModifier >> 1) << (16 + pixel)) | ((bestModifier & 1) << pixel);
+                        }
+                        if (subblockError < bestSubblockError) {
+                            bestSubblockError = subblockError;
+                            bestSubblockIndices = subblockIndices;
+                            tables[s] = table;
+                        }
+                    }
+                    error += bestSubblockError;
+                    pixelIndices |= bestSubblockIndices;
+                }
+                if (error >= bestError) {
+                    continue;
+                }
+
+                uint64_t word = 0;
+                for (uint32_t c = 0; c < 3; c++) {
+                    uint32_t shift = 56 - c * 8;
+                    if (differential) {
+                        word |= (uint64_t) quantized[0][c] << (shift + 3);
+                        word |= (uint64_t) (differences[c] & 0x7) << shift;
+                    } else {
+                        word |= (uint64_t) quantized[0][c] << (shift + 4);
+                        word |= (uint64_t) quantized[1][c] << shift;
+                    }
+                }
+                word |= (uint64_t) tables[0] << 37;
+                word |= (uint64_t) tables[1] << 34;
+                word |= (uint64_t) differential << 33;
+                word |= (uint64_t) flip << 32;
+                word |= pixelIndices;
+                bestWord = word;
+                bestError = error;
+            }
+        }
+        writeBigEndian(bestWord, block);
+    }
+
+    //
+    // EAC stores a base value, a multiplier and a table of eight modifiers, with a 3-bit index per texel selecting
+    // the modifier to multiply and add to the base value. Only the tables and multipliers that can span the range of
+    // the block's values are searched.
+    //
+    void BlockCompressor::compressEacAlpha(const uint8_t* texels, uint8_t* block) {
+        int32_t minValue = 255;
+        int32_t maxValue = 0;
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            minValue = std::min(minValue, (int32_t) texels[i * 4 + 3]);
+            maxValue = std::max(maxValue, (int32_t) texels[i * 4 + 3]);
+        }
+
+        uint64_t bestWord = 0;
+        int32_t bestError = INT32_MAX;
+        for (uint32_t table = 0; table < 16 && bestError > 0; table++) {
+            const int32_t* modifiers = EAC_MODIFIERS[table];
+            int32_t span = modifiers[7] - modifiers[3];
+            int32_t estimatedMultiplier = std::clamp((maxValue - minValue + span / 2) / span, 1, 15);
+            for (int32_t multiplier = std::max(estimatedMultiplier - 1, 1); multiplier <= std::min(estimatedMultiplier + 1, 15); multiplier++) {
+                int32_t estimatedBase = clampByte(minValue - modifiers[3] * multiplier);
+                for (int32_t base = clampByte(estimatedBase - 2); base <= clampByte(estimatedBase + 2); base++) {
+                    uint64_t indices = 0;
+                    int32_t error = 0;
+                    for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                        int32_t value = texels[i * 4 + 3];
+                        uint32_t bestModifier = 0;
+                        int32_t bestTexelError = INT32_MAX;
+                        for (uint32_t m = 0; m < 8; m++) {
+                            int32_t texelError = std::abs(clampByte(base + modifiers[m] * multiplier) - value);
+                            if (texelError < bestTexelError) {
+                                bestTexelError = texelError;
+                                bestModifier = m;
+                            }
+                        }
+                        error += bestTexelError * bestTexelError;
+
+                        // Pixels are numbered column by column, starting at the most significant bits
+                        uint32_t pixel = (i % BLOCK_WIDTH) * BLOCK_HEIGHT + i / BLOCK_WIDTH;
+                        indices |= (uint64_t) bestModifier << (45 - pixel * 3);
+                    }
+                    if (error < bestError) {
+                        bestError = error;
+                        bestWord = ((uint64_t) base << 56) | ((uint64_t) multiplier << 52) | ((uint64_t) table << 48) | indices;
+                    }
+                }
+            }
+        }
+        writeBigEndian(bestWord, block);
+    }
+
+    // Fits a line through the texels along their principal axis, the endpoints are the extremes of their projections
+    void BlockCompressor::fitEndpoints(const uint8_t* texels, uint32_t channelCount, float* endpoint0, float* endpoint1) {
+        float mean[4] = {};
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            for (uint32_t c = 0; c < channelCount; c++) {
+                mean[c] += (float) texels[i * 4 + c] / (float) BLOCK_TEXELS;
+            }
+        }
+
+        float covariance[4][4] = {};
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            for (uint32_t a = 0; a < channelCount; a++) {
+                for (uint32_t b = 0; b < channelCount; b++) {
+                    covariance[a][b] += ((float) texels[i * 4 + a] - mean[a]) * ((float) texels[i * 4 + b] - mean[b]);
+                }
+            }
+        }
+
+        // Power iteration converges to the eigenvector with the largest eigenvalue
+        float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        for (uint32_t iteration = 0; iteration < 8; iteration++) {
+            float next[4] = {};
+            float length = 0.0f;
+            for (uint32_t a = 0; a < channelCount; a++) {
+                for (uint32_t b = 0; b < channelCount; b++) {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+                length += next[a] * next[a];
+            }
+            length = std::sqrt(length);
+            if (length < 1e-6f) {
+                break;
+            }
+            for (uint32_t c = 0; c < channelCount; c++) {
+                axis[c] = next[c] / length;
+            }
+        }
+
+        float minProjection = INFINITY;
+        float maxProjection = -INFINITY;
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            float projection = 0.0f;
+            for (uint32_t c = 0; c < channelCount; c++) {
+                projection += ((float) texels[i * 4 + c] - mean[c]) * axis[c];
+            }
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+        for (uint32_t c = 0; c < channelCount; c++) {
+            endpoint0[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+            endpoint1[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+        }
+    }
+
+    // Least squares fit of the endpoints given where each texel lies between them (0 at the first, 1 at the second)
+    void BlockCompressor::refineEndpoints(const uint8_t* texels, uint32_t channelCount, const float* weights, float* endpoint0, float* endpoint1) {
+        float a = 0.0f;
+        float b = 0.0f;
+        float c = 0.0f;
+        float x0[4] = {};
+        float x1[4] = {};
+        for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+            float w1 = weights[i];
+            float w0 = 1.0f - w1;
+            a += w0 * w0;
+            b += w0 * w1;
+            c += w1 * w1;
+            for (uint32_t channel = 0; channel < channelCount; channel++) {
+                x0[channel] += w0 * (float) texels[i * 4 + channel];
+                x1[channel] += w1 * (float) texels[i * 4 + channel];
+            }
+        }
+        float determinant = a * c - b * b;
+        if (std::abs(determinant) < 1e-6f) {
+            return;
+        }
+        for (uint32_t channel = 0; channel < channelCount; channel++) {
+            endpoint0[channel] = std::clamp((c * x0[channel] - b * x1[channel]) / determinant, 0.0f, 255.0f);
+            endpoint1[channel] = std::clamp((a * x1[channel] - b * x0[channel]) / determinant, 0.0f, 255.0f);
+        }
+    }
+
+    uint16_t BlockCompressor::packRgb565(const float* color) {
+        auto r = (uint16_t) std::lround(color[0] * 31.0f / 255.0f);
+        auto g = (uint16_t) std::lround(color[1] * 63.0f / 255.0f);
+        auto b = (uint16_t) std::lround(color[2] * 31.0f / 255.0f);
+        return (uint16_t) ((r << 11) | (g << 5) | b);
+    }
+
+    void BlockCompressor::unpackRgb565(uint16_t color, int32_t* rgb) {
+        int32_t r = (color >> 11) & 0x1F;
+        int32_t g = (color >> 5) & 0x3F;
+        int32_t b = color & 0x1F;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace Blink {
+    //
+    // Encodes RGBA8 images into GPU block-compressed formats, 4x4 texels at a time.
+    //
+    // The encoders aim for reasonable quality at offline speeds rather than for the best possible quality:
+    //
+    // - BC1 and BC7 fit the endpoints along the principal axis of the block's colors, refined once with least squares.
+    //   BC7 only uses mode 6 (one subset, RGBA endpoints with 16 interpolated colors).
+    // - BC3 and ETC2 RGBA8 (EAC) encode the alpha channel separately from the color channels.
+    // - ETC2 RGB8 only uses the ETC1 compatible individual and differential modes, searching every table and flip.
+    //
+    // Images with a size that is not a multiple of 4 repeat their edge texels into the partial blocks.
+    //
+    class BlockCompressor {
+    private:
+        static constexpr uint32_t BLOCK_WIDTH = 4;
+        static constexpr uint32_t BLOCK_HEIGHT = 4;
+        static constexpr uint32_t BLOCK_TEXELS = BLOCK_WIDTH * BLOCK_HEIGHT;
+        static constexpr float ALPHA_WEIGHT = 8.0f; // Weight of alpha errors when quantizing BC7 endpoints
+
+    public:
+        static bool isSupportedFormat(VkFormat format);
+
+        static std::vector<char> compress(const uint8_t* pixels, uint32_t width, uint32_t height, VkFormat format);
+
+    private:
+        // Texels are RGBA8, row by row
+        static void compressBlock(const uint8_t* texels, VkFormat format, uint8_t* block);
+
+        static void compressBc1(const uint8_t* texels, uint8_t* block);
+
+        static void compressBc4(const uint8_t* texels, uint32_t channel, uint8_t* block);
+
+        static void compressBc7(const uint8_t* texels, uint8_t* block);
+
+        static void compressEtc2Rgb(const uint8_t* texels, uint8_t* block);
+
+        static void compressEacAlpha(const uint8_t* texels, uint8_t* block);
+
+        static void fitEndpoints(const uint8_t* texels, uint32_t channelCount, float* endpoint0, float* endpoint1);
+
+        static void refineEndpoints(const uint8_t* texels, uint32_t channelCount, const float* weights, float* endpoint0, float* endpoint1);
+
+        static uint16_t packRgb565(const float* color);
+
+        static void unpackRgb565(uint16_t color, int32_t* rgb);
+    };
+}
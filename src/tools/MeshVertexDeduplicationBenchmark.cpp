@@ -0,0 +1,201 @@
+#include "graphics/Mesh.h"
+#include "graphics/MeshVertexDeduplicator.h"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//
+// Benchmark of the vertex deduplication done when importing OBJ models, which compares the hash map that was used
+// before (std::unordered_map with std::hash<MeshVertex>) to the presized open addressing table of MeshVertexDeduplicator.
+//
+// Every OBJ file in the given directories (recursively) is loaded once, after which its face corners are turned into
+// vertices the same way as MeshManager::processVerticesAndIndices does. Both implementations then deduplicate the
+// same vertices a number of times and the fastest run of each is reported, together with whether both produced the
+// same vertices and indices.
+//
+// Usage: MeshVertexDeduplicationBenchmark [--runs <count>] <directory>...
+//
+
+using namespace Blink;
+
+namespace {
+    struct BenchmarkOptions {
+        uint32_t runs = 10;
+        std::vector<std::filesystem::path> directories;
+    };
+
+    struct DeduplicationResult {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    bool parseOptions(int argc, char** argv, BenchmarkOptions* options) {
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+            if (argument == "--runs" && i + 1 < argc) {
+                options->runs = (uint32_t) std::max(std::atoi(argv[++i]), 1);
+            } else if (argument.rfind("--", 0) == 0) {
+                return false;
+            } else {
+                options->directories.emplace_back(argument);
+            }
+        }
+        return !options->directories.empty();
+    }
+
+    bool loadCorners(const std::filesystem::path& path, std::vector<MeshVertex>* corners) {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string err;
+        std::string mtlDirectoryPath = path.parent_path().string() + "/";
+        constexpr bool triangulate = true;
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &err, path.string().c_str(), mtlDirectoryPath.c_str(), triangulate)) {
+            std::cerr << "Could not load OBJ file [" << path.string() << "]: " << err << std::endl;
+            return false;
+        }
+
+        for (const tinyobj::shape_t& shape : shapes) {
+            uint32_t indexOffset = 0;
+            for (uint32_t f = 0; f < shape.mesh.num_face_vertices.size(); f++) {
+                uint32_t vertexCountPerFace = shape.mesh.num_face_vertices[f];
+                int32_t materialId = shape.mesh.material_ids[f];
+                for (uint32_t v = 0; v < vertexCountPerFace; v++) {
+                    tinyobj::index_t index = shape.mesh.indices[indexOffset + v];
+
+                    MeshVertex vertex{};
+                    vertex.color = {1.0f, 1.0f, 1.0f};
+                    if (materialId != -1) {
+                        vertex.textureIndex = materialId;
+                    }
+                    vertex.position = {
+                        attrib.vertices[3 * index.vertex_index + 0],
+                        attrib.vertices[3 * index.vertex_index + 1],
+                        attrib.vertices[3 * index.vertex_index + 2]
+                    };
+                    if (index.texcoord_index >= 0) {
+                        vertex.textureCoordinate = {
+                            attrib.texcoords[2 * index.texcoord_index + 0],
+                            1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+                        };
+                    }
+                    if (3 * index.vertex_index + 2 < attrib.colors.size()) {
+                        vertex.color = {
+                            attrib.colors[3 * index.vertex_index + 0],
+                            attrib.colors[3 * index.vertex_index + 1],
+                            attrib.colors[3 * index.vertex_index + 2]
+                        };
+                    }
+                    corners->push_back(vertex);
+                }
+                indexOffset += vertexCountPerFace;
+            }
+        }
+        return true;
+    }
+
+    void deduplicateWithUnorderedMap(const std::vector<MeshVertex>& corners, DeduplicationResult* result) {
+        std::unordered_map<MeshVertex, uint32_t> indicesByUniqueVertices{};
+        result->indices.reserve(corners.size());
+        for (const MeshVertex& vertex : corners) {
+            if (indicesByUniqueVertices.count(vertex) == 0) {
+                indicesByUniqueVertices[vertex] = (uint32_t) result->vertices.size();
+                result->vertices.push_back(vertex);
+            }
+            result->indices.push_back(indicesByUniqueVertices[vertex]);
+        }
+    }
+
+    void deduplicateWithDeduplicator(const std::vector<MeshVertex>& corners, DeduplicationResult* result) {
+        result->indices.reserve(corners.size());
+        MeshVertexDeduplicator vertexDeduplicator(&result->vertices, (uint32_t) corners.size());
+        for (const MeshVertex& vertex : corners) {
+            result->indices.push_back(vertexDeduplicator.getIndex(vertex));
+        }
+    }
+
+    // Fastest of the given number of runs in milliseconds, the result is that of the last run
+    template<typename Deduplicate>
+    double measure(uint32_t runs, const std::vector<MeshVertex>& corners, DeduplicationResult* result, Deduplicate deduplicate) {
+        double fastestMilliseconds = std::numeric_limits<double>::max();
+        for (uint32_t run = 0; run < runs; run++) {
+            *result = {};
+            auto startTime = std::chrono::steady_clock::now();
+            deduplicate(corners, result);
+            std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+            fastestMilliseconds = std::min(fastestMilliseconds, duration.count());
+        }
+        return fastestMilliseconds;
+    }
+
+    bool isObjFile(const std::filesystem::path& path) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        return extension == ".obj";
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options{};
+    if (!parseOptions(argc, argv, &options)) {
+        std::cerr << "Usage: MeshVertexDeduplicationBenchmark [--runs <count>] <directory>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> objPaths;
+    for (const std::filesystem::path& directory : options.directories) {
+        if (!std::filesystem::is_directory(directory)) {
+            std::cerr << "Could not find directory [" << directory.string() << "]" << std::endl;
+            return 1;
+        }
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+            if (entry.is_regular_file() && isObjFile(entry.path())) {
+                objPaths.push_back(entry.path());
+            }
+        }
+    }
+    std::sort(objPaths.begin(), objPaths.end());
+
+    std::cout << "Fastest of [" << options.runs << "] runs per model" << std::endl;
+    bool succeeded = true;
+    for (const std::filesystem::path& objPath : objPaths) {
+        std::vector<MeshVertex> corners;
+        if (!loadCorners(objPath, &corners)) {
+            succeeded = false;
+            continue;
+        }
+
+        DeduplicationResult unorderedMapResult{};
+        DeduplicationResult deduplicatorResult{};
+        double unorderedMapMilliseconds = measure(options.runs, corners, &unorderedMapResult, deduplicateWithUnorderedMap);
+        double deduplicatorMilliseconds = measure(options.runs, corners, &deduplicatorResult, deduplicateWithDeduplicator);
+
+        // Both insert unique vertices in the order they are first seen, so the results must be identical
+        bool identical = unorderedMapResult.vertices == deduplicatorResult.vertices && unorderedMapResult.indices == deduplicatorResult.indices;
+        if (!identical) {
+            succeeded = false;
+        }
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << objPath.filename().string()
+                  << " [corners: " << corners.size() << ", unique vertices: " << deduplicatorResult.vertices.size() << "]"
+                  << " unordered_map: " << unorderedMapMilliseconds << " ms"
+                  << ", MeshVertexDeduplicator: " << deduplicatorMilliseconds << " ms"
+                  << " (" << unorderedMapMilliseconds / std::max(deduplicatorMilliseconds, 0.001) << "x)"
+                  << (identical ? "" : " RESULTS DIFFER")
+                  << std::endl;
+    }
+    return succeeded ? 0 : 1;
+}
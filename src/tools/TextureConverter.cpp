@@ -0,0 +1,274 @@
+#include "tools/BlockCompressor.h"
+#include "system/Ktx2File.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// Offline converter that writes block-compressed KTX2 variants next to the JPG and PNG images in the given
+// directories (recursively), which the app loads instead of the source images when the device supports them:
+//
+//   <name>.bc.ktx2     BC1 for opaque images and BC7 for images with alpha, unless another format is given with --bc
+//   <name>.etc2.ktx2   ETC2 RGB8 for opaque images and ETC2 RGBA8 for images with alpha
+//
+// Every variant stores a full mip chain, which is downsampled with a box filter in linear space before compressing
+// each level. Variants that are newer than their source image and store all levels are skipped unless --force is given.
+//
+// Usage: TextureConverter [--bc auto|bc1|bc3|bc7] [--force] <directory>...
+//
+
+using namespace Blink;
+
+namespace {
+    struct ConverterOptions {
+        std::string bcFormat = "auto";
+        bool force = false;
+        std::vector<std::filesystem::path> directories;
+    };
+
+    struct TextureVariant {
+        std::string name;
+        VkFormat opaqueFormat = VK_FORMAT_UNDEFINED;
+        VkFormat alphaFormat = VK_FORMAT_UNDEFINED;
+    };
+
+    struct MipLevel {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels; // RGBA8
+    };
+
+    std::mutex outputMutex;
+
+    bool isSourceImage(const std::filesystem::path& path) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+        return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+    }
+
+    uint32_t getMipLevelCount(uint32_t width, uint32_t height) {
+        uint32_t mipLevelCount = 1;
+        for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+            mipLevelCount++;
+        }
+        return mipLevelCount;
+    }
+
+    bool isUpToDate(const std::filesystem::path& sourcePath, const std::filesystem::path& variantPath) {
+        if (!std::filesystem::exists(variantPath) || std::filesystem::last_write_time(variantPath) < std::filesystem::last_write_time(sourcePath)) {
+            return false;
+        }
+        // Variants that were written without a full mip chain are converted again
+        int32_t width;
+        int32_t height;
+        int32_t channels;
+        if (!stbi_info(sourcePath.string().c_str(), &width, &height, &channels)) {
+            return false;
+        }
+        Ktx2Header header{};
+        std::ifstream file{variantPath, std::ios::binary};
+        file.read((char*) &header, sizeof(Ktx2Header));
+        return file && header.levelCount == getMipLevelCount(width, height);
+    }
+
+    bool hasAlpha(const uint8_t* pixels, uint32_t width, uint32_t height) {
+        for (size_t i = 0; i < (size_t) width * height; i++) {
+            if (pixels[i * 4 + 3] < 255) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    float toLinear(uint8_t value) {
+        float color = (float) value / 255.0f;
+        return color <= 0.04045f ? color / 12.92f : std::pow((color + 0.055f) / 1.055f, 2.4f);
+    }
+
+    uint8_t toSrgb(float value) {
+        float color = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        return (uint8_t) std::clamp(color * 255.0f + 0.5f, 0.0f, 255.0f);
+    }
+
+    // Averages 2x2 texels of the previous level, repeating the last row or column of odd sized levels
+    MipLevel downsample(const MipLevel& level) {
+        MipLevel mipLevel{};
+        mipLevel.width = std::max(level.width / 2, 1u);
+        mipLevel.height = std::max(level.height / 2, 1u);
+        mipLevel.pixels.resize((size_t) mipLevel.width * mipLevel.height * 4);
+        for (uint32_t y = 0; y < mipLevel.height; y++) {
+            for (uint32_t x = 0; x < mipLevel.width; x++) {
+                const uint32_t sourceX[2] = {std::min(x * 2, level.width - 1), std::min(x * 2 + 1, level.width - 1)};
+                const uint32_t sourceY[2] = {std::min(y * 2, level.height - 1), std::min(y * 2 + 1, level.height - 1)};
+                float color[4] = {};
+                for (uint32_t sy : sourceY) {
+                    for (uint32_t sx : sourceX) {
+                        const uint8_t* texel = &level.pixels[((size_t) sy * level.width + sx) * 4];
+                        for (uint32_t channel = 0; channel < 3; channel++) {
+                            color[channel] += toLinear(texel[channel]);
+                        }
+                        color[3] += (float) texel[3] / 255.0f;
+                    }
+                }
+                uint8_t* texel = &mipLevel.pixels[((size_t) y * mipLevel.width + x) * 4];
+                for (uint32_t channel = 0; channel < 3; channel++) {
+                    texel[channel] = toSrgb(color[channel] / 4.0f);
+                }
+                texel[3] = (uint8_t) std::clamp(color[3] / 4.0f * 255.0f + 0.5f, 0.0f, 255.0f);
+            }
+        }
+        return mipLevel;
+    }
+
+    bool convert(const std::filesystem::path& sourcePath, const std::vector<TextureVariant>& variants, bool force) {
+        std::vector<TextureVariant> pendingVariants;
+        for (const TextureVariant& variant : variants) {
+            std::filesystem::path variantPath = Ktx2File::getVariantPath(sourcePath.string(), variant.name);
+            if (force || !isUpToDate(sourcePath, variantPath)) {
+                pendingVariants.push_back(variant);
+            }
+        }
+        if (pendingVariants.empty()) {
+            return true;
+        }
+
+        int32_t width;
+        int32_t height;
+        int32_t channels;
+        uint8_t* pixels = stbi_load(sourcePath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (pixels == nullptr) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cerr << "Could not read image file [" << sourcePath.string() << "]" << std::endl;
+            return false;
+        }
+        bool alpha = hasAlpha(pixels, width, height);
+
+        std::vector<MipLevel> mipLevels(1);
+        mipLevels[0].width = width;
+        mipLevels[0].height = height;
+        mipLevels[0].pixels.assign(pixels, pixels + (size_t) width * height * 4);
+        stbi_image_free(pixels);
+        while (mipLevels.size() < getMipLevelCount(width, height)) {
+            mipLevels.push_back(downsample(mipLevels.back()));
+        }
+
+        for (const TextureVariant& variant : pendingVariants) {
+            auto startTime = std::chrono::steady_clock::now();
+            VkFormat format = alpha ? variant.alphaFormat : variant.opaqueFormat;
+            std::vector<std::vector<char>> levels;
+            uint64_t compressedSize = 0;
+            for (const MipLevel& mipLevel : mipLevels) {
+                levels.push_back(BlockCompressor::compress(mipLevel.pixels.data(), mipLevel.width, mipLevel.height, format));
+                compressedSize += levels.back().size();
+            }
+            std::vector<char> bytes = Ktx2File::write(format, width, height, levels);
+
+            std::string variantPath = Ktx2File::getVariantPath(sourcePath.string(), variant.name);
+            std::ofstream file{variantPath, std::ios::binary | std::ios::trunc};
+            file.write(bytes.data(), (std::streamsize) bytes.size());
+            if (!file) {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cerr << "Could not write texture file [" << variantPath << "]" << std::endl;
+                return false;
+            }
+
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cout << "Compressed [" << sourcePath.string() << "] to [" << variantPath << "] ["
+                      << width << "x" << height << ", " << mipLevels.size() << " levels, " << (alpha ? "alpha" : "opaque") << ", "
+                      << (size_t) width * height * 4 / 1024 << " KB -> " << compressedSize / 1024 << " KB, "
+                      << (uint32_t) milliseconds << " ms]" << std::endl;
+        }
+        return true;
+    }
+
+    bool parseOptions(int argc, char** argv, ConverterOptions* options) {
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+            if (argument == "--bc" && i + 1 < argc) {
+                options->bcFormat = argv[++i];
+            } else if (argument == "--force") {
+                options->force = true;
+            } else {
+                options->directories.emplace_back(argument);
+            }
+        }
+        const std::vector<std::string> bcFormats = {"auto", "bc1", "bc3", "bc7"};
+        if (std::find(bcFormats.begin(), bcFormats.end(), options->bcFormat) == bcFormats.end()) {
+            std::cerr << "Unknown BC format [" << options->bcFormat << "]" << std::endl;
+            return false;
+        }
+        return !options->directories.empty();
+    }
+
+    TextureVariant getBcVariant(const std::string& bcFormat) {
+        TextureVariant variant{Ktx2File::BC_VARIANT, VK_FORMAT_BC1_RGB_SRGB_BLOCK, VK_FORMAT_BC7_SRGB_BLOCK};
+        if (bcFormat == "bc1") {
+            variant.alphaFormat = VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+        } else if (bcFormat == "bc3") {
+            variant.opaqueFormat = VK_FORMAT_BC3_SRGB_BLOCK;
+            variant.alphaFormat = VK_FORMAT_BC3_SRGB_BLOCK;
+        } else if (bcFormat == "bc7") {
+            variant.opaqueFormat = VK_FORMAT_BC7_SRGB_BLOCK;
+        }
+        return variant;
+    }
+}
+
+int main(int argc, char** argv) {
+    ConverterOptions options{};
+    if (!parseOptions(argc, argv, &options)) {
+        std::cerr << "Usage: TextureConverter [--bc auto|bc1|bc3|bc7] [--force] <directory>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<TextureVariant> variants = {
+        getBcVariant(options.bcFormat),
+        {Ktx2File::ETC2_VARIANT, VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK},
+    };
+
+    std::vector<std::filesystem::path> sourcePaths;
+    for (const std::filesystem::path& directory : options.directories) {
+        if (!std::filesystem::is_directory(directory)) {
+            std::cerr << "Could not find directory [" << directory.string() << "]" << std::endl;
+            return 1;
+        }
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+            if (entry.is_regular_file() && isSourceImage(entry.path())) {
+                sourcePaths.push_back(entry.path());
+            }
+        }
+    }
+
+    // Images are converted in parallel, one image per thread at a time
+    std::atomic<uint32_t> nextSourceIndex = 0;
+    std::atomic<bool> succeeded = true;
+    std::vector<std::thread> threads;
+    uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        threads.emplace_back([&]() {
+            for (uint32_t sourceIndex = nextSourceIndex++; sourceIndex < sourcePaths.size(); sourceIndex = nextSourceIndex++) {
+                if (!convert(sourcePaths[sourceIndex], variants, options.force)) {
+                    succeeded = false;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return succeeded ? 0 : 1;
+}
@@ -10,6 +10,16 @@ namespace Blink {
     // error due to rounding in floating-point arithmetic.
     constexpr float EPSILON = 1e-7;
 
+    uint64_t hashFnv1a(const void* data, uint64_t size, uint64_t hash) {
+        constexpr uint64_t prime = 0x100000001B3;
+        auto bytes = (const uint8_t*) data;
+        for (uint64_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= prime;
+        }
+        return hash;
+    }
+
     // Use epsilon to check if a floating-point result is close enough to zero to be considered
     // zero. This is necessary because floating-point calculations can introduce very small errors.
     float clampToZero(float x) {
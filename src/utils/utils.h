@@ -10,6 +10,11 @@ namespace Blink {
         return count * sizeof(T);
     }
 
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325;
+
+    // 64-bit FNV-1a hash, pass the previous hash to continue hashing over multiple buffers
+    uint64_t hashFnv1a(const void* data, uint64_t size, uint64_t hash = FNV_OFFSET_BASIS);
+
     float clampToZero(float x);
 
     void clampToZero(glm::vec3* vector);